@@ -43,6 +43,11 @@ namespace lsp
             static constexpr float  SC_LOOKAHEAD_STEP   = 0.01f;
             static constexpr float  SC_LOOKAHEAD_DFL    = 0.0f;
 
+            static constexpr float  CEILING_MIN         = -24.0f;
+            static constexpr float  CEILING_MAX         = 0.0f;
+            static constexpr float  CEILING_STEP        = 0.01f;
+            static constexpr float  CEILING_DFL         = -1.0f;
+
             static constexpr float  LONG_PERIOD_MIN     = 100.0f;
             static constexpr float  LONG_PERIOD_MAX     = 2000.0f;
             static constexpr float  LONG_PERIOD_STEP    = 0.0005f;
@@ -98,8 +103,36 @@ namespace lsp
             static constexpr float  MESH_TIME           = 4.0f;
             static constexpr size_t MESH_POINTS         = 640.0f;
 
+            static constexpr size_t HISTORY_LEVELS      = 6;        // Number of additional history zoom levels
+
+            static constexpr float  INTEGRATED_MIN      = -70.0f;
+            static constexpr float  INTEGRATED_MAX      = 10.0f;
+            static constexpr float  INTEGRATED_STEP     = 0.1f;
+            static constexpr float  INTEGRATED_DFL      = -70.0f;
+
+            static constexpr float  LRA_MIN             = 0.0f;
+            static constexpr float  LRA_MAX             = 80.0f;
+            static constexpr float  LRA_STEP            = 0.1f;
+            static constexpr float  LRA_DFL             = 0.0f;
+
             static constexpr float  DELAY_OUT_MAX_TIME  = 10000.0f;
 
+            static constexpr float  IDISPLAY_RATE_MIN   = 1.0f;
+            static constexpr float  IDISPLAY_RATE_MAX   = 60.0f;
+            static constexpr float  IDISPLAY_RATE_STEP  = 0.1f;
+            static constexpr float  IDISPLAY_RATE_DFL   = 20.0f;
+
+            static constexpr float  DSP_LOAD_MIN        = 0.0f;
+            static constexpr float  DSP_LOAD_MAX        = 1000.0f;
+            static constexpr float  DSP_LOAD_STEP       = 0.1f;
+            static constexpr float  DSP_LOAD_DFL        = 0.0f;
+            static constexpr size_t DSP_LOAD_BUCKETS    = 16;
+
+            static constexpr float  PROFILE_MIN         = 0.0f;
+            static constexpr float  PROFILE_MAX         = 100000.0f;
+            static constexpr float  PROFILE_STEP        = 0.1f;
+            static constexpr float  PROFILE_DFL         = 0.0f;
+
             enum weighting_t
             {
                 WEIGHT_NONE,
@@ -150,6 +183,10 @@ namespace lsp
         extern const plugin_t autogain_stereo;
         extern const plugin_t sc_autogain_mono;
         extern const plugin_t sc_autogain_stereo;
+        extern const plugin_t autogain_env_mono;
+        extern const plugin_t autogain_env_stereo;
+        extern const plugin_t autogain_follower_mono;
+        extern const plugin_t autogain_follower_stereo;
 
     } /* namespace meta */
 } /* namespace lsp */
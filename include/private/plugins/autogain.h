@@ -22,6 +22,7 @@
 #ifndef PRIVATE_PLUGINS_AUTOGAIN_H_
 #define PRIVATE_PLUGINS_AUTOGAIN_H_
 
+#include <lsp-plug.in/common/atomic.h>
 #include <lsp-plug.in/dsp-units/ctl/Bypass.h>
 #include <lsp-plug.in/dsp-units/dynamics/AutoGain.h>
 #include <lsp-plug.in/dsp-units/meters/LoudnessMeter.h>
@@ -31,6 +32,19 @@
 #include <lsp-plug.in/plug-fw/core/IDBuffer.h>
 #include <lsp-plug.in/plug-fw/plug.h>
 #include <private/meta/autogain.h>
+#include <private/util/CanvasCache.h>
+#include <private/util/Capture.h>
+#include <private/util/GraphDecimator.h>
+#include <private/util/HistoryLog.h>
+#include <private/util/LODHistory.h>
+#include <private/util/LoadMeter.h>
+#include <private/util/LoudnessHistogram.h>
+#include <private/util/MeterDecimator.h>
+#include <private/util/SignalGenerator.h>
+#include <private/util/StageProfiler.h>
+#include <private/util/Telemetry.h>
+#include <private/util/Trace.h>
+#include <private/util/TruePeakCeiling.h>
 
 namespace lsp
 {
@@ -59,6 +73,83 @@ namespace lsp
                     GCT_TOTAL
                 };
 
+                enum profile_stage_t
+                {
+                    PS_OTHER,
+                    PS_MEASURE,
+                    PS_GAIN,
+                    PS_APPLY,
+                    PS_BUFFERS,
+                    PS_MESH,
+
+                    PS_TOTAL
+                };
+
+                enum decim_meter_t
+                {
+                    DM_L_IN,                                    // Long-period input loudness
+                    DM_S_IN,                                    // Short-period input loudness
+                    DM_L_SC,                                    // Long-period sidechain loudness
+                    DM_S_SC,                                    // Short-period sidechain loudness
+                    DM_L_OUT,                                   // Long-period output loudness
+                    DM_S_OUT,                                   // Short-period output loudness
+                    DM_M_OUT,                                   // Momentary output loudness
+                    DM_T_OUT,                                   // Short-term output loudness
+
+                    DM_TOTAL
+                };
+
+                enum graph_mesh_t
+                {
+                    GM_L_IN,
+                    GM_S_IN,
+                    GM_L_OUT,
+                    GM_S_OUT,
+                    GM_L_SC,
+                    GM_S_SC,
+                    GM_GAIN,
+
+                    GM_TOTAL
+                };
+
+                static_assert(HISTORY_LOG_VALUES == GM_TOTAL, "Invalid number of history log values");
+
+                enum mesh_shape_t
+                {
+                    MS_LINE,                                    // Plain line
+                    MS_FILL,                                    // Line closed to zero at both ends
+                    MS_GAIN                                     // Line closed to unity gain at both ends
+                };
+
+                enum idisplay_graph_flags_t
+                {
+                    IDG_INDEX       = 0x03,                     // Mask of the snapshot index
+                    IDG_FRESH       = 0x04,                     // Shared snapshot has not been taken by the inline display
+
+                    IDG_BUFFERS     = 3                         // Number of snapshots
+                };
+
+                typedef struct idisplay_graph_t
+                {
+                    float                  *vData;              // Values of the gain graph
+                    uatomic_t               nPoints;            // Number of graph points produced at the time of the snapshot
+                    size_t                  nResets;            // Number of graph resets at the time of the snapshot
+                } idisplay_graph_t;
+
+                typedef struct mesh_sync_t
+                {
+                    uatomic_t               nPoints;            // Number of graph points at the last transfer
+                    bool                    bXAxis;             // X axis has been written to the mesh
+                } mesh_sync_t;
+
+                typedef void (autogain::*kernel_t)(size_t samples);
+
+                typedef struct kernels_t
+                {
+                    kernel_t                pMeasure;           // Input loudness measurement
+                    kernel_t                pGain;              // Gain correction computing
+                } kernels_t;
+
                 typedef struct gcontrol_t
                 {
                     plug::IPort            *pValue;             // Numerator of the gain speed
@@ -70,10 +161,12 @@ namespace lsp
                     // DSP processing modules
                     dspu::Bypass            sBypass;            // Bypass
                     dspu::Delay             sDelay;             // Delay
+                    dspu::Delay             sDryDelay;          // Dry signal delay
 
                     float                  *vIn;                // Input signal
                     float                  *vScIn;              // Sidechain input
                     float                  *vShmIn;             // Shared memory input
+                    float                  *vDry;               // Delayed dry signal
                     float                  *vOut;               // Output signal
                     float                  *vBuffer;            // Temporary buffer for audio processing
 
@@ -91,17 +184,98 @@ namespace lsp
                 dspu::MeterGraph        sLScGraph;          // Sidechain metering graph for long output gain
                 dspu::MeterGraph        sSScGraph;          // Sidechain metering graph for short output gain
                 dspu::MeterGraph        sGainGraph;         // Gain correction graph
+                LODHistory              vHistoryData[GM_TOTAL * 2]; // Storage for the history of graphs
+                LODHistory             *vHistory;           // Multi-resolution history of graphs
+                LODHistory             *vHReplay;           // History restored from the history log
+                HistoryLogRing          sHLogOut;           // History log records to write
+                HistoryLogRing          sHLogIn;            // History log records to replay
+                HistoryLog              sHLog;              // History log writer
                 dspu::LoudnessMeter     sLInMeter;          // Input loudness metering tool for long period
                 dspu::LoudnessMeter     sSInMeter;          // Input loudness metering tool for short period
                 dspu::LoudnessMeter     sLOutMeter;         // Output loudness metering tool for long period
                 dspu::LoudnessMeter     sSOutMeter;         // Output loudness metering tool for short period
                 dspu::LoudnessMeter     sLScMeter;          // Sidechain loudness metering for the long period
                 dspu::LoudnessMeter     sSScMeter;          // Sidechain loudness metering for the short period
+                dspu::LoudnessMeter     sMOutMeter;         // Output momentary loudness metering for integrated loudness
+                dspu::LoudnessMeter     sTOutMeter;         // Output short-term loudness metering for loudness range
+                dspu::LoudnessMeter     vDecimMeters[DM_TOTAL]; // Loudness meters of the decimated signal
+                LoudnessHistogram       sIntHist;           // Histogram of momentary output loudness
+                LoudnessHistogram       sLraHist;           // Histogram of short-term output loudness
+                MeterDecimator          sInDecim;           // Decimator of the input signal for loudness metering
+                MeterDecimator          sScDecim;           // Decimator of the sidechain signal for loudness metering
+                MeterDecimator          sOutDecim;          // Decimator of the output signal for loudness metering
                 dspu::AutoGain          sAutoGain;          // Auto-gain
+                TruePeakCeiling         sCeiling;           // True peak ceiling
+                TelemetryRing           sTelemetry;         // Telemetry ring
+                TelemetryWriter         sTelemetryWriter;   // Telemetry writer
+                LoadMeter               sLoadMeter;         // DSP load meter
+                TraceRing               sTrace;             // Trace event ring
+                TraceWriter             sTraceWriter;       // Trace event writer
+                CaptureRing             sCapture;           // Session capture ring
+                CaptureWriter           sCaptureWriter;     // Session capture writer
+                CanvasCache             sIDBackground;      // Cached background of the inline display
+                GraphDecimator          sIDGain;            // Decimated gain curve of the inline display
+            #ifdef LSP_AUTOGAIN_PROFILE
+                StageProfiler           sProfiler;          // Profiler of processing stages
+                plug::IPort            *vProfile[PS_TOTAL]; // Profiling output ports
+            #endif /* LSP_AUTOGAIN_PROFILE */
+            #ifdef LSP_TESTING
+                SignalGenerator         sGenerator;         // Synthetic test signal generator
+            #endif /* LSP_TESTING */
 
                 size_t                  nChannels;          // Number of channels
                 size_t                  enScMode;           // Sidechain mode
+                kernel_t                pMeasureLoudness;   // Input loudness measurement kernel for the sidechain mode
+                kernel_t                pComputeGain;       // Gain correction computing kernel for the sidechain mode
                 bool                    bSidechain;         // Sidechain is available
+                bool                    bGainEnv;           // Gain envelope output is available
+                bool                    bCeiling;           // True peak ceiling is enabled
+                bool                    bDecimate;          // Decimated loudness metering is enabled
+                bool                    bTelemetry;         // Telemetry logging is enabled
+                bool                    bTlmAccepted;       // Telemetry file request is accepted and being applied by the writer
+                bool                    bTrace;             // Tracing is enabled
+                bool                    bTraceAccepted;     // Trace file request is accepted and being applied by the writer
+                bool                    bCaptureAccepted;   // Capture file request is accepted and being applied by the writer
+                bool                    bCapture;           // Session capture is enabled
+                bool                    bCaptureSync;       // Capture all parameter values at the next update
+                size_t                  nCapturePorts;      // Number of ports in the plugin metadata
+                plug::IPort           **vCapturePorts;      // Captured input control ports, indexed as in metadata
+                float                  *vCaptureValues;     // Last captured values of ports
+                uint64_t                nTlmPosition;       // Telemetry stream position
+                uint64_t                nTraceProcess;      // Start time of the process() call for tracing
+                uint64_t                nTraceStage;        // Start time of the current stage for tracing
+                size_t                  nIDisplayPeriod;    // Period of inline display redraw requests in samples
+                size_t                  nIDisplayCounter;   // Number of samples processed since last redraw request
+                bool                    bIDisplayDraw;      // Force inline display redraw request
+                size_t                  nOutputPeriod;      // Period of meters, meshes and telemetry output in samples
+                size_t                  nOutputCounter;     // Number of samples processed since the last output
+                size_t                  nGraphPeriod;       // Number of samples per graph point
+                size_t                  nGraphCounter;      // Number of samples accumulated for the next graph point
+                uatomic_t               nGraphPoints;       // Number of graph points produced
+                size_t                  nGraphResets;       // Number of graph resets caused by the sample rate change
+                idisplay_graph_t        vIDGraph[IDG_BUFFERS]; // Triple buffer of gain graph snapshots for the inline display
+                uatomic_t               nIDShared;          // Index of the shared snapshot and the IDG_FRESH flag
+                size_t                  nIDBack;            // Index of the snapshot written by the processing thread
+                size_t                  nIDFront;           // Index of the snapshot read by the inline display
+                uatomic_t               nIDGraphPoints;     // Number of graph points consumed by the inline display
+                size_t                  nIDGraphResets;     // Number of graph resets seen by the inline display
+                mesh_sync_t             vMeshSync[GM_TOTAL];// State of graph mesh transfer
+                size_t                  nHistoryZoom;       // History zoom level, 0 means the most recent history
+                bool                    bHLog;              // History logging is enabled
+                bool                    bHLogAccepted;      // History log file request is accepted and being applied by the writer
+                bool                    bHLogReplay;        // History log is being replayed into the history
+                uatomic_t               nHLogPoints;        // Number of graph points at the last history log record
+                uatomic_t               nHLogLive;          // Number of graph points at the start of the replay
+                uint64_t                nHLogTime;          // Time of the last replayed history log record
+                float                   vHLogValues[HISTORY_LOG_VALUES]; // Accumulated values of the history log record
+                size_t                  nIntPeriod;         // Period of integrated loudness blocks in samples
+                size_t                  nIntCounter;        // Number of samples processed since the last block
+                bool                    bIntUpdate;         // Integrated loudness and loudness range need update
+                size_t                  nDecimStages;       // Number of decimation stages available at the sample rate
+                size_t                  nDecimFactor;       // Decimation factor of the loudness metering
+                size_t                  nDecimPhase;        // Position of the block start within the decimation period
+                size_t                  nDecimCount;        // Number of decimated samples in the current block
+                float                   vDecimHold[DM_TOTAL]; // Last decimated values of the meters
                 channel_t              *vChannels;          // Delay channels
 
                 float                   fLInGain;           // Input gain meter for long period
@@ -111,6 +285,8 @@ namespace lsp
                 float                   fLScGain;           // Output gain meter for long sidechain
                 float                   fSScGain;           // Output gain meter for short sidechain
                 float                   fGain;              // Gain correction meter
+                float                   fIntLoudness;       // Integrated output loudness, LUFS
+                float                   fLoudnessRange;     // Output loudness range, LU
                 float                   fOldLevel;          // Old level value
                 float                   fLevel;             // Current level value
                 float                   fOldPreamp;         // Old sidechain preamp
@@ -119,10 +295,13 @@ namespace lsp
                 float                  *vLBuffer;           // Buffer for long input gain
                 float                  *vSBuffer;           // Buffer for short input gain
                 float                  *vGainBuffer;        // Buffer for gain correction
+                float                  *vGainEnv;           // Gain envelope output
                 float                  *vEmptyBuffer;       // Empty buffer for audio fallback
+                float                  *vDecimBuffer;       // Buffer for decimated loudness
+                float                  *vEnvBuffer;         // Gain envelope before applying the true peak ceiling
                 float                  *vTimePoints;        // Time points
-                float                  *vIDisplay;          // Inline display buffer
 
+                plug::IPort            *pGainEnv;           // Gain envelope output port
                 plug::IPort            *pBypass;            // Bypass
                 plug::IPort            *pScMode;            // Sidechain mode
                 plug::IPort            *pScPreamp;          // Sidechain preamp
@@ -151,26 +330,83 @@ namespace lsp
                 plug::IPort            *pLScGraph;          // Sidechain loudness graph for long period
                 plug::IPort            *pSScGraph;          // Sidechain loudness graph for short period
                 plug::IPort            *pGainGraph;         // Gain correction graph
+                plug::IPort            *pCeilingOn;         // True peak ceiling switch
+                plug::IPort            *pCeiling;           // True peak ceiling level
+                plug::IPort            *pDecimate;          // Decimated loudness metering switch
+                plug::IPort            *pTlmOn;             // Telemetry logging switch
+                plug::IPort            *pTlmFile;           // Telemetry log file
+                plug::IPort            *pTraceFile;         // Trace file
+                plug::IPort            *pCaptureFile;       // Session capture file
+                plug::IPort            *pIDisplayRate;      // Inline display refresh rate
+                plug::IPort            *pHistoryZoom;       // History graph zoom
+                plug::IPort            *pHLogOn;            // History logging switch
+                plug::IPort            *pHLogFile;          // History log file
+                plug::IPort            *pIntLoudness;       // Integrated output loudness
+                plug::IPort            *pLoudnessRange;     // Output loudness range
+                plug::IPort            *pIntReset;          // Integrated loudness reset
+                plug::IPort            *pDspLoad;           // DSP load meter
+                plug::IPort            *pDspPeak;           // DSP load peak meter
+                plug::IPort            *pDspReset;          // DSP load statistics reset
+                plug::IPort            *pDspHist;           // DSP load histogram
 
                 core::IDBuffer         *pIDisplay;          // Inline display buffer
 
                 uint8_t                *pData;              // Allocated data
+                uint8_t                *pCaptureData;       // Allocated data for the session capture
 
             protected:
                 static dspu::bs::weighting_t    decode_weighting(size_t weighting);
                 meta::autogain::scmode_t        decode_sidechain_mode(size_t mode);
 
             protected:
-                const float            *select_buffer(const channel_t *c) const;
+                template <size_t SCMODE>
+                inline const float     *select_buffer(const channel_t *c) const;
                 void                    do_destroy();
+                void                    init_capture(plug::IPort **ports);
+                void                    capture_record(uint32_t type, uint32_t index, uint32_t count, const float *data, size_t n);
+                void                    capture_audio(uint32_t type, uint32_t index, const float *data, size_t samples);
+                void                    capture_block(size_t samples);
+                void                    capture_params();
+                inline void             begin_stages();
+                inline void             end_stage(profile_stage_t stage, size_t samples);
+                void                    trace_event(size_t stage, uint64_t start, uint64_t end, size_t samples);
                 void                    bind_audio_ports();
                 void                    clean_meters();
+                void                    update_decimation();
+                inline void             bind_meter(dspu::LoudnessMeter *meter, decim_meter_t type, size_t channel, const float *data);
+                void                    measure_loudness(dspu::LoudnessMeter *meter, decim_meter_t type, float *dst, size_t samples);
+                template <size_t CHANNELS, size_t SCMODE>
                 void                    measure_input_loudness(size_t samples);
-                void                    update_audio_buffers(size_t samples);
+                template <size_t SCMODE>
                 void                    compute_gain_correction(size_t samples);
+                void                    select_kernels();
+                void                    update_audio_buffers(size_t samples);
                 void                    apply_gain_correction(size_t samples);
+                void                    measure_integrated_loudness(size_t samples);
                 void                    output_mesh_data();
+                void                    output_idisplay_graph();
+                void                    read_graph(graph_mesh_t type, dspu::MeterGraph *graph, float *dst);
+                void                    output_graph_mesh(graph_mesh_t type, plug::IPort *port, dspu::MeterGraph *graph, mesh_shape_t shape);
                 void                    output_meters();
+                void                    output_integrated_loudness();
+                void                    output_telemetry(size_t samples);
+                void                    output_dsp_load();
+                void                    output_trace(size_t samples);
+                void                    output_capture();
+                inline void             update_history(graph_mesh_t type, const float *src, size_t samples);
+                void                    output_history_log();
+                void                    replay_history_log();
+                void                    complete_history_replay(uint64_t time);
+                void                    append_history_gap(LODHistory *dst, uint64_t from, uint64_t to);
+                void                    query_display_draw(size_t samples);
+                void                    draw_background(plug::ICanvas *cv, bool bypassing);
+            #ifdef LSP_AUTOGAIN_PROFILE
+                void                    output_profile();
+            #endif /* LSP_AUTOGAIN_PROFILE */
+            #ifdef LSP_TESTING
+                void                    init_generator();
+                void                    generate_signal(size_t samples);
+            #endif /* LSP_TESTING */
                 inline float            calc_gain_speed(gcontrol_type_t type);
 
             public:
@@ -191,6 +427,18 @@ namespace lsp
                 virtual void            process(size_t samples) override;
                 virtual bool            inline_display(plug::ICanvas *cv, size_t width, size_t height) override;
                 virtual void            dump(dspu::IStateDumper *v) const override;
+
+            #ifdef LSP_TESTING
+            public:
+                /**
+                 * Replace the input and sidechain signals by the synthetic signal, available in test
+                 * builds only. Should be called from the non-RT thread after init() while the plugin
+                 * is not processing.
+                 * @param scenario scenario of the signal, SG_NONE to disable the generator
+                 * @return status of operation
+                 */
+                status_t                set_generator(SignalGenerator::scenario_t scenario);
+            #endif /* LSP_TESTING */
         };
 
     } /* namespace plugins */
@@ -0,0 +1,91 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-plugins-autogain
+ * Created on: 18 окт 2026 г.
+ *
+ * lsp-plugins-autogain is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-plugins-autogain is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-plugins-autogain. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef PRIVATE_PLUGINS_AUTOGAIN_FOLLOWER_H_
+#define PRIVATE_PLUGINS_AUTOGAIN_FOLLOWER_H_
+
+#include <lsp-plug.in/dsp-units/ctl/Bypass.h>
+#include <lsp-plug.in/plug-fw/plug.h>
+#include <private/meta/autogain.h>
+
+namespace lsp
+{
+    namespace plugins
+    {
+        /**
+         * Gain follower: applies the gain envelope computed by another autogain
+         * instance to the input signal without performing any loudness metering
+         */
+        class autogain_follower: public plug::Module
+        {
+            protected:
+                typedef struct channel_t
+                {
+                    dspu::Bypass            sBypass;            // Bypass
+
+                    float                  *vIn;                // Input signal
+                    float                  *vOut;               // Output signal
+                    float                  *vBuffer;            // Temporary buffer for audio processing
+                    float                  *vDry;               // Copy of the input signal
+
+                    plug::IPort            *pIn;                // Input port
+                    plug::IPort            *pOut;               // Output port
+                } channel_t;
+
+            protected:
+                size_t                  nChannels;          // Number of channels
+                channel_t              *vChannels;          // Audio channels
+                float                  *vGainEnv;           // Gain envelope input
+                float                   fGain;              // Gain correction meter
+
+                plug::IPort            *pGainEnv;           // Gain envelope input port
+                plug::IPort            *pBypass;            // Bypass
+                plug::IPort            *pGain;              // Gain correction meter
+
+                uint8_t                *pData;              // Allocated data
+
+            protected:
+                void                    do_destroy();
+
+            public:
+                explicit autogain_follower(const meta::plugin_t *meta);
+                autogain_follower (const autogain_follower &) = delete;
+                autogain_follower (autogain_follower &&) = delete;
+                virtual ~autogain_follower() override;
+
+                autogain_follower & operator = (const autogain_follower &) = delete;
+                autogain_follower & operator = (autogain_follower &&) = delete;
+
+                virtual void            init(plug::IWrapper *wrapper, plug::IPort **ports) override;
+                virtual void            destroy() override;
+
+            public:
+                virtual void            update_sample_rate(long sr) override;
+                virtual void            update_settings() override;
+                virtual void            process(size_t samples) override;
+                virtual void            dump(dspu::IStateDumper *v) const override;
+        };
+
+    } /* namespace plugins */
+} /* namespace lsp */
+
+
+#endif /* PRIVATE_PLUGINS_AUTOGAIN_FOLLOWER_H_ */
@@ -0,0 +1,386 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-plugins-autogain
+ * Created on: 18 окт 2026 г.
+ *
+ * lsp-plugins-autogain is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-plugins-autogain is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-plugins-autogain. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef PRIVATE_TEST_TESTPORTS_H_
+#define PRIVATE_TEST_TESTPORTS_H_
+
+/*
+ * Ports used by the tests to drive the plugin without the host wrapper,
+ * compiled only into the test builds where LSP_TESTING is defined
+ */
+#ifdef LSP_TESTING
+
+#include <lsp-plug.in/common/types.h>
+#include <lsp-plug.in/plug-fw/core/AudioBuffer.h>
+#include <lsp-plug.in/plug-fw/meta/func.h>
+#include <lsp-plug.in/plug-fw/plug.h>
+
+#include <limits.h>
+#include <string.h>
+
+namespace lsp
+{
+    namespace plugins
+    {
+        /**
+         * Path of the file port: the test submits the request, the plugin accepts
+         * it on the real-time thread and commits it when the file has been opened
+         */
+        class TestPath: public plug::path_t
+        {
+            private:
+                enum state_t
+                {
+                    S_IDLE,
+                    S_PENDING,
+                    S_ACCEPTED
+                };
+
+            private:
+                state_t         enState;
+                char            sPath[PATH_MAX];
+
+            public:
+                explicit TestPath()
+                {
+                    enState     = S_IDLE;
+                    sPath[0]    = '\0';
+                }
+
+            public:
+                virtual void init() override                { enState = S_IDLE; sPath[0] = '\0';   }
+                virtual const char *path() const override   { return sPath;                         }
+                virtual size_t flags() const override       { return 0;                             }
+                virtual bool pending() override             { return enState == S_PENDING;          }
+                virtual void accept() override              { enState = S_ACCEPTED;                 }
+                virtual void commit() override              { enState = S_IDLE;                     }
+                virtual bool accepted() override            { return enState == S_ACCEPTED;         }
+
+                /**
+                 * Submit the request to open the file
+                 * @param path path to the file, empty string to close the file
+                 */
+                void submit(const char *path)
+                {
+                    strncpy(sPath, path, sizeof(sPath) - 1);
+                    sPath[sizeof(sPath) - 1]    = '\0';
+                    enState                     = S_PENDING;
+                }
+
+                inline bool     idle() const                { return enState == S_IDLE;             }
+        };
+
+        /**
+         * Port that returns the value and the buffer assigned by the test
+         */
+        class TestPort: public plug::IPort
+        {
+            private:
+                float           fValue;
+                void           *pBuffer;
+
+            public:
+                explicit TestPort(const meta::port_t *meta): plug::IPort(meta)
+                {
+                    fValue      = meta->start;
+                    pBuffer     = NULL;
+                }
+
+            public:
+                virtual float value() override              { return fValue;    }
+                virtual void set_value(float value) override { fValue = value;   }
+                virtual void *buffer() override             { return pBuffer;   }
+
+                inline void set_buffer(void *buf)           { pBuffer = buf;    }
+        };
+
+        /**
+         * Complete set of ports of the plugin. Audio inputs and outputs receive own buffers
+         * of the maximum block size, shared memory link inputs receive the audio buffer
+         * that is inactive until the test activates it. Ports are numbered in the order
+         * of the plugin metadata.
+         */
+        class TestPorts
+        {
+            public:
+                static constexpr size_t MAX_AUDIO       = 16;
+                static constexpr size_t MAX_PATHS       = 8;
+
+            private:
+                TestPort              **vTestPorts;         // Test ports
+                plug::IPort           **vPorts;             // Ports passed to the plugin
+                size_t                  nPorts;             // Number of ports
+                size_t                  nBlock;             // Maximum block size
+                size_t                  nIn;                // Number of audio inputs
+                size_t                  nOut;               // Number of audio outputs
+                size_t                  nLinks;             // Number of shared memory link inputs
+                TestPort               *vIn[MAX_AUDIO];     // Audio inputs
+                TestPort               *vOut[MAX_AUDIO];    // Audio outputs
+                TestPort               *vLink[MAX_AUDIO];   // Shared memory link inputs
+                float                  *vInBuf[MAX_AUDIO];  // Buffers of audio inputs
+                float                  *vOutBuf[MAX_AUDIO]; // Buffers of audio outputs
+                core::AudioBuffer      *vLinkBuf[MAX_AUDIO];// Buffers of link inputs
+                size_t                  nPaths;             // Number of file path ports
+                TestPath               *vPaths[MAX_PATHS];  // Paths of file path ports
+
+            public:
+                explicit TestPorts()
+                {
+                    vTestPorts      = NULL;
+                    vPorts          = NULL;
+                    nPorts          = 0;
+                    nBlock          = 0;
+                    nIn             = 0;
+                    nOut            = 0;
+                    nLinks          = 0;
+                    nPaths          = 0;
+                }
+
+                TestPorts(const TestPorts &) = delete;
+                TestPorts(TestPorts &&) = delete;
+
+                ~TestPorts()
+                {
+                    destroy();
+                }
+
+                TestPorts & operator = (const TestPorts &) = delete;
+                TestPorts & operator = (TestPorts &&) = delete;
+
+            public:
+                /**
+                 * Create ports for the plugin
+                 * @param meta plugin metadata
+                 * @param block maximum block size, zero if buffers are assigned by the caller
+                 * @return false if the plugin has more audio ports than supported
+                 */
+                bool init(const meta::plugin_t *meta, size_t block)
+                {
+                    destroy();
+
+                    for (const meta::port_t *p = meta->ports; p->id != NULL; ++p)
+                        ++nPorts;
+
+                    vTestPorts          = new TestPort *[nPorts]();
+                    vPorts              = new plug::IPort *[nPorts]();
+                    nBlock              = block;
+
+                    for (size_t i=0; i<nPorts; ++i)
+                    {
+                        const meta::port_t *p   = &meta->ports[i];
+                        TestPort *port          = new TestPort(p);
+                        vTestPorts[i]           = port;
+                        vPorts[i]               = port;
+
+                        if (meta::is_audio_in_port(p))
+                        {
+                            if (nIn >= MAX_AUDIO)
+                                return false;
+                            vInBuf[nIn]             = alloc_buffer(block);
+                            vIn[nIn]                = port;
+                            port->set_buffer(vInBuf[nIn++]);
+                        }
+                        else if (meta::is_audio_out_port(p))
+                        {
+                            if (nOut >= MAX_AUDIO)
+                                return false;
+                            vOutBuf[nOut]           = alloc_buffer(block);
+                            vOut[nOut]              = port;
+                            port->set_buffer(vOutBuf[nOut++]);
+                        }
+                        else if (p->role == meta::R_AUDIO_RETURN)
+                        {
+                            if (nLinks >= MAX_AUDIO)
+                                return false;
+                            core::AudioBuffer *buf  = new core::AudioBuffer();
+                            buf->set_size(lsp_max(block, size_t(1)));
+                            buf->set_active(false);
+                            vLinkBuf[nLinks]        = buf;
+                            vLink[nLinks]           = port;
+                            port->set_buffer(vLinkBuf[nLinks++]);
+                        }
+                        else if (p->role == meta::R_PATH)
+                        {
+                            if (nPaths >= MAX_PATHS)
+                                return false;
+                            vPaths[nPaths]          = new TestPath();
+                            port->set_buffer(vPaths[nPaths++]);
+                        }
+                    }
+
+                    return true;
+                }
+
+                void destroy()
+                {
+                    if (vTestPorts != NULL)
+                    {
+                        for (size_t i=0; i<nPorts; ++i)
+                            delete vTestPorts[i];
+                        delete [] vTestPorts;
+                        vTestPorts      = NULL;
+                    }
+                    if (vPorts != NULL)
+                    {
+                        delete [] vPorts;
+                        vPorts          = NULL;
+                    }
+
+                    for (size_t i=0; i<nIn; ++i)
+                        delete [] vInBuf[i];
+                    for (size_t i=0; i<nOut; ++i)
+                        delete [] vOutBuf[i];
+                    for (size_t i=0; i<nLinks; ++i)
+                        delete vLinkBuf[i];
+                    for (size_t i=0; i<nPaths; ++i)
+                        delete vPaths[i];
+
+                    nPorts          = 0;
+                    nBlock          = 0;
+                    nIn             = 0;
+                    nOut            = 0;
+                    nLinks          = 0;
+                    nPaths          = 0;
+                }
+
+            public:
+                inline plug::IPort    **ports()                 { return vPorts;            }
+                inline size_t           size() const            { return nPorts;            }
+                inline size_t           block() const           { return nBlock;            }
+                inline TestPort        *port(size_t index)      { return vTestPorts[index]; }
+
+                inline size_t           inputs() const          { return nIn;               }
+                inline size_t           outputs() const         { return nOut;              }
+                inline size_t           links() const           { return nLinks;            }
+
+                inline TestPort        *input(size_t index)     { return vIn[index];        }
+                inline TestPort        *output(size_t index)    { return vOut[index];       }
+                inline TestPort        *link(size_t index)      { return vLink[index];      }
+
+                inline float           *in(size_t index)        { return vInBuf[index];     }
+                inline float           *out(size_t index)       { return vOutBuf[index];    }
+                inline float           *link_data(size_t index) { return vLinkBuf[index]->buffer(); }
+
+                /**
+                 * Find port by identifier
+                 * @param id port identifier
+                 * @return port or NULL if not found
+                 */
+                TestPort *find(const char *id)
+                {
+                    for (size_t i=0; i<nPorts; ++i)
+                    {
+                        if (!strcmp(vTestPorts[i]->metadata()->id, id))
+                            return vTestPorts[i];
+                    }
+                    return NULL;
+                }
+
+                /**
+                 * Set the value of the port
+                 * @param id port identifier
+                 * @param value value to set
+                 * @return false if there is no such port
+                 */
+                bool set_value(const char *id, float value)
+                {
+                    TestPort *port  = find(id);
+                    if (port == NULL)
+                        return false;
+                    port->set_value(value);
+                    return true;
+                }
+
+                /**
+                 * Submit the request to open the file to the path port
+                 * @param id port identifier
+                 * @param path path to the file, empty string to close the file
+                 * @return false if there is no such path port
+                 */
+                bool set_path(const char *id, const char *path)
+                {
+                    TestPort *port  = find(id);
+                    if ((port == NULL) || (port->metadata()->role != meta::R_PATH))
+                        return false;
+                    static_cast<TestPath *>(port->buffer())->submit(path);
+                    return true;
+                }
+
+                /**
+                 * Check that the plugin has committed the request of the path port
+                 * @param id port identifier
+                 * @return true if there is no uncommitted request
+                 */
+                bool path_idle(const char *id)
+                {
+                    TestPort *port  = find(id);
+                    if ((port == NULL) || (port->metadata()->role != meta::R_PATH))
+                        return true;
+                    return static_cast<TestPath *>(port->buffer())->idle();
+                }
+
+                /**
+                 * Make the shared memory link appear or disappear in the same way as the host
+                 * does when the sending side connects or disconnects between blocks
+                 * @param active link state
+                 */
+                void set_link_active(bool active)
+                {
+                    for (size_t i=0; i<nLinks; ++i)
+                        vLinkBuf[i]->set_active(active);
+                }
+
+                /**
+                 * Check that the shared memory link is active
+                 * @return true if the link is active
+                 */
+                inline bool link_active() const
+                {
+                    return (nLinks > 0) && (vLinkBuf[0]->active());
+                }
+
+                /**
+                 * Change the size of buffers of the shared memory link when buffers are assigned by the caller
+                 * @param size new size of buffers in samples
+                 */
+                void set_link_size(size_t size)
+                {
+                    for (size_t i=0; i<nLinks; ++i)
+                        vLinkBuf[i]->set_size(size);
+                }
+
+            private:
+                static float *alloc_buffer(size_t size)
+                {
+                    if (size <= 0)
+                        return NULL;
+                    float *buf      = new float[size];
+                    memset(buf, 0, sizeof(float) * size);
+                    return buf;
+                }
+        };
+
+    } /* namespace plugins */
+} /* namespace lsp */
+
+#endif /* LSP_TESTING */
+
+#endif /* PRIVATE_TEST_TESTPORTS_H_ */
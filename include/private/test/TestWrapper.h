@@ -0,0 +1,143 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-plugins-autogain
+ * Created on: 18 окт 2026 г.
+ *
+ * lsp-plugins-autogain is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-plugins-autogain is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-plugins-autogain. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef PRIVATE_TEST_TESTWRAPPER_H_
+#define PRIVATE_TEST_TESTWRAPPER_H_
+
+/*
+ * Wrapper and executor used by the tests to drive the background tasks of the plugin
+ * without the host, compiled only into the test builds where LSP_TESTING is defined
+ */
+#ifdef LSP_TESTING
+
+#include <lsp-plug.in/common/types.h>
+#include <lsp-plug.in/ipc/IExecutor.h>
+#include <lsp-plug.in/ipc/ITask.h>
+#include <lsp-plug.in/plug-fw/plug.h>
+
+namespace lsp
+{
+    namespace plugins
+    {
+        /**
+         * Executor that queues the submitted tasks and runs them when the test asks,
+         * so the test decides when the background work happens. Submitting the task
+         * does not allocate memory and does not lock, the same as the executors of hosts.
+         */
+        class TestExecutor: public ipc::IExecutor
+        {
+            public:
+                static constexpr size_t MAX_TASKS       = 16;
+
+            private:
+                ipc::ITask             *vQueue[MAX_TASKS];  // Submitted tasks
+                ipc::ITask             *vSeen[MAX_TASKS];   // Distinct tasks submitted since the start
+                size_t                  nQueued;            // Number of submitted tasks
+                size_t                  nSeen;              // Number of distinct submitted tasks
+                size_t                  nSubmits;           // Overall number of submits
+
+            public:
+                explicit TestExecutor()
+                {
+                    nQueued         = 0;
+                    nSeen           = 0;
+                    nSubmits        = 0;
+                }
+
+                TestExecutor(const TestExecutor &) = delete;
+                TestExecutor(TestExecutor &&) = delete;
+
+                TestExecutor & operator = (const TestExecutor &) = delete;
+                TestExecutor & operator = (TestExecutor &&) = delete;
+
+            public:
+                virtual bool submit(ipc::ITask *task) override
+                {
+                    if ((!task->idle()) || (nQueued >= MAX_TASKS))
+                        return false;
+
+                    change_task_state(task, ipc::ITask::TS_SUBMITTED);
+                    vQueue[nQueued++]   = task;
+                    ++nSubmits;
+
+                    for (size_t i=0; i<nSeen; ++i)
+                        if (vSeen[i] == task)
+                            return true;
+                    if (nSeen < MAX_TASKS)
+                        vSeen[nSeen++]      = task;
+                    return true;
+                }
+
+                virtual void shutdown() override
+                {
+                    run();
+                }
+
+                /**
+                 * Run all submitted tasks in the order of submission
+                 * @return number of executed tasks
+                 */
+                size_t run()
+                {
+                    const size_t count  = nQueued;
+                    for (size_t i=0; i<count; ++i)
+                        run_task(vQueue[i]);
+                    nQueued             = 0;
+                    return count;
+                }
+
+                inline size_t   submits() const             { return nSubmits;  }
+                inline size_t   distinct() const            { return nSeen;     }
+        };
+
+        /**
+         * Wrapper that provides the test executor to the plugin
+         */
+        class TestWrapper: public plug::IWrapper
+        {
+            private:
+                TestExecutor           *pExecutor;
+
+            public:
+                explicit TestWrapper(plug::Module *plugin, TestExecutor *executor): plug::IWrapper(plugin, NULL)
+                {
+                    pExecutor       = executor;
+                }
+
+                TestWrapper(const TestWrapper &) = delete;
+                TestWrapper(TestWrapper &&) = delete;
+
+                TestWrapper & operator = (const TestWrapper &) = delete;
+                TestWrapper & operator = (TestWrapper &&) = delete;
+
+            public:
+                virtual ipc::IExecutor *executor() override
+                {
+                    return pExecutor;
+                }
+        };
+
+    } /* namespace plugins */
+} /* namespace lsp */
+
+#endif /* LSP_TESTING */
+
+#endif /* PRIVATE_TEST_TESTWRAPPER_H_ */
@@ -0,0 +1,96 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-plugins-autogain
+ * Created on: 18 окт 2026 г.
+ *
+ * lsp-plugins-autogain is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-plugins-autogain is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-plugins-autogain. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef PRIVATE_UTIL_CANVASCACHE_H_
+#define PRIVATE_UTIL_CANVASCACHE_H_
+
+#include <lsp-plug.in/common/types.h>
+#include <lsp-plug.in/dsp-units/iface/IStateDumper.h>
+#include <lsp-plug.in/plug-fw/plug.h>
+
+namespace lsp
+{
+    namespace plugins
+    {
+        /**
+         * Cache of the canvas contents: stores the snapshot of the static part of the
+         * inline display (background, grid, etc) and restores it on the next redraw
+         * while the size of the canvas and the key of the contents remain the same.
+         * Should be used only from the thread that performs the inline display drawing.
+         */
+        class CanvasCache
+        {
+            protected:
+                uint8_t            *pData;              // Snapshot data
+                size_t              nCapacity;          // Capacity of the snapshot data in bytes
+                size_t              nWidth;             // Width of the snapshot
+                size_t              nHeight;            // Height of the snapshot
+                size_t              nStride;            // Stride of the snapshot row
+                uint64_t            nKey;               // Key of the snapshot contents
+                bool                bValid;             // Snapshot is valid
+
+            public:
+                explicit CanvasCache();
+                CanvasCache(const CanvasCache &) = delete;
+                CanvasCache(CanvasCache &&) = delete;
+                ~CanvasCache();
+
+                CanvasCache & operator = (const CanvasCache &) = delete;
+                CanvasCache & operator = (CanvasCache &&) = delete;
+
+                void                destroy();
+
+            public:
+                /**
+                 * Check that the snapshot matches the canvas
+                 * @param cv canvas to check
+                 * @param key the key of the contents
+                 * @return true if snapshot can be restored to the canvas
+                 */
+                bool                valid(plug::ICanvas *cv, uint64_t key) const;
+
+                /**
+                 * Store the contents of the canvas to the snapshot
+                 * @param cv canvas to store
+                 * @param key the key of the contents
+                 * @return true on success
+                 */
+                bool                store(plug::ICanvas *cv, uint64_t key);
+
+                /**
+                 * Restore contents of the canvas from the snapshot
+                 * @param cv canvas to restore
+                 * @return true on success
+                 */
+                bool                restore(plug::ICanvas *cv);
+
+                /**
+                 * Mark the snapshot as invalid
+                 */
+                inline void         invalidate()                { bValid = false;   }
+
+                void                dump(dspu::IStateDumper *v) const;
+        };
+
+    } /* namespace plugins */
+} /* namespace lsp */
+
+#endif /* PRIVATE_UTIL_CANVASCACHE_H_ */
@@ -0,0 +1,155 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-plugins-autogain
+ * Created on: 18 окт 2026 г.
+ *
+ * lsp-plugins-autogain is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-plugins-autogain is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-plugins-autogain. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef PRIVATE_UTIL_CAPTURE_H_
+#define PRIVATE_UTIL_CAPTURE_H_
+
+#include <lsp-plug.in/common/types.h>
+#include <lsp-plug.in/common/status.h>
+#include <lsp-plug.in/io/OutFileStream.h>
+#include <lsp-plug.in/ipc/ITask.h>
+#include <private/util/RecordRing.h>
+#include <private/util/TaskWait.h>
+
+namespace lsp
+{
+    namespace plugins
+    {
+        /*
+         * Session capture file format.
+         *
+         * The file consists of the header followed by the sequence of records in the order
+         * they were produced by the plugin. All fields are stored in the native byte order
+         * of the host (little-endian for all supported architectures), floating-point values
+         * are IEEE 754 single-precision numbers. Each process() call is stored as the CR_BLOCK
+         * record followed by the audio records of the block, the audio data of the channel longer
+         * than CAPTURE_FRAME samples is split into several records. Parameter records are stored
+         * before the block they have been applied to. Port indices refer to the port list of the
+         * plugin metadata of the same build.
+         */
+        static constexpr uint32_t CAPTURE_MAGIC             = 0x50434c41;   // 'ALCP' in little-endian
+        static constexpr uint16_t CAPTURE_VERSION           = 1;
+        static constexpr size_t   CAPTURE_FRAME             = 60;           // Number of samples in the record
+
+        enum capture_record_type_t
+        {
+            CR_SAMPLE_RATE,         // Sample rate has changed: nCount is the sample rate
+            CR_PARAM,               // Parameter value: nIndex is the port index, vData[0] is the value
+            CR_BLOCK,               // Call of process(): nCount is the number of samples
+            CR_INPUT,               // Input audio: nIndex is the channel, nCount is the number of samples in vData
+            CR_SIDECHAIN,           // Sidechain audio: nIndex is the channel, nCount is the number of samples in vData
+            CR_LINK                 // Shared memory link audio: nIndex is the channel, nCount is the number of samples in vData
+        };
+
+        typedef struct capture_header_t
+        {
+            uint32_t            nMagic;         // Magic number, CAPTURE_MAGIC
+            uint16_t            nVersion;       // Format version, CAPTURE_VERSION
+            uint16_t            nRecordSize;    // Size of the record in bytes
+            uint32_t            nChannels;      // Number of audio channels
+            uint32_t            nPorts;         // Number of ports in the plugin metadata
+            uint32_t            nReserved[4];   // Reserved, zero
+        } capture_header_t;
+
+        typedef struct capture_record_t
+        {
+            uint32_t            nType;          // Record type, capture_record_type_t
+            uint32_t            nIndex;         // Channel or port index
+            uint32_t            nCount;         // Number of samples or value depending on the type
+            uint32_t            nDropped;       // Number of records dropped before this record
+            float               vData[CAPTURE_FRAME]; // Data
+        } capture_record_t;
+
+        static_assert(sizeof(capture_header_t) == 32, "Invalid size of capture header");
+        static_assert(sizeof(capture_record_t) == 256, "Invalid size of capture record");
+
+        /**
+         * Ring of capture records passed from the audio thread to the writer
+         */
+        typedef RecordRing<capture_record_t>    CaptureRing;
+
+        /**
+         * Non-RT task that drains the capture ring into the file. The ring is allocated by the task
+         * when the first file is opened, so instances that do not capture do not consume memory for records.
+         */
+        class CaptureWriter: public ipc::ITask
+        {
+            protected:
+                static constexpr size_t BATCH_SIZE  = 32;
+
+            protected:
+                CaptureRing        *pRing;          // Ring to drain
+                size_t              nCapacity;      // Capacity of the ring
+                io::OutFileStream   sOut;           // Output file
+                bool                bOpened;        // File is opened
+                const char         *pRequest;       // Path passed to set_file(), read by the task
+                size_t              nChannels;      // Number of channels stored in the header
+                size_t              nPorts;         // Number of ports stored in the header
+                uatomic_t           nReopen;        // Request to re-open the file, published by set_file()
+                uatomic_t           nCancel;        // Request to stop writing, set by close()
+                char                sPath[PATH_MAX];// Path to the file, accessed by the task only
+                capture_record_t    vBatch[BATCH_SIZE]; // Batch of records
+
+            protected:
+                status_t            open_file();
+                void                close_file();
+                status_t            drain();
+
+            public:
+                explicit CaptureWriter(CaptureRing *ring, size_t capacity);
+                CaptureWriter(const CaptureWriter &) = delete;
+                CaptureWriter(CaptureWriter &&) = delete;
+                virtual ~CaptureWriter() override;
+
+                CaptureWriter & operator = (const CaptureWriter &) = delete;
+                CaptureWriter & operator = (CaptureWriter &&) = delete;
+
+            public:
+                /**
+                 * Set the output file, should be called only when task is idle. The path is not copied
+                 * by the call, it is copied by the task, so the string should remain valid until
+                 * the task completes. The request is published to the task with the atomic flag.
+                 * @param path path to the file, NULL or empty string to stop writing
+                 * @param channels number of channels stored in the header
+                 * @param ports number of ports stored in the header
+                 */
+                void                set_file(const char *path, size_t channels, size_t ports);
+
+                /**
+                 * Wait for the task to finish, write the rest of records and close the output file.
+                 * The running task is asked to stop, if it does not finish in time, the file is left to the task.
+                 */
+                void                close();
+
+                /**
+                 * Check that the file is opened, should be called only when task is idle
+                 * @return true if the file is opened
+                 */
+                inline bool         opened() const      { return bOpened;   }
+
+            public:
+                virtual status_t    run() override;
+        };
+
+    } /* namespace plugins */
+} /* namespace lsp */
+
+#endif /* PRIVATE_UTIL_CAPTURE_H_ */
@@ -0,0 +1,96 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-plugins-autogain
+ * Created on: 18 окт 2026 г.
+ *
+ * lsp-plugins-autogain is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-plugins-autogain is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-plugins-autogain. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef PRIVATE_UTIL_CAPTUREREADER_H_
+#define PRIVATE_UTIL_CAPTUREREADER_H_
+
+/*
+ * The reader is used by the offline replay of session captures, so it is compiled
+ * only into the test builds where LSP_TESTING is defined, for example: make testconfig
+ */
+#ifdef LSP_TESTING
+
+#include <lsp-plug.in/common/types.h>
+#include <lsp-plug.in/common/status.h>
+#include <lsp-plug.in/io/InFileStream.h>
+#include <private/util/Capture.h>
+
+namespace lsp
+{
+    namespace plugins
+    {
+        /**
+         * Sequential reader of the session capture file written by CaptureWriter.
+         * Validates the header on open and the type and size of each record on read.
+         */
+        class CaptureReader
+        {
+            protected:
+                io::InFileStream    sIn;            // Input file
+                capture_header_t    sHeader;        // File header
+                bool                bOpened;        // File is opened
+                size_t              nRecords;       // Number of records read
+                size_t              nDropped;       // Number of records dropped at capture
+
+            public:
+                explicit CaptureReader();
+                CaptureReader(const CaptureReader &) = delete;
+                CaptureReader(CaptureReader &&) = delete;
+                ~CaptureReader();
+
+                CaptureReader & operator = (const CaptureReader &) = delete;
+                CaptureReader & operator = (CaptureReader &&) = delete;
+
+            public:
+                /**
+                 * Open the capture file and read it's header
+                 * @param path path to the file
+                 * @return status of operation, STATUS_BAD_FORMAT if the file is not a capture file,
+                 *   STATUS_UNSUPPORTED_FORMAT if the file has been written by the unsupported version
+                 */
+                status_t            open(const char *path);
+
+                /**
+                 * Read the next record
+                 * @param rec pointer to store the record
+                 * @return status of operation, STATUS_EOF at the end of file,
+                 *   STATUS_CORRUPTED if the record is truncated or invalid
+                 */
+                status_t            read(capture_record_t *rec);
+
+                /**
+                 * Close the file
+                 */
+                void                close();
+
+            public:
+                inline bool         opened() const      { return bOpened;   }
+                inline const capture_header_t *header() const { return &sHeader; }
+                inline size_t       records() const     { return nRecords;  }
+                inline size_t       dropped() const     { return nDropped;  }
+        };
+
+    } /* namespace plugins */
+} /* namespace lsp */
+
+#endif /* LSP_TESTING */
+
+#endif /* PRIVATE_UTIL_CAPTUREREADER_H_ */
@@ -0,0 +1,98 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-plugins-autogain
+ * Created on: 18 окт 2026 г.
+ *
+ * lsp-plugins-autogain is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-plugins-autogain is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-plugins-autogain. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef PRIVATE_UTIL_GRAPHDECIMATOR_H_
+#define PRIVATE_UTIL_GRAPHDECIMATOR_H_
+
+#include <lsp-plug.in/common/types.h>
+#include <lsp-plug.in/dsp-units/iface/IStateDumper.h>
+
+namespace lsp
+{
+    namespace plugins
+    {
+        /**
+         * Min/max decimator of the scrolling graph: maps the stream of graph points
+         * to the fixed number of columns and keeps the minimum and maximum values
+         * for each column. The points are mapped to columns by their absolute position
+         * in the stream, so appending new points updates only the most recent columns.
+         * Should be used only from the thread that performs the drawing.
+         */
+        class GraphDecimator
+        {
+            protected:
+                float              *vMin;               // Ring buffer of column minimums
+                float              *vMax;               // Ring buffer of column maximums
+                size_t              nColumns;           // Number of columns
+                size_t              nPoints;            // Number of graph points that fit all columns
+                uint64_t            nPosition;          // Absolute position of the next point
+                uint64_t            nColumn;            // Absolute index of the last column
+                uint8_t            *pData;              // Allocated data
+
+            public:
+                explicit GraphDecimator();
+                GraphDecimator(const GraphDecimator &) = delete;
+                GraphDecimator(GraphDecimator &&) = delete;
+                ~GraphDecimator();
+
+                GraphDecimator & operator = (const GraphDecimator &) = delete;
+                GraphDecimator & operator = (GraphDecimator &&) = delete;
+
+                /**
+                 * Initialize decimator
+                 * @param columns number of columns
+                 * @param points number of graph points that fit all columns
+                 * @return status of operation
+                 */
+                status_t            init(size_t columns, size_t points);
+
+                void                destroy();
+
+            public:
+                inline size_t       columns() const             { return nColumns;  }
+                inline size_t       points() const              { return nPoints;   }
+
+                /**
+                 * Drop all previously appended points
+                 */
+                void                clear();
+
+                /**
+                 * Append new points of the graph
+                 * @param src points to append
+                 * @param count number of points to append
+                 */
+                void                append(const float *src, size_t count);
+
+                /**
+                 * Get the envelope of the graph, from the oldest column to the most recent one
+                 * @param min buffer to store minimums, should be of columns() size
+                 * @param max buffer to store maximums, should be of columns() size
+                 */
+                void                get(float *min, float *max) const;
+
+                void                dump(dspu::IStateDumper *v) const;
+        };
+
+    } /* namespace plugins */
+} /* namespace lsp */
+
+#endif /* PRIVATE_UTIL_GRAPHDECIMATOR_H_ */
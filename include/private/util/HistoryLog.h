@@ -0,0 +1,168 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-plugins-autogain
+ * Created on: 18 окт 2026 г.
+ *
+ * lsp-plugins-autogain is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-plugins-autogain is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-plugins-autogain. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef PRIVATE_UTIL_HISTORYLOG_H_
+#define PRIVATE_UTIL_HISTORYLOG_H_
+
+#include <lsp-plug.in/common/types.h>
+#include <lsp-plug.in/common/status.h>
+#include <lsp-plug.in/dsp-units/iface/IStateDumper.h>
+#include <lsp-plug.in/ipc/ITask.h>
+#include <private/util/RecordRing.h>
+#include <private/util/TaskWait.h>
+
+namespace lsp
+{
+    namespace plugins
+    {
+        /*
+         * History log file format.
+         *
+         * The file consists of the 64-byte header followed by the array of 48-byte records.
+         * The file is pre-allocated for HISTORY_LOG_RECORDS records and memory-mapped,
+         * the number of valid records is stored in the header and is updated after the
+         * records are written. All fields are stored in the native byte order of the host,
+         * gain and loudness values are stored as linear gain values.
+         * When the file becomes full, it is renamed by adding the '.1' suffix (the previous
+         * file with such name is removed) and the new file is started.
+         */
+        static constexpr uint32_t HISTORY_LOG_MAGIC         = 0x48474c41;   // 'ALGH' in little-endian
+        static constexpr uint16_t HISTORY_LOG_VERSION       = 1;
+        static constexpr size_t   HISTORY_LOG_RECORDS       = 0x100000;     // Records per file, about 29 hours at 100 ms
+        static constexpr size_t   HISTORY_LOG_VALUES        = 7;            // Number of values per record
+
+        enum history_log_flags_t
+        {
+            HLF_REPLAY_END      = 1 << 0                                    // Marker that completes the replayed history,
+                                                                            // nTime is the time when the file has been opened
+        };
+
+        typedef struct history_log_header_t
+        {
+            uint32_t            nMagic;         // Magic number, HISTORY_LOG_MAGIC
+            uint16_t            nVersion;       // Format version, HISTORY_LOG_VERSION
+            uint16_t            nRecordSize;    // Size of the record in bytes
+            uint32_t            nCapacity;      // Maximum number of records in the file
+            uint32_t            nReserved1;     // Reserved, zero
+            uint64_t            nCount;         // Number of valid records
+            uint32_t            nReserved2[10]; // Reserved, zero
+        } history_log_header_t;
+
+        typedef struct history_log_record_t
+        {
+            uint64_t            nTime;          // Wall clock time of the record, milliseconds since UNIX epoch,
+                                                // records passed with zero time are stamped by the writer
+            uint64_t            nPosition;      // Position of the last sample of the record in the audio stream
+            float               vValues[HISTORY_LOG_VALUES]; // Maximum long-period and short-period loudness of
+                                                // input, output and sidechain signals and maximum gain correction
+            uint16_t            nDots;          // Number of history graph points covered by the record
+            uint16_t            nFlags;         // Flags, history_log_flags_t, always zero in the file
+        } history_log_record_t;
+
+        static_assert(sizeof(history_log_header_t) == 64, "Invalid size of history log header");
+        static_assert(sizeof(history_log_record_t) == 48, "Invalid size of history log record");
+
+        /**
+         * Ring of history log records passed between the audio thread and the writer
+         */
+        typedef RecordRing<history_log_record_t>    HistoryLogRing;
+
+        /**
+         * Non-RT task that appends records to the memory-mapped history log file,
+         * flushes and rotates it. After the file has been opened, the task replays
+         * the records previously stored in the file into the replay ring.
+         */
+        class HistoryLog: public ipc::ITask
+        {
+            protected:
+                static constexpr size_t BATCH_SIZE  = 64;
+
+            protected:
+                HistoryLogRing     *pRing;          // Ring of records to write
+                HistoryLogRing     *pReplay;        // Ring of records to replay
+                history_log_header_t   *pHeader;    // Mapped header
+                history_log_record_t   *vRecords;   // Mapped records
+                void               *hFile;          // File handle
+                void               *hMapping;       // Mapping handle
+                uint64_t            nReplayPos;     // Position of the next record to replay
+                uint64_t            nReplayEnd;     // End of the replayed records
+                uint64_t            nReplayTime;    // Time when the replayed file has been opened
+                bool                bReplayEnd;     // The replay end marker should be passed
+                const char         *pRequest;       // Path passed to set_file(), read by the task
+                uatomic_t           nReopen;        // Request to re-open the file, published by set_file()
+                uatomic_t           nCancel;        // Request to stop writing, set by close()
+                char                sPath[PATH_MAX];// Path to the file, accessed by the task only
+                history_log_record_t    vBatch[BATCH_SIZE]; // Batch of records
+
+            protected:
+                status_t            open_file();
+                void                close_file();
+                status_t            map_file(bool *created);
+                void                unmap_file(bool sync);
+                status_t            rotate_file();
+                void                replay();
+
+            public:
+                explicit HistoryLog(HistoryLogRing *ring, HistoryLogRing *replay);
+                HistoryLog(const HistoryLog &) = delete;
+                HistoryLog(HistoryLog &&) = delete;
+                virtual ~HistoryLog() override;
+
+                HistoryLog & operator = (const HistoryLog &) = delete;
+                HistoryLog & operator = (HistoryLog &&) = delete;
+
+            public:
+                /**
+                 * Set the log file, should be called only when task is idle. The path is not copied
+                 * by the call, it is copied by the task, so the string should remain valid until
+                 * the task completes. The request is published to the task with the atomic flag.
+                 * @param path path to the file, NULL or empty string to stop writing
+                 */
+                void                set_file(const char *path);
+
+                /**
+                 * Check that the log file is opened, should be called only when task is idle
+                 * @return true if log file is opened
+                 */
+                inline bool         opened() const              { return pHeader != NULL;   }
+
+                /**
+                 * Check that there are records or the end marker pending for replay, should be called only when task is idle
+                 * @return true if there are records pending for replay
+                 */
+                inline bool         replaying() const           { return (nReplayPos < nReplayEnd) || (bReplayEnd); }
+
+                /**
+                 * Wait for the task to finish and close the file. The running task is asked
+                 * to stop, if it does not finish in time, the mapping is left to the task.
+                 */
+                void                close();
+
+                void                dump(dspu::IStateDumper *v) const;
+
+            public:
+                virtual status_t    run() override;
+        };
+
+    } /* namespace plugins */
+} /* namespace lsp */
+
+#endif /* PRIVATE_UTIL_HISTORYLOG_H_ */
@@ -0,0 +1,142 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-plugins-autogain
+ * Created on: 18 окт 2026 г.
+ *
+ * lsp-plugins-autogain is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-plugins-autogain is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-plugins-autogain. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef PRIVATE_UTIL_LODHISTORY_H_
+#define PRIVATE_UTIL_LODHISTORY_H_
+
+#include <lsp-plug.in/common/types.h>
+#include <lsp-plug.in/common/status.h>
+#include <lsp-plug.in/dsp-units/iface/IStateDumper.h>
+
+namespace lsp
+{
+    namespace plugins
+    {
+        /**
+         * Multi-resolution history of the metered value. The input signal is split into
+         * periods (dots), each dot is decimated into the first level, each next level
+         * decimates the previous one by the specified factor. Each level is a ring buffer of
+         * the fixed number of points that keeps the maximum of the decimated values,
+         * so the memory usage does not depend on the duration of the history and the update
+         * takes O(1) amortized time per dot.
+         */
+        class LODHistory
+        {
+            public:
+                static constexpr size_t LEVELS_MAX  = 8;        // Maximum number of levels
+
+            protected:
+                typedef struct level_t
+                {
+                    float              *vMax;               // Ring buffer of maximums
+                    size_t              nHead;              // Position of the next point in the ring buffer
+                    size_t              nFactor;            // Decimation factor relative to previous level
+                    size_t              nCount;             // Number of decimated values for the current point
+                    float               fMax;               // Maximum of the current point
+                } level_t;
+
+            protected:
+                level_t             vLevels[LEVELS_MAX];// History levels
+                size_t              nLevels;            // Number of levels
+                size_t              nPoints;            // Number of points per level
+                size_t              nPeriod;            // Number of samples per dot
+                size_t              nCounter;           // Number of samples accumulated for the current dot
+                float               fMax;               // Maximum of the current dot
+                uint8_t            *pData;              // Allocated data
+
+            protected:
+                void                store(level_t *l, float max, size_t count);
+                void                append_level(size_t index, float max, size_t count);
+
+            public:
+                explicit LODHistory();
+                LODHistory(const LODHistory &) = delete;
+                LODHistory(LODHistory &&) = delete;
+                ~LODHistory();
+
+                LODHistory & operator = (const LODHistory &) = delete;
+                LODHistory & operator = (LODHistory &&) = delete;
+
+                /**
+                 * Initialize history
+                 * @param points number of points per level
+                 * @param factors decimation factors of each level, the first one is relative to dot
+                 * @param levels number of levels
+                 * @return status of operation
+                 */
+                status_t            init(size_t points, const size_t *factors, size_t levels);
+
+                void                destroy();
+
+            public:
+                inline size_t       levels() const              { return nLevels;   }
+                inline size_t       points() const              { return nPoints;   }
+
+                /**
+                 * Set the size of the dot and clear the history
+                 * @param period number of samples per dot
+                 */
+                void                set_period(size_t period);
+
+                /**
+                 * Clear the history
+                 */
+                void                clear();
+
+                /**
+                 * Process the metered signal
+                 * @param src metered signal
+                 * @param count number of samples
+                 */
+                void                process(const float *src, size_t count);
+
+                /**
+                 * Append the dots with the same value to the history, allows to restore
+                 * the history without processing the signal
+                 * @param max maximum value
+                 * @param dots number of dots
+                 */
+                void                append(float max, size_t dots);
+
+                /**
+                 * Append the last dots of another history with the same configuration, the
+                 * dots are taken from the finest level that still holds all of them
+                 * @param src source history
+                 * @param dots number of last dots to append
+                 * @param buf temporary buffer of at least points() elements
+                 */
+                void                append(const LODHistory *src, size_t dots, float *buf);
+
+                /**
+                 * Read the last points of the history level, from the oldest one to the most recent
+                 * @param level history level
+                 * @param max buffer to store maximums
+                 * @param count number of points to read, should not be greater than points()
+                 */
+                void                read(size_t level, float *max, size_t count) const;
+
+                void                dump(dspu::IStateDumper *v) const;
+        };
+
+    } /* namespace plugins */
+} /* namespace lsp */
+
+#endif /* PRIVATE_UTIL_LODHISTORY_H_ */
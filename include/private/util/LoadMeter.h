@@ -0,0 +1,145 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-plugins-autogain
+ * Created on: 18 окт 2026 г.
+ *
+ * lsp-plugins-autogain is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-plugins-autogain is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-plugins-autogain. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef PRIVATE_UTIL_LOADMETER_H_
+#define PRIVATE_UTIL_LOADMETER_H_
+
+#include <lsp-plug.in/common/types.h>
+#include <lsp-plug.in/dsp-units/iface/IStateDumper.h>
+
+namespace lsp
+{
+    namespace plugins
+    {
+        /**
+         * Get the value of monotonic clock
+         * @return the value of monotonic clock in nanoseconds
+         */
+        uint64_t monotonic_nanos();
+
+        /**
+         * DSP load meter: measures the wall time spent for processing the block of audio
+         * relative to the time the block lasts (the deadline) and collects the histogram
+         * of the load values with logarithmic (power of 2) buckets. When any bucket reaches
+         * BUCKET_MAX, all buckets are halved, so the histogram never overflows on long uptime
+         * and keeps it's shape.
+         */
+        class LoadMeter
+        {
+            public:
+                static constexpr size_t BUCKETS     = 16;   // Number of histogram buckets
+                static constexpr size_t BUCKET_ONE  = 10;   // Index of the bucket that ends with load of 100%
+                static constexpr uint32_t BUCKET_MAX = 0x40000000; // Bucket value that causes halving of the histogram
+
+            protected:
+                uint64_t            nStart;             // Start of the measurement
+                uint64_t            nPending;           // Pending time measured outside the processing
+                size_t              nSampleRate;        // Sample rate
+                float               fLoad;              // Load of the last processed block
+                float               fPeak;              // Peak load since the last reset
+                uint64_t            nIntTime;           // Processing time within the current interval
+                uint64_t            nIntSamples;        // Number of samples within the current interval
+                uint64_t            nBlocks;            // Number of measured blocks
+                uint64_t            nOverruns;          // Number of blocks that missed the deadline
+                uint32_t            vHistogram[BUCKETS];// Histogram
+
+            public:
+                explicit LoadMeter();
+                LoadMeter(const LoadMeter &) = delete;
+                LoadMeter(LoadMeter &&) = delete;
+
+                LoadMeter & operator = (const LoadMeter &) = delete;
+                LoadMeter & operator = (LoadMeter &&) = delete;
+
+            public:
+                inline void         set_sample_rate(size_t sr)  { nSampleRate = sr;    }
+
+                /**
+                 * Reset the statistics
+                 */
+                void                reset();
+
+                /**
+                 * Start measuring the block
+                 */
+                inline void         begin()                     { nStart = monotonic_nanos();   }
+
+                /**
+                 * Complete measuring the block
+                 * @param samples the size of the block in samples
+                 */
+                void                end(size_t samples);
+
+                /**
+                 * Account time spent outside of the block processing, the time
+                 * will be added to the next measured block
+                 * @param start the start time previously obtained by monotonic_nanos()
+                 */
+                void                account(uint64_t start);
+
+                inline float        load() const                { return fLoad;     }
+
+                /**
+                 * Get the average load of all blocks measured since the start of the current
+                 * interval, the blocks are weighted by their duration
+                 * @return average load within the interval, the load of the last block if the interval is empty
+                 */
+                float               interval_load() const;
+
+                /**
+                 * Start the new interval of averaging the load
+                 */
+                void                reset_interval();
+
+                inline float        peak() const                { return fPeak;     }
+                inline uint64_t     overruns() const            { return nOverruns; }
+
+                /**
+                 * Get the upper boundary of the bucket
+                 * @param index bucket index
+                 * @return upper boundary of the bucket as a load value (1.0 = 100%)
+                 */
+                static float        bucket_limit(size_t index);
+
+                /**
+                 * Get the number of blocks counted by the histogram bucket
+                 * @param index bucket index
+                 * @return number of blocks
+                 */
+                inline uint32_t     bucket(size_t index) const  { return vHistogram[index]; }
+
+            #ifdef LSP_TESTING
+                /**
+                 * Set the number of blocks counted by the histogram bucket, allows tests
+                 * to reach the halving of the histogram without measuring 2^30 blocks
+                 * @param index bucket index
+                 * @param count number of blocks
+                 */
+                inline void         preload(size_t index, uint32_t count) { vHistogram[index] = count; }
+            #endif /* LSP_TESTING */
+
+                void                dump(dspu::IStateDumper *v) const;
+        };
+
+    } /* namespace plugins */
+} /* namespace lsp */
+
+#endif /* PRIVATE_UTIL_LOADMETER_H_ */
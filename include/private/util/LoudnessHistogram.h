@@ -0,0 +1,103 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-plugins-autogain
+ * Created on: 18 окт 2026 г.
+ *
+ * lsp-plugins-autogain is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-plugins-autogain is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-plugins-autogain. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef PRIVATE_UTIL_LOUDNESSHISTOGRAM_H_
+#define PRIVATE_UTIL_LOUDNESSHISTOGRAM_H_
+
+#include <lsp-plug.in/common/types.h>
+#include <lsp-plug.in/dsp-units/iface/IStateDumper.h>
+
+namespace lsp
+{
+    namespace plugins
+    {
+        /**
+         * Gated loudness histogram: collects loudness values of measurement blocks into
+         * the fixed set of bins and computes gated integrated loudness and loudness range
+         * as specified by EBU R128 (EBU Tech 3341 and Tech 3342). The memory consumption
+         * does not depend on the duration of the program.
+         */
+        class LoudnessHistogram
+        {
+            public:
+                static constexpr float  LEVEL_MIN   = -70.0f;   // Absolute gate, LUFS
+                static constexpr float  LEVEL_MAX   = 10.0f;    // Upper limit of the histogram, LUFS
+                static constexpr float  BIN_STEP    = 0.1f;     // Width of the bin, LU
+                static constexpr size_t BINS        = 800;      // Number of bins
+
+            protected:
+                uint64_t            nCount;             // Number of blocks above the absolute gate
+                double              fEnergy;            // Energy of blocks above the absolute gate
+                uint64_t            vBins[BINS];        // Histogram
+
+            protected:
+                ssize_t             gate_bin(float gate) const;
+                static double       bin_energy(size_t index);
+
+            public:
+                explicit LoudnessHistogram();
+                LoudnessHistogram(const LoudnessHistogram &) = delete;
+                LoudnessHistogram(LoudnessHistogram &&) = delete;
+
+                LoudnessHistogram & operator = (const LoudnessHistogram &) = delete;
+                LoudnessHistogram & operator = (LoudnessHistogram &&) = delete;
+
+            public:
+                /**
+                 * Reset the histogram
+                 */
+                void                clear();
+
+                /**
+                 * Add loudness of the measurement block
+                 * @param gain loudness of the block as a gain value (LUFS scale)
+                 */
+                void                add(float gain);
+
+                /**
+                 * Get the number of blocks above the absolute gate
+                 * @return number of blocks
+                 */
+                inline uint64_t     count() const       { return nCount;    }
+
+                /**
+                 * Compute gated loudness of the collected blocks
+                 * @param gate relative gate, LU
+                 * @return gated loudness in LUFS, LEVEL_MIN if there is no data
+                 */
+                float               integrated(float gate) const;
+
+                /**
+                 * Compute the loudness range of the collected blocks
+                 * @param gate relative gate, LU
+                 * @param low lower percentile in range of 0..1
+                 * @param high upper percentile in range of 0..1
+                 * @return loudness range in LU, zero if there is no data
+                 */
+                float               range(float gate, float low, float high) const;
+
+                void                dump(dspu::IStateDumper *v) const;
+        };
+
+    } /* namespace plugins */
+} /* namespace lsp */
+
+#endif /* PRIVATE_UTIL_LOUDNESSHISTOGRAM_H_ */
@@ -0,0 +1,134 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-plugins-autogain
+ * Created on: 18 окт 2026 г.
+ *
+ * lsp-plugins-autogain is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-plugins-autogain is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-plugins-autogain. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef PRIVATE_UTIL_METERDECIMATOR_H_
+#define PRIVATE_UTIL_METERDECIMATOR_H_
+
+#include <lsp-plug.in/common/types.h>
+#include <lsp-plug.in/common/status.h>
+#include <lsp-plug.in/dsp-units/iface/IStateDumper.h>
+
+namespace lsp
+{
+    namespace plugins
+    {
+        /**
+         * Multichannel decimator for the loudness analysis path: a cascade of half-band
+         * FIR filters, each stage reduces the sample rate twice. The filters are computed
+         * in polyphase form: the even samples are convolved with the non-zero taps of the
+         * kernel, the odd samples are scaled by the central tap, so each stage costs
+         * HALF_TAPS multiplications per input sample. Blocks of any size are accepted,
+         * the unpaired sample is carried to the next block. All channels should be
+         * processed with the same block sizes to keep them in sync.
+         */
+        class MeterDecimator
+        {
+            public:
+                static constexpr size_t STAGES_MAX  = 3;        // Maximum number of stages
+                static constexpr size_t HALF_TAPS   = 12;       // Number of non-zero side taps at each side of the kernel
+                static constexpr size_t KERNEL      = HALF_TAPS * 2; // Length of the even phase of the kernel
+
+            protected:
+                typedef struct channel_t
+                {
+                    float              *vOut;                   // Decimated data of the last processed block
+                    float              *vAcc[STAGES_MAX];       // Convolution accumulators with the tail
+                    float               vCarry[STAGES_MAX];     // Unpaired sample of each stage
+                    bool                bCarry[STAGES_MAX];     // Unpaired sample is present
+                } channel_t;
+
+            protected:
+                size_t              nChannels;          // Number of channels
+                size_t              nBlock;             // Maximum size of the input block
+                size_t              nStages;            // Number of active stages
+                channel_t          *vChannels;          // Channels
+                float              *vEven;              // Even samples of the block
+                float              *vOdd;               // Odd samples of the block
+                float               vKernel[KERNEL];    // Even phase of the half-band kernel
+                uint8_t            *pData;              // Allocated data
+
+            protected:
+                size_t              decimate(channel_t *c, size_t stage, float *dst, const float *src, size_t count);
+
+            public:
+                explicit MeterDecimator();
+                MeterDecimator(const MeterDecimator &) = delete;
+                MeterDecimator(MeterDecimator &&) = delete;
+                ~MeterDecimator();
+
+                MeterDecimator & operator = (const MeterDecimator &) = delete;
+                MeterDecimator & operator = (MeterDecimator &&) = delete;
+
+                /**
+                 * Initialize the decimator
+                 * @param channels number of channels
+                 * @param max_block maximum number of samples processed at once
+                 * @return status of operation
+                 */
+                status_t            init(size_t channels, size_t max_block);
+
+                /**
+                 * Destroy the decimator
+                 */
+                void                destroy();
+
+            public:
+                inline size_t       stages() const              { return nStages;               }
+                inline size_t       factor() const              { return size_t(1) << nStages;  }
+
+                /**
+                 * Set the number of stages, resets the state if changed
+                 * @param stages number of stages, zero disables the decimation
+                 */
+                void                set_stages(size_t stages);
+
+                /**
+                 * Reset the internal state
+                 */
+                void                clear();
+
+                /**
+                 * Decimate the block of the channel
+                 * @param channel channel index
+                 * @param src source buffer
+                 * @param count number of samples, should not exceed the maximum block size
+                 * @return number of decimated samples available by data()
+                 */
+                size_t              process(size_t channel, const float *src, size_t count);
+
+                /**
+                 * Get the decimated data of the last processed block
+                 * @param channel channel index
+                 * @return decimated data
+                 */
+                inline const float *data(size_t channel) const  { return vChannels[channel].vOut;   }
+
+                /**
+                 * Dump the state
+                 * @param v state dumper
+                 */
+                void                dump(dspu::IStateDumper *v) const;
+        };
+
+    } /* namespace plugins */
+} /* namespace lsp */
+
+#endif /* PRIVATE_UTIL_METERDECIMATOR_H_ */
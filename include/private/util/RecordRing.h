@@ -0,0 +1,204 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-plugins-autogain
+ * Created on: 18 окт 2026 г.
+ *
+ * lsp-plugins-autogain is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-plugins-autogain is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-plugins-autogain. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef PRIVATE_UTIL_RECORDRING_H_
+#define PRIVATE_UTIL_RECORDRING_H_
+
+#include <lsp-plug.in/common/alloc.h>
+#include <lsp-plug.in/common/atomic.h>
+#include <lsp-plug.in/common/types.h>
+#include <lsp-plug.in/common/status.h>
+#include <lsp-plug.in/dsp-units/iface/IStateDumper.h>
+
+namespace lsp
+{
+    namespace plugins
+    {
+        /**
+         * Lock-free single-producer single-consumer ring of fixed-size records.
+         * The producer (audio thread) never blocks: if the ring is full, the record
+         * is dropped and the counter of dropped records is incremented.
+         */
+        template <class T>
+        class RecordRing
+        {
+            protected:
+                size_t              nCapacity;      // Capacity, power of 2
+                uatomic_t           nHead;          // Write position, modified by producer only
+                uatomic_t           nTail;          // Read position, modified by consumer only
+                uint32_t            nDropped;       // Number of dropped records, modified by producer only
+                T                  *vRecords;       // Records
+                uint8_t            *pData;          // Allocated data
+
+            public:
+                explicit RecordRing()
+                {
+                    nCapacity       = 0;
+                    nHead           = 0;
+                    nTail           = 0;
+                    nDropped        = 0;
+                    vRecords        = NULL;
+                    pData           = NULL;
+                }
+
+                RecordRing(const RecordRing &) = delete;
+                RecordRing(RecordRing &&) = delete;
+
+                ~RecordRing()
+                {
+                    destroy();
+                }
+
+                RecordRing & operator = (const RecordRing &) = delete;
+                RecordRing & operator = (RecordRing &&) = delete;
+
+                /**
+                 * Initialize the ring
+                 * @param capacity minimum number of records the ring should hold
+                 * @return status of operation
+                 */
+                status_t            init(size_t capacity)
+                {
+                    size_t cap              = 1;
+                    while (cap < capacity)
+                        cap                   <<= 1;
+
+                    uint8_t *data           = NULL;
+                    T *ptr                  = alloc_aligned<T>(data, cap, DEFAULT_ALIGN);
+                    if (ptr == NULL)
+                        return STATUS_NO_MEM;
+
+                    destroy();
+
+                    nCapacity               = cap;
+                    atomic_store(&nHead, 0);
+                    atomic_store(&nTail, 0);
+                    nDropped                = 0;
+                    vRecords                = ptr;
+                    pData                   = data;
+
+                    return STATUS_OK;
+                }
+
+                /**
+                 * Destroy the ring
+                 */
+                void                destroy()
+                {
+                    if (pData != NULL)
+                    {
+                        free_aligned(pData);
+                        pData                   = NULL;
+                    }
+                    vRecords                = NULL;
+                    nCapacity               = 0;
+                }
+
+            public:
+                /**
+                 * Push the record to the ring, producer-side call, RT-safe
+                 * @param rec record to push
+                 * @return true if record has been pushed
+                 */
+                bool                push(const T *rec)
+                {
+                    if (vRecords == NULL)
+                        return false;
+
+                    uatomic_t head          = nHead;
+                    uatomic_t tail          = atomic_load(&nTail);
+                    if ((head - tail) >= nCapacity)
+                    {
+                        ++nDropped;
+                        return false;
+                    }
+
+                    vRecords[head & (nCapacity - 1)] = *rec;
+
+                    // Publish the record
+                    atomic_store(&nHead, head + 1);
+                    return true;
+                }
+
+                /**
+                 * Get the capacity of the ring
+                 * @return capacity of the ring
+                 */
+                inline size_t       capacity() const    { return nCapacity; }
+
+                /**
+                 * Get the number of records dropped since the last reset of the counter, producer-side call
+                 * @return number of dropped records
+                 */
+                inline uint32_t     dropped() const     { return nDropped;  }
+
+                /**
+                 * Reset the counter of dropped records, producer-side call
+                 */
+                inline void         clear_dropped()     { nDropped = 0;     }
+
+                /**
+                 * Fetch records from the ring, consumer-side call
+                 * @param dst destination array
+                 * @param count maximum number of records to fetch
+                 * @return number of fetched records
+                 */
+                size_t              pop(T *dst, size_t count)
+                {
+                    if (vRecords == NULL)
+                        return 0;
+
+                    uatomic_t tail          = nTail;
+                    uatomic_t head          = atomic_load(&nHead);
+                    size_t n                = lsp_min(size_t(head - tail), count);
+
+                    for (size_t i=0; i<n; ++i)
+                        dst[i]                  = vRecords[(tail + i) & (nCapacity - 1)];
+
+                    // Release records for the producer
+                    atomic_store(&nTail, tail + uatomic_t(n));
+                    return n;
+                }
+
+                /**
+                 * Check that ring is empty
+                 * @return true if ring is empty
+                 */
+                inline bool         empty()
+                {
+                    return atomic_load(&nHead) == atomic_load(&nTail);
+                }
+
+                void                dump(dspu::IStateDumper *v) const
+                {
+                    v->write("nCapacity", nCapacity);
+                    v->write("nHead", nHead);
+                    v->write("nTail", nTail);
+                    v->write("nDropped", nDropped);
+                    v->write("vRecords", vRecords);
+                    v->write("pData", pData);
+                }
+        };
+
+    } /* namespace plugins */
+} /* namespace lsp */
+
+#endif /* PRIVATE_UTIL_RECORDRING_H_ */
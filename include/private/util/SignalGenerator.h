@@ -0,0 +1,165 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-plugins-autogain
+ * Created on: 18 окт 2026 г.
+ *
+ * lsp-plugins-autogain is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-plugins-autogain is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-plugins-autogain. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef PRIVATE_UTIL_SIGNALGENERATOR_H_
+#define PRIVATE_UTIL_SIGNALGENERATOR_H_
+
+/*
+ * The generator replaces the live audio input, so it is compiled only into the test
+ * builds where LSP_TESTING is defined, for example: make testconfig
+ */
+#ifdef LSP_TESTING
+
+#include <lsp-plug.in/common/types.h>
+#include <lsp-plug.in/common/status.h>
+#include <lsp-plug.in/dsp-units/iface/IStateDumper.h>
+
+namespace lsp
+{
+    namespace plugins
+    {
+        /**
+         * Generator of reproducible synthetic test signals for benchmarking and regression
+         * testing of the loudness control. Each scenario produces the main signal and the
+         * sidechain signal which is the main signal with slowly drifting gain. The output
+         * depends only on the scenario, the seed and the sample rate, not on the block size.
+         */
+        class SignalGenerator
+        {
+            public:
+                enum scenario_t
+                {
+                    SG_NONE,                // Generator is disabled
+                    SG_SPEECH,              // Speech-like bursts of syllables and pauses between words
+                    SG_MUSIC,               // Compressed music-like signal with a low crest factor
+                    SG_STEPS,               // Noise with the level changing in steps
+                    SG_GAPS,                // Music-like signal interleaved with long silence gaps
+
+                    SG_TOTAL
+                };
+
+                static constexpr uint32_t   SEED_DFL        = 0x1d872b41;
+                static constexpr float      DRIFT_PERIOD    = 30.0f;        // Period of the sidechain drift, s
+                static constexpr float      DRIFT_RANGE     = 6.0f;         // Range of the sidechain drift, dB
+                static constexpr float      SMOOTH_TIME     = 0.005f;       // Envelope smoothing time, s
+                static constexpr size_t     PARTIALS        = 3;            // Number of tone partials
+                static constexpr float      GAIN_MIN        = 1e-8f;        // Envelope gain flushed to zero
+
+            protected:
+                scenario_t          enScenario;         // Scenario
+                uint32_t            nSeed;              // Initial state of the pseudo-random generator
+                uint32_t            nRandom;            // State of the pseudo-random generator
+                size_t              nSampleRate;        // Sample rate
+                size_t              nBlock;             // Maximum block size
+                size_t              nCounter;           // Number of samples left in the current segment
+                size_t              nSegment;           // Index of the current segment
+                size_t              nSyllables;         // Number of syllables left in the current word
+                size_t              nBeat;              // Length of the beat in samples
+                size_t              nBeatCounter;       // Number of samples left in the current beat
+                uint64_t            nTime;              // Number of generated samples
+                float               fNoise;             // State of the noise low-pass filter
+                float               fGain;              // Current envelope gain
+                float               fTarget;            // Target envelope gain
+                float               fSmooth;            // Envelope smoothing coefficient
+                float               fBeat;              // Current beat envelope
+                float               fBeatDecay;         // Beat envelope decay coefficient
+                float               vPhase[PARTIALS];   // Phases of tone partials
+                float               vStep[PARTIALS];    // Phase increments of tone partials
+                float              *vMain;              // Main signal
+                float              *vSc;                // Sidechain signal
+                uint8_t            *pData;              // Allocated data
+
+            protected:
+                inline uint32_t     next();
+                inline float        noise();
+                float               uniform(float min, float max);
+                size_t              seconds(float time) const;
+                void                set_chord(size_t chord);
+                void                next_segment();
+                float               tone();
+
+            public:
+                explicit SignalGenerator();
+                SignalGenerator(const SignalGenerator &) = delete;
+                SignalGenerator(SignalGenerator &&) = delete;
+                ~SignalGenerator();
+
+                SignalGenerator & operator = (const SignalGenerator &) = delete;
+                SignalGenerator & operator = (SignalGenerator &&) = delete;
+
+                /**
+                 * Initialize generator
+                 * @param scenario scenario
+                 * @param max_block maximum number of samples generated at once
+                 * @param seed initial state of the pseudo-random generator
+                 * @return status of operation
+                 */
+                status_t            init(scenario_t scenario, size_t max_block, uint32_t seed = SEED_DFL);
+
+                /**
+                 * Destroy generator
+                 */
+                void                destroy();
+
+            public:
+                /**
+                 * Parse the name of the scenario
+                 * @param name name of the scenario: speech, music, steps or gaps
+                 * @return scenario or SG_NONE if the name is not valid
+                 */
+                static scenario_t   parse(const char *name);
+
+                inline scenario_t   scenario() const            { return enScenario;            }
+                inline bool         enabled() const             { return enScenario != SG_NONE; }
+
+                /**
+                 * Set sample rate, restarts the scenario
+                 * @param sr sample rate
+                 */
+                void                set_sample_rate(size_t sr);
+
+                /**
+                 * Restart the scenario from the beginning
+                 */
+                void                reset();
+
+                /**
+                 * Generate the next block of the main and sidechain signals
+                 * @param count number of samples, should not exceed the maximum block size
+                 */
+                void                process(size_t count);
+
+                inline float       *signal()                    { return vMain;                 }
+                inline float       *sidechain()                 { return vSc;                   }
+
+                /**
+                 * Dump the state
+                 * @param v state dumper
+                 */
+                void                dump(dspu::IStateDumper *v) const;
+        };
+
+    } /* namespace plugins */
+} /* namespace lsp */
+
+#endif /* LSP_TESTING */
+
+#endif /* PRIVATE_UTIL_SIGNALGENERATOR_H_ */
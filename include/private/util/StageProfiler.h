@@ -0,0 +1,186 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-plugins-autogain
+ * Created on: 18 окт 2026 г.
+ *
+ * lsp-plugins-autogain is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-plugins-autogain is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-plugins-autogain. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef PRIVATE_UTIL_STAGEPROFILER_H_
+#define PRIVATE_UTIL_STAGEPROFILER_H_
+
+/*
+ * The profiler is compiled only if LSP_AUTOGAIN_PROFILE is defined, for example:
+ *   make config CXXFLAGS_EXT="-DLSP_AUTOGAIN_PROFILE"
+ * Additionally defining LSP_AUTOGAIN_PROFILE_CACHE enables counting of cache misses
+ * via perf_event_open() on Linux. The counter is opened by init() and counts the thread
+ * which has initialized the plugin, so the statistics are collected only when the plugin
+ * is processed by the same thread, like in the test harnesses. The counter is read by
+ * update() on the publication of results, not per block.
+ */
+#ifdef LSP_AUTOGAIN_PROFILE
+
+#include <lsp-plug.in/common/types.h>
+#include <lsp-plug.in/common/status.h>
+#include <lsp-plug.in/dsp-units/iface/IStateDumper.h>
+
+#if defined(ARCH_X86)
+    #include <x86intrin.h>
+#else
+    #include <time.h>
+#endif
+
+namespace lsp
+{
+    namespace plugins
+    {
+        /**
+         * Low-overhead profiler that accumulates the number of CPU cycles (TSC ticks
+         * on x86, nanoseconds on other architectures) spent in the sequentially executed
+         * stages of processing, and optionally the number of cache misses per block.
+         */
+        class StageProfiler
+        {
+            public:
+                static constexpr size_t MAX_STAGES      = 8;
+
+                typedef struct stage_t
+                {
+                    uint64_t            nCycles;        // Number of cycles spent
+                    uint64_t            nCalls;         // Number of calls
+                    uint64_t            nSamples;       // Number of processed samples
+                } stage_t;
+
+            protected:
+                stage_t             vStages[MAX_STAGES];
+                uint64_t            nStart;         // Start of the current stage
+                uint64_t            nBlocks;        // Number of measured blocks
+                uint64_t            nPending;       // Number of blocks since the last update()
+                uint64_t            nCacheMisses;   // Number of cache misses for all measured blocks
+                uint64_t            nLastMisses;    // Value of the cache miss counter at the last update()
+                int                 hPerfFd;        // perf_event file descriptor
+                uint32_t            nPerfThread;    // Identifier of the thread counted by perf_event
+
+            protected:
+                static inline uint64_t read_cycles()
+                {
+                #if defined(ARCH_X86)
+                    return __rdtsc();
+                #else
+                    struct timespec ts;
+                    clock_gettime(CLOCK_MONOTONIC, &ts);
+                    return uint64_t(ts.tv_sec) * 1000000000ULL + uint64_t(ts.tv_nsec);
+                #endif
+                }
+
+                void                open_counter();
+                uint64_t            read_cache_misses() const;
+
+            public:
+                explicit StageProfiler();
+                StageProfiler(const StageProfiler &) = delete;
+                StageProfiler(StageProfiler &&) = delete;
+                ~StageProfiler();
+
+                StageProfiler & operator = (const StageProfiler &) = delete;
+                StageProfiler & operator = (StageProfiler &&) = delete;
+
+                /**
+                 * Initialize profiler and open the cache miss counter for the calling thread,
+                 * should be called from the non-RT thread
+                 * @return status of operation
+                 */
+                status_t            init();
+
+                /**
+                 * Destroy profiler
+                 */
+                void                destroy();
+
+            public:
+                /**
+                 * Reset all counters
+                 */
+                void                reset();
+
+                /**
+                 * Start measuring the first stage of the block, should be called from the
+                 * processing thread at the start of each block
+                 */
+                inline void         begin()
+                {
+                    ++nPending;
+                    nStart              = read_cycles();
+                }
+
+                /**
+                 * Complete measuring the stage and start measuring the next one
+                 * @param stage stage index
+                 * @param samples number of samples processed by stage
+                 */
+                inline void         end(size_t stage, size_t samples)
+                {
+                    uint64_t time       = read_cycles();
+                    stage_t *s          = &vStages[stage];
+
+                    s->nCycles         += time - nStart;
+                    s->nCalls          += 1;
+                    s->nSamples        += samples;
+
+                    nStart              = time;
+                }
+
+                /**
+                 * Account the cache misses of the blocks processed since the previous call,
+                 * should be called from the processing thread on the publication of results
+                 */
+                void                update();
+
+                /**
+                 * Get the average number of cycles spent per sample for the stage
+                 * @param stage stage index
+                 * @return average number of cycles per sample
+                 */
+                float               cycles_per_sample(size_t stage) const;
+
+                /**
+                 * Get the average number of cache misses per processed block
+                 * @return average number of cache misses per block
+                 */
+                float               cache_misses_per_block() const;
+
+                inline const stage_t *stage(size_t stage) const    { return &vStages[stage]; }
+
+                /**
+                 * Dump the state
+                 * @param v state dumper
+                 * @param names names of stages
+                 * @param count number of stages
+                 */
+                void                dump(dspu::IStateDumper *v, const char * const *names, size_t count) const;
+        };
+
+    } /* namespace plugins */
+} /* namespace lsp */
+
+    #define AUTOGAIN_PROFILE_BEGIN(prof)                (prof).begin()
+    #define AUTOGAIN_PROFILE_END(prof, stage, samples)  (prof).end(stage, samples)
+#else
+    #define AUTOGAIN_PROFILE_BEGIN(prof)
+    #define AUTOGAIN_PROFILE_END(prof, stage, samples)
+#endif /* LSP_AUTOGAIN_PROFILE */
+
+#endif /* PRIVATE_UTIL_STAGEPROFILER_H_ */
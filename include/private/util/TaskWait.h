@@ -0,0 +1,58 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-plugins-autogain
+ * Created on: 18 окт 2026 г.
+ *
+ * lsp-plugins-autogain is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-plugins-autogain is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-plugins-autogain. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef PRIVATE_UTIL_TASKWAIT_H_
+#define PRIVATE_UTIL_TASKWAIT_H_
+
+#include <lsp-plug.in/common/types.h>
+#include <lsp-plug.in/ipc/ITask.h>
+#include <lsp-plug.in/ipc/Thread.h>
+
+namespace lsp
+{
+    namespace plugins
+    {
+        static constexpr size_t TASK_WAIT_TIMEOUT   = 2000;     // Maximum time to wait for the task, milliseconds
+
+        /**
+         * Wait until the task submitted to the executor finishes it's execution.
+         * Should be called from non-RT thread before releasing the resources used by the task.
+         * The wait is limited, so the caller never hangs if the executor does not run the task
+         * or the task is blocked by the I/O.
+         * @param task task to wait for
+         * @param timeout maximum time to wait in milliseconds
+         * @return true if the task has finished, false if the timeout has expired
+         */
+        inline bool wait_task(ipc::ITask *task, size_t timeout = TASK_WAIT_TIMEOUT)
+        {
+            for (size_t waited = 0; !((task->idle()) || (task->completed())); ++waited)
+            {
+                if (waited >= timeout)
+                    return false;
+                ipc::Thread::sleep(1);
+            }
+            return true;
+        }
+
+    } /* namespace plugins */
+} /* namespace lsp */
+
+#endif /* PRIVATE_UTIL_TASKWAIT_H_ */
@@ -0,0 +1,156 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-plugins-autogain
+ * Created on: 18 окт 2026 г.
+ *
+ * lsp-plugins-autogain is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-plugins-autogain is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-plugins-autogain. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef PRIVATE_UTIL_TELEMETRY_H_
+#define PRIVATE_UTIL_TELEMETRY_H_
+
+#include <lsp-plug.in/common/types.h>
+#include <lsp-plug.in/common/status.h>
+#include <lsp-plug.in/dsp-units/iface/IStateDumper.h>
+#include <lsp-plug.in/io/OutFileStream.h>
+#include <lsp-plug.in/ipc/ITask.h>
+#include <private/util/RecordRing.h>
+#include <private/util/TaskWait.h>
+
+namespace lsp
+{
+    namespace plugins
+    {
+        /*
+         * Telemetry log file format.
+         *
+         * The file consists of the header followed by the sequence of records.
+         * All fields are stored in the native byte order of the host (little-endian
+         * for all supported architectures), floating-point values are IEEE 754
+         * single-precision numbers. Gain and loudness values are stored
+         * as linear gain values. Both structures have fixed size and alignment, so
+         * the file can be mapped into memory and accessed as array of records.
+         *
+         * Version 1 stored one record per processed block of audio. Since version 2 each record
+         * covers the metering interval of nInterval samples, the actual number of samples
+         * covered by the record is stored in the nSamples field of the record.
+         */
+        static constexpr uint32_t TELEMETRY_MAGIC           = 0x54474c41;   // 'ALGT' in little-endian
+        static constexpr uint16_t TELEMETRY_VERSION         = 2;
+
+        typedef struct telemetry_header_t
+        {
+            uint32_t            nMagic;         // Magic number, TELEMETRY_MAGIC
+            uint16_t            nVersion;       // Format version, TELEMETRY_VERSION
+            uint16_t            nRecordSize;    // Size of the record in bytes
+            uint32_t            nSampleRate;    // Sample rate
+            uint32_t            nChannels;      // Number of audio channels
+            uint32_t            nInterval;      // Nominal metering interval in samples
+            uint32_t            nReserved[3];   // Reserved, zero
+        } telemetry_header_t;
+
+        typedef struct telemetry_record_t
+        {
+            uint64_t            nPosition;      // Position of the first sample of the metering interval in the stream
+            uint32_t            nSamples;       // Number of samples in the metering interval
+            uint32_t            nScMode;        // Sidechain mode, meta::autogain::scmode_t
+            float               fGain;          // Maximum gain correction within the metering interval
+            float               fLInGain;       // Input loudness for long period
+            float               fSInGain;       // Input loudness for short period
+            float               fLOutGain;      // Output loudness for long period
+            float               fSOutGain;      // Output loudness for short period
+            float               fLScGain;       // Sidechain loudness for long period
+            float               fSScGain;       // Sidechain loudness for short period
+            float               fLevel;         // Desired loudness level
+            uint32_t            nDropped;       // Number of records dropped before this record
+            uint32_t            nReserved[3];   // Reserved, zero
+        } telemetry_record_t;
+
+        static_assert(sizeof(telemetry_header_t) == 32, "Invalid size of telemetry header");
+        static_assert(sizeof(telemetry_record_t) == 64, "Invalid size of telemetry record");
+
+        /**
+         * Ring of telemetry records passed from the audio thread to the writer
+         */
+        typedef RecordRing<telemetry_record_t>  TelemetryRing;
+
+        /**
+         * Non-RT task that drains the telemetry ring into the file
+         */
+        class TelemetryWriter: public ipc::ITask
+        {
+            protected:
+                static constexpr size_t BATCH_SIZE  = 64;
+
+            protected:
+                TelemetryRing      *pRing;          // Ring to drain
+                io::OutFileStream   sOut;           // Output file
+                uint32_t            nSampleRate;    // Sample rate
+                uint32_t            nChannels;      // Number of channels
+                uint32_t            nInterval;      // Metering interval
+                bool                bOpened;        // File is opened
+                bool                bActive;        // Output file is set, accessed by the caller only
+                const char         *pRequest;       // Path passed to set_file(), read by the task
+                uatomic_t           nReopen;        // Request to re-open the file, published by set_file()
+                uatomic_t           nCancel;        // Request to stop writing, set by close()
+                char                sPath[PATH_MAX];// Path to the file, accessed by the task only
+                telemetry_record_t  vBatch[BATCH_SIZE]; // Batch of records
+
+            protected:
+                status_t            open_file();
+                void                close_file();
+
+            public:
+                explicit TelemetryWriter(TelemetryRing *ring);
+                TelemetryWriter(const TelemetryWriter &) = delete;
+                TelemetryWriter(TelemetryWriter &&) = delete;
+                virtual ~TelemetryWriter() override;
+
+                TelemetryWriter & operator = (const TelemetryWriter &) = delete;
+                TelemetryWriter & operator = (TelemetryWriter &&) = delete;
+
+            public:
+                /**
+                 * Set the output file, should be called only when task is idle. The path is not copied
+                 * by the call, it is copied by the task, so the string should remain valid until
+                 * the task completes. Settings are published to the task with the atomic flag.
+                 * @param path path to the file, NULL or empty string to stop writing
+                 * @param sample_rate sample rate stored in the header
+                 * @param channels number of channels stored in the header
+                 * @param interval nominal metering interval in samples stored in the header
+                 */
+                void                set_file(const char *path, size_t sample_rate, size_t channels, size_t interval);
+
+                /**
+                 * Check that the writer has the output file set
+                 * @return true if writer has the output file set
+                 */
+                bool                active() const;
+
+                /**
+                 * Wait for the task to finish and close the file. The running task is asked
+                 * to stop, if it does not finish in time, the file is left to the task.
+                 */
+                void                close();
+
+            public:
+                virtual status_t    run() override;
+        };
+
+    } /* namespace plugins */
+} /* namespace lsp */
+
+#endif /* PRIVATE_UTIL_TELEMETRY_H_ */
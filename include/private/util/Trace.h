@@ -0,0 +1,132 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-plugins-autogain
+ * Created on: 18 окт 2026 г.
+ *
+ * lsp-plugins-autogain is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-plugins-autogain is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-plugins-autogain. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef PRIVATE_UTIL_TRACE_H_
+#define PRIVATE_UTIL_TRACE_H_
+
+#include <lsp-plug.in/common/types.h>
+#include <lsp-plug.in/common/status.h>
+#include <lsp-plug.in/io/OutFileStream.h>
+#include <lsp-plug.in/ipc/ITask.h>
+#include <private/util/RecordRing.h>
+#include <private/util/TaskWait.h>
+
+namespace lsp
+{
+    namespace plugins
+    {
+        /**
+         * Trace event: the time interval spent for some stage of processing
+         */
+        typedef struct trace_event_t
+        {
+            uint64_t            nStart;         // Start time, nanoseconds of monotonic clock
+            uint64_t            nEnd;           // End time, nanoseconds of monotonic clock
+            uint32_t            nStage;         // Stage index
+            uint32_t            nSamples;       // Number of samples processed
+            uint32_t            nMode;          // Operating mode
+            uint32_t            nThreadId;      // Identifier of the thread
+        } trace_event_t;
+
+        typedef RecordRing<trace_event_t>   TraceRing;
+
+        /**
+         * Get the identifier of the current thread as it is seen by the system profiling tools
+         * @return identifier of the current thread
+         */
+        uint32_t trace_thread_id();
+
+        /**
+         * Get the identifier of the current process
+         * @return identifier of the current process
+         */
+        uint32_t trace_process_id();
+
+        /**
+         * Non-RT task that serializes the trace events into the file in the
+         * Chrome/Perfetto trace event JSON format. The ring is allocated by the task
+         * when the first file is opened, so instances that do not trace do not
+         * consume memory for events.
+         */
+        class TraceWriter: public ipc::ITask
+        {
+            protected:
+                static constexpr size_t BATCH_SIZE  = 64;
+
+            protected:
+                TraceRing          *pRing;          // Ring to drain
+                size_t              nCapacity;      // Capacity of the ring
+                const char * const *vNames;         // Names of stages
+                size_t              nNames;         // Number of names
+                io::OutFileStream   sOut;           // Output file
+                bool                bOpened;        // File is opened
+                const char         *pRequest;       // Path passed to set_file(), read by the task
+                uatomic_t           nReopen;        // Request to re-open the file, published by set_file()
+                uatomic_t           nCancel;        // Request to stop writing, set by close()
+                bool                bFirst;         // No events were written yet
+                uint32_t            nPid;           // Process identifier
+                char                sPath[PATH_MAX];// Path to the file, accessed by the task only
+                trace_event_t       vBatch[BATCH_SIZE]; // Batch of events
+
+            protected:
+                status_t            open_file();
+                void                close_file();
+                status_t            drain();
+                status_t            write_event(const trace_event_t *ev);
+
+            public:
+                explicit TraceWriter(TraceRing *ring, size_t capacity, const char * const *names, size_t count);
+                TraceWriter(const TraceWriter &) = delete;
+                TraceWriter(TraceWriter &&) = delete;
+                virtual ~TraceWriter() override;
+
+                TraceWriter & operator = (const TraceWriter &) = delete;
+                TraceWriter & operator = (TraceWriter &&) = delete;
+
+            public:
+                /**
+                 * Set the output file, should be called only when task is idle. The path is not copied
+                 * by the call, it is copied by the task, so the string should remain valid until
+                 * the task completes. The request is published to the task with the atomic flag.
+                 * @param path path to the file, NULL or empty string to stop writing
+                 */
+                void                set_file(const char *path);
+
+                /**
+                 * Wait for the task to finish, finalize and close the output file. The running task
+                 * is asked to stop, if it does not finish in time, the file is left to the task.
+                 */
+                void                close();
+
+                /**
+                 * Check that the file is opened, should be called only when task is idle
+                 * @return true if the file is opened
+                 */
+                inline bool         opened() const      { return bOpened;   }
+
+            public:
+                virtual status_t    run() override;
+        };
+
+    } /* namespace plugins */
+} /* namespace lsp */
+
+#endif /* PRIVATE_UTIL_TRACE_H_ */
@@ -0,0 +1,154 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-plugins-autogain
+ * Created on: 18 окт 2026 г.
+ *
+ * lsp-plugins-autogain is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-plugins-autogain is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-plugins-autogain. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef PRIVATE_UTIL_TRUEPEAKCEILING_H_
+#define PRIVATE_UTIL_TRUEPEAKCEILING_H_
+
+#include <lsp-plug.in/common/types.h>
+#include <lsp-plug.in/common/status.h>
+#include <lsp-plug.in/dsp-units/iface/IStateDumper.h>
+
+namespace lsp
+{
+    namespace plugins
+    {
+        /**
+         * True peak ceiling: limits the gain applied to the multichannel signal so that
+         * the true peak level of the result does not exceed the ceiling. The true peak is
+         * estimated with 4x polyphase oversampling as specified by ITU-R BS.1770-4, the
+         * maximum of the true peak over the lookahead window is tracked by the monotonic
+         * deque in constant time per sample. The gain limit is smoothed by the moving
+         * average over the lookahead, so the gain reduction starts ahead of the peak.
+         *
+         * The true peak estimation introduces the latency of LATENCY samples, the signal
+         * the gain is applied to should be delayed by (lookahead + LATENCY) samples
+         * relative to the signal passed to the ceiling.
+         */
+        class TruePeakCeiling
+        {
+            public:
+                static constexpr size_t PHASES      = 4;        // Number of oversampling phases
+                static constexpr size_t TAPS        = 12;       // Number of filter taps per phase
+                static constexpr size_t LATENCY     = 6;        // Latency of the true peak estimation
+                static constexpr float  GAIN_MAX    = 1e+6f;    // Gain limit for silence
+
+            protected:
+                typedef struct channel_t
+                {
+                    const float        *vIn;                // Bound input buffer
+                    float              *vPhase[PHASES];     // Output of each oversampling phase with the tail
+                } channel_t;
+
+            protected:
+                size_t              nChannels;          // Number of channels
+                size_t              nBlock;             // Maximum size of the processed block
+                size_t              nCapacity;          // Capacity of the deque and moving average buffer
+                size_t              nLookahead;         // Lookahead in samples
+                size_t              nWindow;            // Length of the true peak window
+                size_t              nLength;            // Length of the moving average
+                size_t              nPosition;          // Position of the current sample
+                size_t              nQHead;             // Head of the deque
+                size_t              nQCount;            // Number of elements in the deque
+                size_t              nAvgHead;           // Head of the moving average buffer
+                double              fAvgSum;            // Sum of the moving average buffer
+                float               fCeiling;           // Ceiling level
+                channel_t          *vChannels;          // Channels
+                float              *vPeak;              // True peak of the block
+                float              *vTemp;              // Temporary buffer
+                float              *vQValue;            // Values of the deque
+                size_t             *vQIndex;            // Positions of the deque values
+                float              *vAvg;               // Moving average buffer
+                uint8_t            *pData;              // Allocated data
+
+            protected:
+                void                reset_window();
+                void                true_peak(channel_t *c, float *dst, size_t samples);
+
+            public:
+                explicit TruePeakCeiling();
+                TruePeakCeiling(const TruePeakCeiling &) = delete;
+                TruePeakCeiling(TruePeakCeiling &&) = delete;
+                ~TruePeakCeiling();
+
+                TruePeakCeiling & operator = (const TruePeakCeiling &) = delete;
+                TruePeakCeiling & operator = (TruePeakCeiling &&) = delete;
+
+                /**
+                 * Initialize the ceiling
+                 * @param channels number of channels
+                 * @param max_block maximum number of samples processed at once
+                 * @param max_lookahead maximum lookahead in samples
+                 * @return status of operation
+                 */
+                status_t            init(size_t channels, size_t max_block, size_t max_lookahead);
+
+                /**
+                 * Destroy the ceiling
+                 */
+                void                destroy();
+
+            public:
+                inline size_t       lookahead() const           { return nLookahead;            }
+                inline size_t       latency() const             { return nLookahead + LATENCY;  }
+                inline float        ceiling() const             { return fCeiling;              }
+
+                /**
+                 * Set the ceiling level
+                 * @param gain ceiling level as a gain value
+                 */
+                inline void         set_ceiling(float gain)     { fCeiling = gain;              }
+
+                /**
+                 * Set the lookahead, resets the lookahead window if changed
+                 * @param samples lookahead in samples
+                 */
+                void                set_lookahead(size_t samples);
+
+                /**
+                 * Reset the internal state
+                 */
+                void                clear();
+
+                /**
+                 * Bind the input buffer of the channel
+                 * @param channel channel index
+                 * @param src input buffer, NULL means silence
+                 */
+                void                bind(size_t channel, const float *src);
+
+                /**
+                 * Process the bound input buffers and limit the gain
+                 * @param gain gain to limit
+                 * @param samples number of samples, should not exceed the maximum block size
+                 */
+                void                process(float *gain, size_t samples);
+
+                /**
+                 * Dump the state
+                 * @param v state dumper
+                 */
+                void                dump(dspu::IStateDumper *v) const;
+        };
+
+    } /* namespace plugins */
+} /* namespace lsp */
+
+#endif /* PRIVATE_UTIL_TRUEPEAKCEILING_H_ */
@@ -1,7 +1,8 @@
 <?php
 	plugin_header();
-	$m      =   ($PAGE == 'autogain_mono') ? 'm' : 's';
+	$m      =   (strpos($PAGE, '_mono') !== false) ? 'm' : 's';
 	$sc     =   (strpos($PAGE, 'sc_') === 0);
+	$env    =   (strpos($PAGE, 'autogain_env_') === 0);
 ?>
 
 <p>
@@ -34,6 +35,14 @@
 	This prevents from significant amplification of a background noise in the case of long silence at the input. 
 </p>
 
+<?php if($env) { ?>
+<p>
+	This version of the plugin provides additional <b>Gain envelope output</b> which passes the computed gain correction
+	for each sample of the audio stream. The output can be connected to the gain envelope input of the
+	<b>Autogain Follower</b> plugin to apply the same gain curve to other signals without additional loudness measurements.
+</p>
+<?php } ?>
+
 <p><b>Controls:</b></p>
 <ul>
 	<li><b>Bypass</b> - bypass switch, when turned on the plugin bypasses signal without any change.</li>
@@ -56,9 +65,151 @@
 		<li>Match Link</li> - the level of the input signal is corrected to match the level of the input signal passed by shared memory link.
 	<?php } ?>
 	</ul>
+	<li><b>Decimate</b> - enables loudness metering of the decimated signal. At sample rates of 88.2 kHz and above
+	the input, sidechain and output signals are decimated by half-band filters to the sample rate between 44.1 kHz and 96 kHz
+	before the loudness measurement which reduces the CPU and memory consumption of the loudness meters. The gain
+	correction is still applied at the original sample rate. The signal above the audio band is excluded from the measurement.</li>
+	<li><b>History</b> - the period of time displayed by the loudness and gain graphs, from 4 seconds up to 24 hours.
+	For periods longer than 4 seconds each point of the graph shows the maximum value within the corresponding interval of time.</li>
+	<li><b>Integrated</b> - the integrated loudness of the output signal in LUFS/LKFS units measured according to EBU R128:
+	momentary loudness (400 ms, K-weighting) is measured every 100 ms, blocks below -70 LUFS and blocks more than 10 LU below
+	the loudness of the remaining blocks are excluded from the measurement.</li>
+	<li><b>LRA</b> - the loudness range of the output signal in LU units measured according to EBU R128: the difference between
+	95th and 10th percentiles of the short-term loudness (3 s, K-weighting) distribution, blocks below -70 LUFS and blocks more than
+	20 LU below the loudness of the remaining blocks are excluded from the measurement. Both the integrated loudness and the
+	loudness range are measured since the start of the plugin or since the last press of the <b>Reset</b> button and do not
+	depend on the weighting function and periods selected for the automatic gain control. The measurement has 0.1 LU resolution
+	and does not consume additional memory for long programs.</li>
+	<li><b>DSP load</b> - the current and the peak time spent by the plugin for processing the block of audio
+	relative to the duration of the block. The current value is averaged over all blocks processed since the previous
+	update of the meter, the peak value is the maximum load of a single block. Values above 100% mean that the plugin is not able to process
+	the audio in real time. The graph next to the meters shows the histogram of load values: the fraction of processed
+	blocks for each range of the load, the vertical line marks the load of 100%. The <b>Reset</b> button resets the peak
+	value and the histogram. On long uptime the histogram is periodically scaled down, so it keeps
+	it's shape and does not overflow.</li>
 	<li><b>Link</b> - the name of the shared memory link to pass control/match signal.</li>
 </ul>
 
+<p><b>Telemetry</b>:</p>
+<p>
+	The plugin can log the gain correction and loudness values for each processed block of audio into a binary file
+	for further analysis, for example, for the loudness compliance reports. Logging is controlled by the
+	<b>Telemetry</b> switch, the file is specified by the <b>Telemetry log file</b> parameter which can be selected by the
+	button next to the switch or set by the host.
+	The file starts with the 32-byte header followed by the sequence of 64-byte records, one per metering interval
+	which lasts about 10 milliseconds regardless of the size of the audio block used by the host.
+	All values are stored in the native byte order of the host.
+</p>
+<p>The header has the following format:</p>
+<ul>
+	<li><b>uint32</b> - magic number, ASCII sequence 'ALGT';</li>
+	<li><b>uint16</b> - version of the format, currently 2;</li>
+	<li><b>uint16</b> - size of the record in bytes, currently 64;</li>
+	<li><b>uint32</b> - sample rate;</li>
+	<li><b>uint32</b> - number of audio channels;</li>
+	<li><b>uint32</b> - nominal length of the metering interval in samples;</li>
+	<li><b>uint32[3]</b> - reserved.</li>
+</ul>
+<p>Each record has the following format:</p>
+<ul>
+	<li><b>uint64</b> - position of the first sample of the metering interval in the audio stream;</li>
+	<li><b>uint32</b> - number of samples in the metering interval;</li>
+	<li><b>uint32</b> - sidechain mode: 0 - internal, 1 - control SC, 2 - match SC, 3 - control link, 4 - match link;</li>
+	<li><b>float32</b> - maximum gain correction within the metering interval;</li>
+	<li><b>float32[6]</b> - long-period and short-period loudness of input, output and sidechain signals;</li>
+	<li><b>float32</b> - desired loudness level;</li>
+	<li><b>uint32</b> - number of records dropped before this record due to overflow;</li>
+	<li><b>uint32[3]</b> - reserved.</li>
+</ul>
+<p>All gain and loudness values are stored as linear gain values.</p>
+
+<p><b>History log</b>:</p>
+<p>
+	The plugin can persistently store the history of the loudness and gain correction values into a file, so it is possible
+	to inspect what the plugin did to the signal over the long period of time. Logging is controlled by the <b>History log</b>
+	switch, the file is specified by the <b>History log file</b> parameter which can be selected by the button next to
+	the switch or set by the host. New records are appended to the existing file. When the file is opened, the records
+	already stored in it are used to restore the history graphs, the graphs keep showing the current history until the
+	restore completes. When the file becomes full, it is renamed by adding the '.1' suffix and the new file is started.
+</p>
+<p>
+	The file is pre-allocated and memory-mapped. It starts with the 64-byte header followed by the array of 48-byte records,
+	one per about 100 milliseconds. All values are stored in the native byte order of the host.
+</p>
+<p>The header has the following format:</p>
+<ul>
+	<li><b>uint32</b> - magic number, ASCII sequence 'ALGH';</li>
+	<li><b>uint16</b> - version of the format, currently 1;</li>
+	<li><b>uint16</b> - size of the record in bytes, currently 48;</li>
+	<li><b>uint32</b> - maximum number of records in the file;</li>
+	<li><b>uint32</b> - reserved;</li>
+	<li><b>uint64</b> - number of valid records in the file;</li>
+	<li><b>uint32[10]</b> - reserved.</li>
+</ul>
+<p>Each record has the following format:</p>
+<ul>
+	<li><b>uint64</b> - wall clock time of the record in milliseconds since the UNIX epoch;</li>
+	<li><b>uint64</b> - position of the last sample of the record in the audio stream;</li>
+	<li><b>float32[7]</b> - maximum long-period and short-period loudness of input, output and sidechain signals,
+	and maximum gain correction, stored as linear gain values;</li>
+	<li><b>uint16</b> - number of history graph points covered by the record;</li>
+	<li><b>uint16</b> - reserved.</li>
+</ul>
+
+<p><b>Inline display</b>:</p>
+<p>
+	The inline display is redrawn with the rate specified by the <b>Inline display rate</b> knob.
+	Lower values reduce the load of the GUI thread of the host when many instances of the plugin are used.
+</p>
+
+<p><b>Tracing</b>:</p>
+<p>
+	For performance analysis, the timeline of the processing can be written into a JSON file in Chrome trace-event format
+	which can be opened by the <b>chrome://tracing</b> page or by the Perfetto UI. Tracing is started by selecting the
+	<b>Trace file</b> with the button next to the <b>Trace</b> label or by setting the parameter from the host,
+	and is stopped by clearing the file name. Each plugin instance writes it's own file. Each call of the processing
+	routine and each processing stage are stored as complete events with the number of processed samples and
+	the sidechain mode as arguments. The memory for trace events is allocated only when the trace is started.
+</p>
+
+<p><b>Session capture</b>:</p>
+<p>
+	To reproduce problems that happen during the live processing, each plugin instance can record it's input session
+	into a binary file. The capture is started by selecting the <b>Session capture file</b> with the button next to
+	the <b>Capture</b> label or by setting the parameter from the host, and is stopped by clearing the file name.
+	The file contains the sample rate, the size of each processed block, the input, sidechain and shared memory link
+	audio data and the values of all input parameters at the start of the capture followed by their changes.
+	The data is passed to the file by the background task, so the capture does not block the audio processing.
+	If the file can not be written fast enough, the records are dropped and the number of dropped records is stored
+	in the file. The session can be replayed offline through the same build of the plugin for profiling and debugging
+	by the <b>autogain.capture_replay</b> manual test which is available in the test builds of the plugin
+	(<b>make testconfig</b>) and takes the identifier of the plugin and the path to the capture file as arguments.
+	The replay reports the processing time and the peak level and digest of each output, so two replays of the same
+	session can be compared.
+</p>
+
+<p><b>Test signals</b>:</p>
+<p>
+	For benchmarking and regression testing, the input and sidechain signals can be replaced by the built-in generator
+	of reproducible synthetic signals. The generator is available only in the test builds of the plugin
+	(<b>make testconfig</b>) and is enabled by setting the <b>LSP_AUTOGAIN_GENERATOR</b> environment
+	variable to the name of the scenario before starting the host. The variable is read when the plugin instance
+	is created and applies to all instances created by the host process. The generator is intentionally not
+	available as a parameter, so the parameters of test and release builds are the same and presets and session
+	captures are compatible between them. The available scenarios are:
+</p>
+<ul>
+	<li><b>speech</b> - speech-like bursts of syllables with pauses between words.</li>
+	<li><b>music</b> - compressed music-like signal with the low crest factor.</li>
+	<li><b>steps</b> - noise with the level changing in steps each 5 seconds.</li>
+	<li><b>gaps</b> - music-like signal of 10 seconds interleaved with 20 seconds of silence.</li>
+</ul>
+<p>
+	In all scenarios the sidechain signal is the same signal with the gain slowly drifting by &plusmn;6 dB with the
+	period of 30 seconds. The generated signal depends only on the scenario and the sample rate and does not depend
+	on the block size.
+</p>
+
 <p><b>Meters</b>:</p>
 <ul>
 	<li><b>In</b> - the loudness (measured for short and long periods) of the input signal in LUFS/LKFS units.</li>
@@ -71,6 +222,11 @@
 <ul>
 	<li><b>Preamp</b> - additional gain applied to the sidechain signal.</li>
 	<li><b>Lookahead</b> - sidechain lookahead time, allows to delay the original signal to make work more smooth.</li>
+	<li><b>TP ceiling</b> - enables the true peak ceiling and sets its level in dBTP. When enabled, the gain correction
+	is reduced when it would push the true peak of the output signal above the ceiling. The true peak is estimated
+	with 4x oversampling as specified by ITU-R BS.1770-4, the estimation adds 6 samples of latency. The gain reduction
+	starts ahead of the peak and lasts for the <b>Lookahead</b> time, zero lookahead makes the ceiling work as a clipper.
+	The gain correction graph and the gain envelope output do not include the gain reduction applied by the ceiling.</li>
 </ul>
 <p><b>Loudness</b> Section:</p>
 <ul>
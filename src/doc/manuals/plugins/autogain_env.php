@@ -0,0 +1,3 @@
+<?php
+	require_once("autogain.php");
+?>
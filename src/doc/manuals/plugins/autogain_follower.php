@@ -0,0 +1,25 @@
+<?php
+	plugin_header();
+	$m      =   (strpos($PAGE, '_mono') !== false) ? 'm' : 's';
+?>
+
+<p>
+	This plugin applies the gain envelope computed by the <b>Autogain Envelope</b> plugin to the input signal.
+	The plugin does not perform any loudness measurements, so the single gain curve computed by one autogain
+	instance can be shared between several processing chains without running the full analysis chain again.
+</p>
+<p>
+	The gain envelope is passed to the plugin via the additional audio input which should be connected to the
+	<b>Gain envelope output</b> of the <b>Autogain Envelope</b> plugin. Each sample of the envelope input
+	defines the gain applied to the corresponding sample of the <?= ($m == 'm') ? 'input' : 'left and right input' ?> signal.
+</p>
+
+<p><b>Controls:</b></p>
+<ul>
+	<li><b>Bypass</b> - bypass switch, when turned on the plugin bypasses signal without any change.</li>
+</ul>
+
+<p><b>Meters</b>:</p>
+<ul>
+	<li><b>Gain</b> - the level of the gain correction signal passed via the gain envelope input.</li>
+</ul>
@@ -26,7 +26,7 @@
 
 #define LSP_PLUGINS_AUTOGAIN_VERSION_MAJOR       1
 #define LSP_PLUGINS_AUTOGAIN_VERSION_MINOR       0
-#define LSP_PLUGINS_AUTOGAIN_VERSION_MICRO       21
+#define LSP_PLUGINS_AUTOGAIN_VERSION_MICRO       22
 
 #define LSP_PLUGINS_AUTOGAIN_VERSION  \
     LSP_MODULE_VERSION( \
@@ -75,6 +75,18 @@ namespace lsp
             { NULL, NULL }
         };
 
+        static const port_item_t history_zoom[] =
+        {
+            { "4 s",            "autogain.history.4s"       },
+            { "20 s",           "autogain.history.20s"      },
+            { "2 min",          "autogain.history.2min"     },
+            { "10 min",         "autogain.history.10min"    },
+            { "1 hour",         "autogain.history.1h"       },
+            { "6 hours",        "autogain.history.6h"       },
+            { "24 hours",       "autogain.history.24h"      },
+            { NULL, NULL }
+        };
+
         static const port_item_t weighting_modes[] =
         {
             { "None",           "autogain.weighting.none"   },
@@ -95,6 +107,12 @@ namespace lsp
             OPT_AUDIO_RETURN("scl_l", "Side-chain shared memory link input Left", 0, "link"), \
             OPT_AUDIO_RETURN("scl_r", "Side-chain shared memory link input Right", 1, "link")
 
+        #define AUTOGAIN_GAIN_ENV_OUT \
+            AUDIO_OUTPUT("genv", "Gain envelope output", "Gain env")
+
+        #define AUTOGAIN_GAIN_ENV_IN \
+            AUDIO_INPUT("genv", "Gain envelope input", "Gain env")
+
         #define AUTOGAIN_COMMON_SC(combo, combo_dfl) \
             CONTROL("preamp", "Sidechain preamp", "SC preamp", U_DB, meta::autogain::SC_PREAMP), \
             CONTROL("lkahead", "Sidechain lookahead", "SC look", U_MSEC, meta::autogain::SC_LOOKAHEAD), \
@@ -151,6 +169,52 @@ namespace lsp
             MESH("gr_g", "Gain correction graph", 2, meta::autogain::MESH_POINTS + 4)
 
 
+        #define AUTOGAIN_CEILING \
+            SWITCH("tp_on", "True peak ceiling", "TP ceiling on", 0.0f), \
+            CONTROL("tp_ceil", "True peak ceiling level", "TP ceiling", U_DB, meta::autogain::CEILING)
+
+        #define AUTOGAIN_DECIMATION \
+            SWITCH("mdecim", "Decimated loudness metering", "Decim meter", 0.0f)
+
+        #define AUTOGAIN_TELEMETRY \
+            SWITCH("tlm_on", "Telemetry logging", "Telemetry", 0.0f), \
+            PATH("tlm_file", "Telemetry log file")
+
+        #define AUTOGAIN_DIAGNOSTICS \
+            PATH("trc_file", "Trace file"), \
+            PATH("cap_file", "Session capture file")
+
+        #define AUTOGAIN_IDISPLAY \
+            CONTROL("idrate", "Inline display refresh rate", "ID rate", U_HZ, meta::autogain::IDISPLAY_RATE)
+
+        #define AUTOGAIN_HISTORY \
+            COMBO("hzoom", "History graph zoom", "Zoom", 0, history_zoom), \
+            SWITCH("hlog_on", "History logging", "History log", 0.0f), \
+            PATH("hlog_file", "History log file")
+
+        #define AUTOGAIN_INTEGRATED \
+            METER("int_l", "Integrated output loudness", U_LUFS, meta::autogain::INTEGRATED), \
+            METER("lra", "Output loudness range", U_DB, meta::autogain::LRA), \
+            TRIGGER("int_rst", "Reset integrated loudness", "Reset integrated")
+
+        #define AUTOGAIN_DSP_LOAD \
+            METER("dsp_load", "DSP load", U_PERCENT, meta::autogain::DSP_LOAD), \
+            METER("dsp_peak", "DSP load peak", U_PERCENT, meta::autogain::DSP_LOAD), \
+            TRIGGER("dsp_rst", "Reset DSP load statistics", "Reset load"), \
+            MESH("dsp_hist", "DSP load histogram", 2, meta::autogain::DSP_LOAD_BUCKETS)
+
+    #ifdef LSP_AUTOGAIN_PROFILE
+        #define AUTOGAIN_PROFILE_PORTS \
+            METER("prof_o", "Profile: other processing cycles per sample", U_NONE, meta::autogain::PROFILE), \
+            METER("prof_i", "Profile: loudness measurement cycles per sample", U_NONE, meta::autogain::PROFILE), \
+            METER("prof_g", "Profile: gain correction computing cycles per sample", U_NONE, meta::autogain::PROFILE), \
+            METER("prof_a", "Profile: gain correction applying cycles per sample", U_NONE, meta::autogain::PROFILE), \
+            METER("prof_b", "Profile: audio buffer update cycles per sample", U_NONE, meta::autogain::PROFILE), \
+            METER("prof_m", "Profile: mesh output cycles per sample", U_NONE, meta::autogain::PROFILE),
+    #else
+        #define AUTOGAIN_PROFILE_PORTS
+    #endif /* LSP_AUTOGAIN_PROFILE */
+
         static const port_t autogain_mono_ports[] =
         {
             PORTS_MONO_PLUGIN,
@@ -158,6 +222,15 @@ namespace lsp
             AUTOGAIN_LINK_MONO,
             AUTOGAIN_INT_SC,
             AUTOGAIN_COMMON,
+            AUTOGAIN_CEILING,
+            AUTOGAIN_DECIMATION,
+            AUTOGAIN_TELEMETRY,
+            AUTOGAIN_DIAGNOSTICS,
+            AUTOGAIN_IDISPLAY,
+            AUTOGAIN_HISTORY,
+            AUTOGAIN_INTEGRATED,
+            AUTOGAIN_DSP_LOAD,
+            AUTOGAIN_PROFILE_PORTS
 
             PORTS_END
         };
@@ -169,6 +242,15 @@ namespace lsp
             AUTOGAIN_LINK_STEREO,
             AUTOGAIN_INT_SC,
             AUTOGAIN_COMMON,
+            AUTOGAIN_CEILING,
+            AUTOGAIN_DECIMATION,
+            AUTOGAIN_TELEMETRY,
+            AUTOGAIN_DIAGNOSTICS,
+            AUTOGAIN_IDISPLAY,
+            AUTOGAIN_HISTORY,
+            AUTOGAIN_INTEGRATED,
+            AUTOGAIN_DSP_LOAD,
+            AUTOGAIN_PROFILE_PORTS
 
             PORTS_END
         };
@@ -181,6 +263,15 @@ namespace lsp
             AUTOGAIN_LINK_MONO,
             AUTOGAIN_EXT_SC,
             AUTOGAIN_COMMON,
+            AUTOGAIN_CEILING,
+            AUTOGAIN_DECIMATION,
+            AUTOGAIN_TELEMETRY,
+            AUTOGAIN_DIAGNOSTICS,
+            AUTOGAIN_IDISPLAY,
+            AUTOGAIN_HISTORY,
+            AUTOGAIN_INTEGRATED,
+            AUTOGAIN_DSP_LOAD,
+            AUTOGAIN_PROFILE_PORTS
 
             PORTS_END
         };
@@ -193,11 +284,83 @@ namespace lsp
             AUTOGAIN_LINK_STEREO,
             AUTOGAIN_EXT_SC,
             AUTOGAIN_COMMON,
+            AUTOGAIN_CEILING,
+            AUTOGAIN_DECIMATION,
+            AUTOGAIN_TELEMETRY,
+            AUTOGAIN_DIAGNOSTICS,
+            AUTOGAIN_IDISPLAY,
+            AUTOGAIN_HISTORY,
+            AUTOGAIN_INTEGRATED,
+            AUTOGAIN_DSP_LOAD,
+            AUTOGAIN_PROFILE_PORTS
+
+            PORTS_END
+        };
+
+        static const port_t autogain_env_mono_ports[] =
+        {
+            PORTS_MONO_PLUGIN,
+            AUTOGAIN_GAIN_ENV_OUT,
+            BYPASS,
+            AUTOGAIN_LINK_MONO,
+            AUTOGAIN_INT_SC,
+            AUTOGAIN_COMMON,
+            AUTOGAIN_CEILING,
+            AUTOGAIN_DECIMATION,
+            AUTOGAIN_TELEMETRY,
+            AUTOGAIN_DIAGNOSTICS,
+            AUTOGAIN_IDISPLAY,
+            AUTOGAIN_HISTORY,
+            AUTOGAIN_INTEGRATED,
+            AUTOGAIN_DSP_LOAD,
+            AUTOGAIN_PROFILE_PORTS
+
+            PORTS_END
+        };
+
+        static const port_t autogain_env_stereo_ports[] =
+        {
+            PORTS_STEREO_PLUGIN,
+            AUTOGAIN_GAIN_ENV_OUT,
+            BYPASS,
+            AUTOGAIN_LINK_STEREO,
+            AUTOGAIN_INT_SC,
+            AUTOGAIN_COMMON,
+            AUTOGAIN_CEILING,
+            AUTOGAIN_DECIMATION,
+            AUTOGAIN_TELEMETRY,
+            AUTOGAIN_DIAGNOSTICS,
+            AUTOGAIN_IDISPLAY,
+            AUTOGAIN_HISTORY,
+            AUTOGAIN_INTEGRATED,
+            AUTOGAIN_DSP_LOAD,
+            AUTOGAIN_PROFILE_PORTS
+
+            PORTS_END
+        };
+
+        static const port_t autogain_follower_mono_ports[] =
+        {
+            PORTS_MONO_PLUGIN,
+            AUTOGAIN_GAIN_ENV_IN,
+            BYPASS,
+            METER_GAIN("g_g", "Gain correction meter", GAIN_AMP_P_120_DB),
+
+            PORTS_END
+        };
+
+        static const port_t autogain_follower_stereo_ports[] =
+        {
+            PORTS_STEREO_PLUGIN,
+            AUTOGAIN_GAIN_ENV_IN,
+            BYPASS,
+            METER_GAIN("g_g", "Gain correction meter", GAIN_AMP_P_120_DB),
 
             PORTS_END
         };
 
         static const int plugin_classes[]       = { C_ENVELOPE, -1 };
+        static const int follower_classes[]     = { C_AMPLIFIER, -1 };
         static const int clap_features_mono[]   = { CF_AUDIO_EFFECT, CF_UTILITY, CF_MONO, -1 };
         static const int clap_features_stereo[] = { CF_AUDIO_EFFECT, CF_UTILITY, CF_STEREO, -1 };
 
@@ -338,5 +501,133 @@ namespace lsp
         };
         LSP_REGISTER_METADATA(sc_autogain_stereo);
 
+        const plugin_t autogain_env_mono =
+        {
+            "Autogain Envelope Mono",
+            "Autogain Envelope Mono",
+            "Autogain Envelope Mono",
+            "AGE1M",
+            &developers::v_sadovnikov,
+            "autogain_env_mono",
+            {
+                LSP_LV2_URI("autogain_env_mono"),
+                LSP_LV2UI_URI("autogain_env_mono"),
+                "agem",
+                LSP_VST3_UID("age1m   agem"),
+                LSP_VST3UI_UID("age1m   agem"),
+                LSP_LADSPA_AUTOGAIN_BASE + 4,
+                LSP_LADSPA_URI("autogain_env_mono"),
+                LSP_CLAP_URI("autogain_env_mono"),
+                LSP_GST_UID("autogain_env_mono"),
+            },
+            LSP_PLUGINS_AUTOGAIN_VERSION,
+            plugin_classes,
+            clap_features_mono,
+            E_DUMP_STATE | E_INLINE_DISPLAY,
+            autogain_env_mono_ports,
+            "plugins/util/autogain.xml",
+            NULL,
+            mono_plugin_port_groups,
+            &autogain_bundle,
+            5
+        };
+        LSP_REGISTER_METADATA(autogain_env_mono);
+
+        const plugin_t autogain_env_stereo =
+        {
+            "Autogain Envelope Stereo",
+            "Autogain Envelope Stereo",
+            "Autogain Envelope Stereo",
+            "AGE1S",
+            &developers::v_sadovnikov,
+            "autogain_env_stereo",
+            {
+                LSP_LV2_URI("autogain_env_stereo"),
+                LSP_LV2UI_URI("autogain_env_stereo"),
+                "ages",
+                LSP_VST3_UID("age1s   ages"),
+                LSP_VST3UI_UID("age1s   ages"),
+                LSP_LADSPA_AUTOGAIN_BASE + 5,
+                LSP_LADSPA_URI("autogain_env_stereo"),
+                LSP_CLAP_URI("autogain_env_stereo"),
+                LSP_GST_UID("autogain_env_stereo"),
+            },
+            LSP_PLUGINS_AUTOGAIN_VERSION,
+            plugin_classes,
+            clap_features_stereo,
+            E_DUMP_STATE | E_INLINE_DISPLAY,
+            autogain_env_stereo_ports,
+            "plugins/util/autogain.xml",
+            NULL,
+            stereo_plugin_port_groups,
+            &autogain_bundle,
+            6
+        };
+        LSP_REGISTER_METADATA(autogain_env_stereo);
+
+        const plugin_t autogain_follower_mono =
+        {
+            "Autogain Follower Mono",
+            "Autogain Follower Mono",
+            "Autogain Follower Mono",
+            "AGF1M",
+            &developers::v_sadovnikov,
+            "autogain_follower_mono",
+            {
+                LSP_LV2_URI("autogain_follower_mono"),
+                LSP_LV2UI_URI("autogain_follower_mono"),
+                "agfm",
+                LSP_VST3_UID("agf1m   agfm"),
+                LSP_VST3UI_UID("agf1m   agfm"),
+                LSP_LADSPA_AUTOGAIN_BASE + 6,
+                LSP_LADSPA_URI("autogain_follower_mono"),
+                LSP_CLAP_URI("autogain_follower_mono"),
+                LSP_GST_UID("autogain_follower_mono"),
+            },
+            LSP_PLUGINS_AUTOGAIN_VERSION,
+            follower_classes,
+            clap_features_mono,
+            E_DUMP_STATE,
+            autogain_follower_mono_ports,
+            "plugins/util/autogain_follower.xml",
+            NULL,
+            mono_plugin_port_groups,
+            &autogain_bundle,
+            7
+        };
+        LSP_REGISTER_METADATA(autogain_follower_mono);
+
+        const plugin_t autogain_follower_stereo =
+        {
+            "Autogain Follower Stereo",
+            "Autogain Follower Stereo",
+            "Autogain Follower Stereo",
+            "AGF1S",
+            &developers::v_sadovnikov,
+            "autogain_follower_stereo",
+            {
+                LSP_LV2_URI("autogain_follower_stereo"),
+                LSP_LV2UI_URI("autogain_follower_stereo"),
+                "agfs",
+                LSP_VST3_UID("agf1s   agfs"),
+                LSP_VST3UI_UID("agf1s   agfs"),
+                LSP_LADSPA_AUTOGAIN_BASE + 7,
+                LSP_LADSPA_URI("autogain_follower_stereo"),
+                LSP_CLAP_URI("autogain_follower_stereo"),
+                LSP_GST_UID("autogain_follower_stereo"),
+            },
+            LSP_PLUGINS_AUTOGAIN_VERSION,
+            follower_classes,
+            clap_features_stereo,
+            E_DUMP_STATE,
+            autogain_follower_stereo_ports,
+            "plugins/util/autogain_follower.xml",
+            NULL,
+            stereo_plugin_port_groups,
+            &autogain_bundle,
+            8
+        };
+        LSP_REGISTER_METADATA(autogain_follower_stereo);
+
     } /* namespace meta */
 } /* namespace lsp */
@@ -23,6 +23,7 @@
 #include <lsp-plug.in/common/debug.h>
 #include <lsp-plug.in/dsp/dsp.h>
 #include <lsp-plug.in/dsp-units/units.h>
+#include <lsp-plug.in/ipc/IExecutor.h>
 #include <lsp-plug.in/plug-fw/core/AudioBuffer.h>
 #include <lsp-plug.in/plug-fw/meta/func.h>
 #include <lsp-plug.in/shared/id_colors.h>
@@ -30,6 +31,10 @@
 
 #include <private/plugins/autogain.h>
 
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
 namespace lsp
 {
     namespace plugins
@@ -37,6 +42,79 @@ namespace lsp
         /* The size of temporary buffer for audio processing */
         static constexpr size_t BUFFER_SIZE         = 0x400;
 
+        static_assert(meta::autogain::DSP_LOAD_BUCKETS == LoadMeter::BUCKETS, "Invalid number of DSP load histogram buckets");
+
+        /* The number of records in the telemetry ring */
+        static constexpr size_t TELEMETRY_RECORDS   = 0x400;
+
+        /* The interval of meters, meshes and telemetry output in milliseconds */
+        static constexpr float OUTPUT_INTERVAL      = 10.0f;
+
+        /* The number of events in the trace ring */
+        static constexpr size_t TRACE_EVENTS        = 0x2000;
+        static constexpr size_t CAPTURE_RECORDS     = 0x4000;
+
+        /* Names of the processing stages, the last one covers the whole process() call */
+        static const char * const stage_names[] =
+        {
+            "other",
+            "measure_input_loudness",
+            "compute_gain_correction",
+            "apply_gain_correction",
+            "update_audio_buffers",
+            "output_mesh_data",
+            "process"
+        };
+
+        /* Decimation factors of the history levels: 20 s, 2 min, 10 min, 1 hour, 6 hours, 24 hours */
+        static const size_t history_factors[] = { 5, 6, 5, 6, 6, 4 };
+
+        static_assert(sizeof(history_factors)/sizeof(history_factors[0]) == meta::autogain::HISTORY_LEVELS, "Invalid number of history levels");
+
+        /* EBU R128 integrated loudness and loudness range measurement, periods in milliseconds */
+        static constexpr float INT_MOMENTARY_PERIOD = 400.0f;   // Momentary loudness period
+        static constexpr float INT_SHORT_PERIOD     = 3000.0f;  // Short-term loudness period
+        static constexpr float INT_BLOCK_INTERVAL   = 100.0f;   // Interval between measurement blocks (75% overlap)
+        static constexpr float INT_RELATIVE_GATE    = -10.0f;   // Relative gate for integrated loudness, LU
+        static constexpr float LRA_RELATIVE_GATE    = -20.0f;   // Relative gate for loudness range, LU
+        static constexpr float LRA_LOW_PERCENTILE   = 0.10f;    // Lower percentile of the loudness range
+        static constexpr float LRA_HIGH_PERCENTILE  = 0.95f;    // Upper percentile of the loudness range
+
+        /* Number of sidechain modes */
+        static constexpr size_t SCMODE_TOTAL        = meta::autogain::SCMODE_MATCH_LINK + 1;
+
+        /* Check that the sidechain mode takes the desired loudness level from the sidechain */
+        static constexpr bool is_match_mode(size_t mode)
+        {
+            return (mode == meta::autogain::SCMODE_MATCH_SC) || (mode == meta::autogain::SCMODE_MATCH_LINK);
+        }
+
+        /* Minimum sample rate of the decimated loudness metering */
+        static constexpr size_t DECIM_RATE_MIN      = 44100;
+
+        /* Maximum measurement periods of the decimated loudness meters */
+        static const float decim_meter_periods[] =
+        {
+            meta::autogain::LONG_PERIOD_MAX,    // DM_L_IN
+            meta::autogain::SHORT_PERIOD_MAX,   // DM_S_IN
+            meta::autogain::LONG_PERIOD_MAX,    // DM_L_SC
+            meta::autogain::SHORT_PERIOD_MAX,   // DM_S_SC
+            meta::autogain::LONG_PERIOD_MAX,    // DM_L_OUT
+            meta::autogain::SHORT_PERIOD_MAX,   // DM_S_OUT
+            INT_MOMENTARY_PERIOD,               // DM_M_OUT
+            INT_SHORT_PERIOD                    // DM_T_OUT
+        };
+
+        /* The number of history graph points per history log record, about 100 ms */
+        static constexpr size_t HISTORY_LOG_DOTS    = 16;
+
+        /* The number of records in the history log rings */
+        static constexpr size_t HISTORY_LOG_QUEUE   = 0x100;
+        static constexpr size_t HISTORY_REPLAY_QUEUE= 0x400;
+
+        /* The maximum number of history log records replayed per one output interval */
+        static constexpr size_t HISTORY_REPLAY_BATCH= 0x100;
+
         /* Gain numerators multiplied by 10 */
         static const uint8_t gain_numerators[] = { 1, 5, 10, 30, 60, 90, 100, 120, 150, 180, 200, 210, 240 };
 
@@ -47,7 +125,9 @@ namespace lsp
             &meta::autogain_mono,
             &meta::autogain_stereo,
             &meta::sc_autogain_mono,
-            &meta::sc_autogain_stereo
+            &meta::sc_autogain_stereo,
+            &meta::autogain_env_mono,
+            &meta::autogain_env_stereo
         };
 
         static plug::Module *plugin_factory(const meta::plugin_t *meta)
@@ -55,20 +135,97 @@ namespace lsp
             return new autogain(meta);
         }
 
-        static plug::Factory factory(plugin_factory, plugins, 4);
+        static plug::Factory factory(plugin_factory, plugins, 6);
 
         //---------------------------------------------------------------------
         // Implementation
         autogain::autogain(const meta::plugin_t *meta):
-            Module(meta)
+            Module(meta),
+            sTelemetryWriter(&sTelemetry),
+            sTraceWriter(&sTrace, TRACE_EVENTS, stage_names, PS_TOTAL + 1),
+            sCaptureWriter(&sCapture, CAPTURE_RECORDS),
+            sHLog(&sHLogOut, &sHLogIn)
         {
             // Compute the number of audio channels by the number of inputs
             nChannels       = 0;
             enScMode        = meta::autogain::SCMODE_INTERNAL;
+            pMeasureLoudness= NULL;
+            pComputeGain    = NULL;
             bSidechain      = false;
+            bGainEnv        = false;
+            bTelemetry      = false;
+            bTlmAccepted    = false;
+            bCeiling        = false;
+            bDecimate       = false;
+            bTrace          = false;
+            bTraceAccepted  = false;
+            bCaptureAccepted= false;
+            bCapture        = false;
+            bCaptureSync    = true;
+            nCapturePorts   = 0;
+            vCapturePorts   = NULL;
+            vCaptureValues  = NULL;
+            nTlmPosition    = 0;
+            nTraceProcess   = 0;
+            nTraceStage     = 0;
+            nIDisplayPeriod = 0;
+            nIDisplayCounter= 0;
+            bIDisplayDraw   = true;
+            nOutputPeriod   = 1;
+            nOutputCounter  = 0;
+            nGraphPeriod    = 1;
+            nGraphCounter   = 0;
+            nGraphPoints    = 0;
+            nGraphResets    = 0;
+            for (size_t i=0; i<IDG_BUFFERS; ++i)
+            {
+                idisplay_graph_t *g = &vIDGraph[i];
+                g->vData        = NULL;
+                g->nPoints      = 0;
+                g->nResets      = 0;
+            }
+            nIDShared       = 1;
+            nIDBack         = 0;
+            nIDFront        = 2;
+            nIDGraphPoints  = 0;
+            nIDGraphResets  = 0;
+            for (size_t i=0; i<GM_TOTAL; ++i)
+            {
+                mesh_sync_t *ms = &vMeshSync[i];
+                ms->nPoints     = 0;
+                ms->bXAxis      = false;
+            }
+            nHistoryZoom    = 0;
+            bHLog           = false;
+            bHLogAccepted   = false;
+            bHLogReplay     = false;
+            vHistory        = &vHistoryData[0];
+            vHReplay        = &vHistoryData[GM_TOTAL];
+            nHLogPoints     = 0;
+            nHLogLive       = 0;
+            nHLogTime       = 0;
+            for (size_t i=0; i<HISTORY_LOG_VALUES; ++i)
+                vHLogValues[i]  = 0.0f;
+            nIntPeriod      = 1;
+            nIntCounter     = 0;
+            bIntUpdate      = true;
+            nDecimStages    = 0;
+            nDecimFactor    = 1;
+            nDecimPhase     = 0;
+            nDecimCount     = 0;
+            for (size_t i=0; i<DM_TOTAL; ++i)
+                vDecimHold[i]   = 0.0f;
             for (const meta::port_t *p = meta->ports; p->id != NULL; ++p)
-                if (meta::is_audio_out_port(p))
+            {
+                if (!meta::is_audio_out_port(p))
+                    continue;
+
+                // The gain envelope output is not an audio channel
+                if (!strcmp(p->id, "genv"))
+                    bGainEnv        = true;
+                else
                     ++nChannels;
+            }
 
             if ((!strcmp(meta->uid, meta::sc_autogain_mono.uid)) ||
                 (!strcmp(meta->uid, meta::sc_autogain_stereo.uid)))
@@ -84,6 +241,8 @@ namespace lsp
             fLScGain        = 0.0f;
             fSScGain        = 0.0f;
             fGain           = 0.0f;
+            fIntLoudness    = meta::autogain::INTEGRATED_DFL;
+            fLoudnessRange  = meta::autogain::LRA_DFL;
             fOldLevel       = dspu::db_to_gain(meta::autogain::LEVEL_DFL);
             fLevel          = dspu::db_to_gain(meta::autogain::LEVEL_DFL);
             fOldPreamp      = 0.0f;
@@ -92,10 +251,13 @@ namespace lsp
             vLBuffer        = NULL;
             vSBuffer        = NULL;
             vGainBuffer     = NULL;
+            vGainEnv        = NULL;
             vEmptyBuffer    = NULL;
+            vDecimBuffer    = NULL;
+            vEnvBuffer      = NULL;
             vTimePoints     = NULL;
-            vIDisplay       = NULL;
 
+            pGainEnv        = NULL;
             pBypass         = NULL;
             pScMode         = NULL;
             pScPreamp       = NULL;
@@ -131,10 +293,34 @@ namespace lsp
             pLScGraph       = NULL;
             pSScGraph       = NULL;
             pGainGraph      = NULL;
+            pCeilingOn      = NULL;
+            pCeiling        = NULL;
+            pDecimate       = NULL;
+            pTlmOn          = NULL;
+            pTlmFile        = NULL;
+            pTraceFile      = NULL;
+            pCaptureFile    = NULL;
+            pIDisplayRate   = NULL;
+            pHistoryZoom    = NULL;
+            pHLogOn         = NULL;
+            pHLogFile       = NULL;
+            pIntLoudness    = NULL;
+            pLoudnessRange  = NULL;
+            pIntReset       = NULL;
+            pDspLoad        = NULL;
+            pDspPeak        = NULL;
+            pDspReset       = NULL;
+            pDspHist        = NULL;
+
+        #ifdef LSP_AUTOGAIN_PROFILE
+            for (size_t i=0; i<PS_TOTAL; ++i)
+                vProfile[i]     = NULL;
+        #endif /* LSP_AUTOGAIN_PROFILE */
 
             pIDisplay       = NULL;
 
             pData           = NULL;
+            pCaptureData    = NULL;
         }
 
         autogain::~autogain()
@@ -158,10 +344,13 @@ namespace lsp
                 szof_buffer +       // vSBuffer
                 szof_buffer +       // vGainBuffer
                 szof_buffer +       // vEmptyBuffer
+                szof_buffer +       // vDecimBuffer
+                szof_buffer +       // vEnvBuffer
                 szof_graph +        // vTimePoints
-                szof_graph +        // vIDisplay
+                szof_graph * IDG_BUFFERS + // vIDGraph
                 nChannels * (
-                    szof_buffer     // vBuffer
+                    szof_buffer +   // vBuffer
+                    szof_buffer     // vDry
                 );
 
             // Allocate memory-aligned data
@@ -181,8 +370,42 @@ namespace lsp
                 return;
             if ((res = sSScMeter.init(nChannels, meta::autogain::SHORT_PERIOD_MAX)) != STATUS_OK)
                 return;
+            if ((res = sMOutMeter.init(nChannels, INT_MOMENTARY_PERIOD)) != STATUS_OK)
+                return;
+            if ((res = sTOutMeter.init(nChannels, INT_SHORT_PERIOD)) != STATUS_OK)
+                return;
+            for (size_t i=0; i<DM_TOTAL; ++i)
+            {
+                if ((res = vDecimMeters[i].init(nChannels, decim_meter_periods[i])) != STATUS_OK)
+                    return;
+            }
+            if ((res = sInDecim.init(nChannels, BUFFER_SIZE)) != STATUS_OK)
+                return;
+            if ((res = sScDecim.init(nChannels, BUFFER_SIZE)) != STATUS_OK)
+                return;
+            if ((res = sOutDecim.init(nChannels, BUFFER_SIZE)) != STATUS_OK)
+                return;
             if ((res = sAutoGain.init()) != STATUS_OK)
                 return;
+            if ((res = sTelemetry.init(TELEMETRY_RECORDS)) != STATUS_OK)
+                return;
+        #ifdef LSP_AUTOGAIN_PROFILE
+            if ((res = sProfiler.init()) != STATUS_OK)
+                return;
+        #endif /* LSP_AUTOGAIN_PROFILE */
+            for (size_t i=0; i<GM_TOTAL*2; ++i)
+            {
+                if ((res = vHistoryData[i].init(meta::autogain::MESH_POINTS, history_factors, meta::autogain::HISTORY_LEVELS)) != STATUS_OK)
+                    return;
+            }
+            if ((res = sHLogOut.init(HISTORY_LOG_QUEUE)) != STATUS_OK)
+                return;
+            if ((res = sHLogIn.init(HISTORY_REPLAY_QUEUE)) != STATUS_OK)
+                return;
+        #ifdef LSP_TESTING
+            init_generator();
+        #endif /* LSP_TESTING */
+            init_capture(ports);
 
             // Initialize pointers to channels and temporary buffer
             vChannels               = advance_ptr_bytes<channel_t>(ptr, szof_channels);
@@ -190,8 +413,14 @@ namespace lsp
             vSBuffer                = advance_ptr_bytes<float>(ptr, szof_buffer);
             vGainBuffer             = advance_ptr_bytes<float>(ptr, szof_buffer);
             vEmptyBuffer            = advance_ptr_bytes<float>(ptr, szof_buffer);
+            vDecimBuffer            = advance_ptr_bytes<float>(ptr, szof_buffer);
+            vEnvBuffer              = advance_ptr_bytes<float>(ptr, szof_buffer);
             vTimePoints             = advance_ptr_bytes<float>(ptr, szof_graph);
-            vIDisplay               = advance_ptr_bytes<float>(ptr, szof_graph);
+            for (size_t i=0; i<IDG_BUFFERS; ++i)
+            {
+                vIDGraph[i].vData       = advance_ptr_bytes<float>(ptr, szof_graph);
+                dsp::fill_zero(vIDGraph[i].vData, meta::autogain::MESH_POINTS);
+            }
 
             for (size_t i=0; i < nChannels; ++i)
             {
@@ -199,12 +428,15 @@ namespace lsp
 
                 c->sBypass.construct();
                 c->sDelay.construct();
+                c->sDryDelay.construct();
 
                 c->vIn                  = NULL;
                 c->vScIn                = NULL;
+                c->vShmIn               = NULL;
                 c->vOut                 = NULL;
 
                 c->vBuffer              = advance_ptr_bytes<float>(ptr, szof_buffer);
+                c->vDry                 = advance_ptr_bytes<float>(ptr, szof_buffer);
 
                 c->pIn                  = NULL;
                 c->pScIn                = NULL;
@@ -212,6 +444,8 @@ namespace lsp
                 c->pOut                 = NULL;
             }
 
+            select_kernels();
+
             // Bind ports
             lsp_trace("Binding ports");
             size_t port_id      = 0;
@@ -231,6 +465,10 @@ namespace lsp
                     BIND_PORT(vChannels[i].pScIn);
             }
 
+            // Bind gain envelope output
+            if (bGainEnv)
+                BIND_PORT(pGainEnv);
+
             // Bind bypass
             BIND_PORT(pBypass);
 
@@ -289,6 +527,46 @@ namespace lsp
             BIND_PORT(pSOutGraph);
             BIND_PORT(pGainGraph);
 
+            lsp_trace("Binding true peak ceiling controls");
+            BIND_PORT(pCeilingOn);
+            BIND_PORT(pCeiling);
+
+            lsp_trace("Binding decimation controls");
+            BIND_PORT(pDecimate);
+
+            lsp_trace("Binding telemetry controls");
+            BIND_PORT(pTlmOn);
+            BIND_PORT(pTlmFile);
+
+            lsp_trace("Binding diagnostics controls");
+            BIND_PORT(pTraceFile);
+            BIND_PORT(pCaptureFile);
+
+            lsp_trace("Binding inline display controls");
+            BIND_PORT(pIDisplayRate);
+
+            lsp_trace("Binding history controls");
+            BIND_PORT(pHistoryZoom);
+            BIND_PORT(pHLogOn);
+            BIND_PORT(pHLogFile);
+
+            lsp_trace("Binding integrated loudness ports");
+            BIND_PORT(pIntLoudness);
+            BIND_PORT(pLoudnessRange);
+            BIND_PORT(pIntReset);
+
+            lsp_trace("Binding DSP load ports");
+            BIND_PORT(pDspLoad);
+            BIND_PORT(pDspPeak);
+            BIND_PORT(pDspReset);
+            BIND_PORT(pDspHist);
+
+        #ifdef LSP_AUTOGAIN_PROFILE
+            lsp_trace("Binding profiling ports");
+            for (size_t i=0; i<PS_TOTAL; ++i)
+                BIND_PORT(vProfile[i]);
+        #endif /* LSP_AUTOGAIN_PROFILE */
+
             // Fill values
             dsp::fill_zero(vEmptyBuffer, BUFFER_SIZE);
 
@@ -312,6 +590,11 @@ namespace lsp
             sLScGraph.destroy();
             sSScGraph.destroy();
             sGainGraph.destroy();
+            for (size_t i=0; i<GM_TOTAL*2; ++i)
+                vHistoryData[i].destroy();
+            sHLog.close();
+            sHLogOut.destroy();
+            sHLogIn.destroy();
 
             sLInMeter.destroy();
             sSInMeter.destroy();
@@ -319,8 +602,40 @@ namespace lsp
             sSOutMeter.destroy();
             sLScMeter.destroy();
             sSScMeter.destroy();
+            sMOutMeter.destroy();
+            sTOutMeter.destroy();
+            for (size_t i=0; i<DM_TOTAL; ++i)
+                vDecimMeters[i].destroy();
 
             sAutoGain.destroy();
+            sCeiling.destroy();
+            sInDecim.destroy();
+            sScDecim.destroy();
+            sOutDecim.destroy();
+            sTelemetryWriter.close();
+            sTelemetry.destroy();
+            sTraceWriter.close();
+            sTrace.destroy();
+            bTrace          = false;
+        #ifdef LSP_TESTING
+            sGenerator.destroy();
+        #endif /* LSP_TESTING */
+            sCaptureWriter.close();
+            sCapture.destroy();
+            bCapture        = false;
+            nCapturePorts   = 0;
+            vCapturePorts   = NULL;
+            vCaptureValues  = NULL;
+            if (pCaptureData != NULL)
+            {
+                free_aligned(pCaptureData);
+                pCaptureData    = NULL;
+            }
+            sIDBackground.destroy();
+            sIDGain.destroy();
+        #ifdef LSP_AUTOGAIN_PROFILE
+            sProfiler.destroy();
+        #endif /* LSP_AUTOGAIN_PROFILE */
 
             // Destroy channels
             if (vChannels != NULL)
@@ -329,6 +644,7 @@ namespace lsp
                 {
                     channel_t *c    = &vChannels[i];
                     c->sDelay.destroy();
+                    c->sDryDelay.destroy();
                     c->sBypass.destroy();
                 }
                 vChannels   = NULL;
@@ -349,8 +665,75 @@ namespace lsp
             }
         }
 
+    #ifdef LSP_TESTING
+        void autogain::init_generator()
+        {
+            // Hosts have no way to pass test options to the plugin, so the test build also reads
+            // the scenario from the environment. Tests should select it per instance by set_generator().
+            // The generator is not exposed as a port: the port list should stay the same for test and
+            // release builds, otherwise presets and session captures become incompatible between them.
+            const char *name    = getenv("LSP_AUTOGAIN_GENERATOR");
+            if ((name == NULL) || (name[0] == '\0'))
+                return;
+
+            SignalGenerator::scenario_t scenario = SignalGenerator::parse(name);
+            if (scenario == SignalGenerator::SG_NONE)
+            {
+                lsp_warn("Unknown signal generator scenario: %s", name);
+                return;
+            }
+
+            if (set_generator(scenario) == STATUS_OK)
+                lsp_info("Replacing input signal of %s instance with the '%s' scenario", pMetadata->uid, name);
+        }
+
+        status_t autogain::set_generator(SignalGenerator::scenario_t scenario)
+        {
+            if (scenario == SignalGenerator::SG_NONE)
+            {
+                sGenerator.destroy();
+                return STATUS_OK;
+            }
+
+            status_t res = sGenerator.init(scenario, BUFFER_SIZE);
+            if (res != STATUS_OK)
+                return res;
+            if (fSampleRate > 0)
+                sGenerator.set_sample_rate(fSampleRate);
+
+            return STATUS_OK;
+        }
+    #endif /* LSP_TESTING */
+
+        void autogain::init_capture(plug::IPort **ports)
+        {
+            // Collect input control ports, the port index in the capture file is the index in metadata
+            size_t count        = 0;
+            for (const meta::port_t *p = pMetadata->ports; p->id != NULL; ++p)
+                ++count;
+
+            size_t szof_ports   = align_size(sizeof(plug::IPort *) * count, DEFAULT_ALIGN);
+            size_t szof_values  = align_size(sizeof(float) * count, DEFAULT_ALIGN);
+            uint8_t *ptr        = alloc_aligned<uint8_t>(pCaptureData, szof_ports + szof_values, DEFAULT_ALIGN);
+            if (ptr == NULL)
+                return;
+
+            vCapturePorts       = advance_ptr_bytes<plug::IPort *>(ptr, szof_ports);
+            vCaptureValues      = advance_ptr_bytes<float>(ptr, szof_values);
+            for (size_t i=0; i<count; ++i)
+            {
+                const meta::port_t *p   = &pMetadata->ports[i];
+                vCapturePorts[i]        = ((p->role == meta::R_CONTROL) && (meta::is_in_port(p))) ? ports[i] : NULL;
+                vCaptureValues[i]       = 0.0f;
+            }
+            nCapturePorts       = count;
+        }
+
         void autogain::update_sample_rate(long sr)
         {
+            if (bCapture)
+                capture_record(CR_SAMPLE_RATE, 0, uint32_t(sr), NULL, 0);
+
             size_t samples_per_dot  = dspu::seconds_to_samples(
                 sr, meta::autogain::MESH_TIME / meta::autogain::MESH_POINTS);
 
@@ -361,6 +744,29 @@ namespace lsp
             sLScGraph.init(meta::autogain::MESH_POINTS, samples_per_dot);
             sSScGraph.init(meta::autogain::MESH_POINTS, samples_per_dot);
             sGainGraph.init(meta::autogain::MESH_POINTS, samples_per_dot);
+            for (size_t i=0; i<GM_TOTAL*2; ++i)
+                vHistoryData[i].set_period(samples_per_dot);
+
+            // The graphs have been cleared, force the meshes to be transferred completely and
+            // pass the reset to the inline display with the next snapshot of the gain graph
+            nGraphPeriod            = lsp_max(samples_per_dot, 1U);
+            nGraphCounter           = 0;
+            ++nGraphResets;
+            for (size_t i=0; i<GM_TOTAL; ++i)
+                vMeshSync[i].bXAxis     = false;
+
+            // Start the new history log record
+            nHLogPoints             = nGraphPoints;
+            nHLogLive               = nGraphPoints;
+            for (size_t i=0; i<HISTORY_LOG_VALUES; ++i)
+                vHLogValues[i]          = 0.0f;
+
+            // The meters of both the original and the decimated signal are configured here because
+            // changing the sample rate of the meter may re-allocate memory, update_settings() only
+            // switches between them
+            nDecimStages            = 0;
+            while ((nDecimStages < MeterDecimator::STAGES_MAX) && ((size_t(sr) >> (nDecimStages + 1)) >= DECIM_RATE_MIN))
+                ++nDecimStages;
 
             sLInMeter.set_sample_rate(sr);
             sSInMeter.set_sample_rate(sr);
@@ -368,16 +774,37 @@ namespace lsp
             sSOutMeter.set_sample_rate(sr);
             sLScMeter.set_sample_rate(sr);
             sSScMeter.set_sample_rate(sr);
+            sMOutMeter.set_sample_rate(sr);
+            sTOutMeter.set_sample_rate(sr);
+            if (nDecimStages > 0)
+            {
+                for (size_t i=0; i<DM_TOTAL; ++i)
+                    vDecimMeters[i].set_sample_rate(size_t(sr) >> nDecimStages);
+            }
+            update_decimation();
 
             sAutoGain.set_sample_rate(sr);
+            sLoadMeter.set_sample_rate(sr);
+        #ifdef LSP_TESTING
+            sGenerator.set_sample_rate(sr);
+        #endif /* LSP_TESTING */
+
+            nOutputPeriod           = lsp_max(dspu::millis_to_samples(sr, OUTPUT_INTERVAL), 1U);
+            nOutputCounter          = 0;
+            nIntPeriod              = lsp_max(dspu::millis_to_samples(sr, INT_BLOCK_INTERVAL), 1U);
+            nIntCounter             = 0;
 
             size_t max_delay = dspu::millis_to_samples(sr, meta::autogain::SC_LOOKAHEAD_MAX);
 
+            sCeiling.init(nChannels, BUFFER_SIZE, max_delay);
+            max_delay       += TruePeakCeiling::LATENCY;
+
             // Update sample rate for the bypass processors
             for (size_t i=0; i<nChannels; ++i)
             {
                 channel_t *c    = &vChannels[i];
                 c->sDelay.init(max_delay);
+                c->sDryDelay.init(max_delay);
                 c->sBypass.init(sr);
             }
         }
@@ -441,15 +868,50 @@ namespace lsp
 
         void autogain::update_settings()
         {
+            uint64_t start                  = monotonic_nanos();
             bool bypass                     = pBypass->value() >= 0.5f;
             dspu::bs::weighting_t weight    = decode_weighting(pWeighting->value());
 
             // Update level
             fLevel                          = dspu::db_to_gain(pLevel->value());
-            enScMode                        = decode_sidechain_mode(pScMode->value());
+            nIDisplayPeriod                 = fSampleRate / lsp_max(pIDisplayRate->value(), meta::autogain::IDISPLAY_RATE_MIN);
+            bIDisplayDraw                   = true;
+
+            // Force the transfer of meshes if the history zoom has changed
+            size_t zoom                     = lsp_limit(size_t(pHistoryZoom->value()), 0U, meta::autogain::HISTORY_LEVELS);
+            if (zoom != nHistoryZoom)
+            {
+                nHistoryZoom                    = zoom;
+                for (size_t i=0; i<GM_TOTAL; ++i)
+                    vMeshSync[i].bXAxis             = false;
+            }
+            const size_t sc_mode            = decode_sidechain_mode(pScMode->value());
+            if (sc_mode != enScMode)
+            {
+                enScMode                        = sc_mode;
+                select_kernels();
+            }
             fPreamp                         = dspu::db_to_gain(pScPreamp->value());
             size_t lookahead                = dspu::millis_to_samples(fSampleRate, pLookahead->value());
 
+            // The true peak ceiling looks ahead for the whole delay of the signal,
+            // the signal is additionally delayed by the latency of the true peak estimation
+            const bool decimate             = pDecimate->value() >= 0.5f;
+            if (decimate != bDecimate)
+            {
+                bDecimate                       = decimate;
+                update_decimation();
+            }
+
+            const bool ceiling              = pCeilingOn->value() >= 0.5f;
+            if ((ceiling) && (!bCeiling))
+                sCeiling.clear();
+            bCeiling                        = ceiling;
+            sCeiling.set_ceiling(dspu::db_to_gain(pCeiling->value()));
+            sCeiling.set_lookahead(lookahead);
+            if (bCeiling)
+                lookahead                       = sCeiling.latency();
+
             // Configure autogain
             sAutoGain.set_deviation(
                 dspu::db_to_gain(pDeviation->value()));
@@ -485,6 +947,12 @@ namespace lsp
             sLScMeter.set_weighting(weight);
             sSScMeter.set_weighting(weight);
 
+            // The integrated loudness and loudness range are always measured as specified by EBU R128
+            sMOutMeter.set_period(INT_MOMENTARY_PERIOD);
+            sTOutMeter.set_period(INT_SHORT_PERIOD);
+            sMOutMeter.set_weighting(dspu::bs::WEIGHT_K);
+            sTOutMeter.set_weighting(dspu::bs::WEIGHT_K);
+
             if (nChannels > 1)
             {
                 sLInMeter.set_designation(0, dspu::bs::CHANNEL_LEFT);
@@ -501,6 +969,11 @@ namespace lsp
                 sLScMeter.set_designation(1, dspu::bs::CHANNEL_RIGHT);
                 sSScMeter.set_designation(0, dspu::bs::CHANNEL_LEFT);
                 sSScMeter.set_designation(1, dspu::bs::CHANNEL_RIGHT);
+
+                sMOutMeter.set_designation(0, dspu::bs::CHANNEL_LEFT);
+                sMOutMeter.set_designation(1, dspu::bs::CHANNEL_RIGHT);
+                sTOutMeter.set_designation(0, dspu::bs::CHANNEL_LEFT);
+                sTOutMeter.set_designation(1, dspu::bs::CHANNEL_RIGHT);
             }
             else
             {
@@ -512,6 +985,9 @@ namespace lsp
 
                 sLScMeter.set_designation(0, dspu::bs::CHANNEL_CENTER);
                 sSScMeter.set_designation(0, dspu::bs::CHANNEL_CENTER);
+
+                sMOutMeter.set_designation(0, dspu::bs::CHANNEL_CENTER);
+                sTOutMeter.set_designation(0, dspu::bs::CHANNEL_CENTER);
             }
 
             for (size_t i=0; i<nChannels; ++i)
@@ -530,6 +1006,47 @@ namespace lsp
                 sLScMeter.set_active(i, true);
                 sSScMeter.set_link(i, 1.0f);
                 sSScMeter.set_active(i, true);
+
+                sMOutMeter.set_link(i, 1.0f);
+                sMOutMeter.set_active(i, true);
+                sTOutMeter.set_link(i, 1.0f);
+                sTOutMeter.set_active(i, true);
+            }
+
+            // The meters of the decimated signal mirror the configuration of the meters above
+            for (size_t i=0; i<DM_TOTAL; ++i)
+            {
+                dspu::LoudnessMeter *m      = &vDecimMeters[i];
+                switch (i)
+                {
+                    case DM_L_IN: case DM_L_SC: case DM_L_OUT:
+                        m->set_period(l_period);
+                        m->set_weighting(weight);
+                        break;
+                    case DM_S_IN: case DM_S_SC: case DM_S_OUT:
+                        m->set_period(s_period);
+                        m->set_weighting(weight);
+                        break;
+                    case DM_M_OUT:
+                        m->set_period(INT_MOMENTARY_PERIOD);
+                        m->set_weighting(dspu::bs::WEIGHT_K);
+                        break;
+                    case DM_T_OUT:
+                        m->set_period(INT_SHORT_PERIOD);
+                        m->set_weighting(dspu::bs::WEIGHT_K);
+                        break;
+                    default:
+                        break;
+                }
+
+                for (size_t j=0; j<nChannels; ++j)
+                {
+                    m->set_designation(j,
+                        (nChannels <= 1) ? dspu::bs::CHANNEL_CENTER :
+                        (j == 0) ? dspu::bs::CHANNEL_LEFT : dspu::bs::CHANNEL_RIGHT);
+                    m->set_link(j, 1.0f);
+                    m->set_active(j, true);
+                }
             }
 
             // Update bypass
@@ -537,40 +1054,138 @@ namespace lsp
             {
                 channel_t *c            = &vChannels[i];
                 c->sDelay.set_delay(lookahead);
+                c->sDryDelay.set_delay(lookahead);
                 c->sBypass.set_bypass(bypass);
             }
 
+            bTelemetry                      = pTlmOn->value() >= 0.5f;
+            bHLog                           = pHLogOn->value() >= 0.5f;
+            if (pDspReset->value() >= 0.5f)
+                sLoadMeter.reset();
+            if (pIntReset->value() >= 0.5f)
+            {
+                sIntHist.clear();
+                sLraHist.clear();
+                bIntUpdate                      = true;
+            }
+
             // Report latency
             set_latency(lookahead);
+            if (bCapture)
+                capture_params();
+
+            // Account time spent for updating settings as a part of the next block
+            sLoadMeter.account(start);
+        }
+
+        void autogain::begin_stages()
+        {
+            AUTOGAIN_PROFILE_BEGIN(sProfiler);
+            if (bTrace)
+            {
+                nTraceProcess   = monotonic_nanos();
+                nTraceStage     = nTraceProcess;
+            }
+        }
+
+        void autogain::end_stage(profile_stage_t stage, size_t samples)
+        {
+            AUTOGAIN_PROFILE_END(sProfiler, stage, samples);
+            if (bTrace)
+            {
+                uint64_t time   = monotonic_nanos();
+                trace_event(stage, nTraceStage, time, samples);
+                nTraceStage     = time;
+            }
+        }
+
+        void autogain::trace_event(size_t stage, uint64_t start, uint64_t end, size_t samples)
+        {
+            trace_event_t ev;
+            ev.nStart       = start;
+            ev.nEnd         = end;
+            ev.nStage       = uint32_t(stage);
+            ev.nSamples     = uint32_t(samples);
+            ev.nMode        = uint32_t(enScMode);
+            ev.nThreadId    = trace_thread_id();
+
+            sTrace.push(&ev);
         }
 
         void autogain::process(size_t samples)
         {
+            sLoadMeter.begin();
+            begin_stages();
+
             bind_audio_ports();
-            clean_meters();
+            if (bCapture)
+                capture_block(samples);
+
+            end_stage(PS_OTHER, samples);
 
             for (size_t offset=0; offset < samples; )
             {
                 size_t to_do    = lsp_min(samples - offset, BUFFER_SIZE);
 
-                measure_input_loudness(to_do);
-                compute_gain_correction(to_do);
+            #ifdef LSP_TESTING
+                if (sGenerator.enabled())
+                    generate_signal(to_do);
+            #endif /* LSP_TESTING */
+                (this->*pMeasureLoudness)(to_do);
+                end_stage(PS_MEASURE, to_do);
+                (this->*pComputeGain)(to_do);
+                end_stage(PS_GAIN, to_do);
                 apply_gain_correction(to_do);
+                end_stage(PS_APPLY, to_do);
                 update_audio_buffers(to_do);
+                end_stage(PS_BUFFERS, to_do);
 
                 offset         += to_do;
             }
 
-            output_meters();
-            output_mesh_data();
+            // Meters, meshes and telemetry are published at the fixed rate independent
+            // of the block size, meters accumulate their values between publications
+            // Publications cover all samples since the previous one, so the mesh stage accounts
+            // the whole interval, the samples of the other stage are already accounted per block
+            nOutputCounter     += samples;
+            bool publish        = nOutputCounter >= nOutputPeriod;
+            if (publish)
+            {
+                const size_t interval   = nOutputCounter;
 
-            // Request for redraw
-            if (pWrapper != NULL)
-                pWrapper->query_display_draw();
+                output_meters();
+                end_stage(PS_OTHER, 0);
+                output_mesh_data();
+                output_idisplay_graph();
+                end_stage(PS_MESH, interval);
+                output_telemetry(interval);
+                output_history_log();
+
+                // Request for redraw
+                query_display_draw(interval);
+
+                clean_meters();
+                nOutputCounter      = 0;
+            }
+
+            end_stage(PS_OTHER, 0);
+            sLoadMeter.end(samples);
+
+            if (publish)
+            {
+                output_dsp_load();
+            #ifdef LSP_AUTOGAIN_PROFILE
+                output_profile();
+            #endif /* LSP_AUTOGAIN_PROFILE */
+            }
+            output_trace(samples);
+            output_capture();
         }
 
         void autogain::bind_audio_ports()
         {
+            vGainEnv        = (pGainEnv != NULL) ? pGainEnv->buffer<float>() : NULL;
+
             for (size_t i=0; i<nChannels; ++i)
             {
                 channel_t *c    = &vChannels[i];
@@ -598,168 +1213,359 @@ namespace lsp
             fGain           = 0.0f;
         }
 
-        const float *autogain::select_buffer(const channel_t *c) const
+    #ifdef LSP_TESTING
+        void autogain::generate_signal(size_t samples)
+        {
+            sGenerator.process(samples);
+
+            // All channels receive the same signal, pointers are re-assigned for each block
+            for (size_t i=0; i<nChannels; ++i)
+            {
+                channel_t *c    = &vChannels[i];
+                c->vIn          = sGenerator.signal();
+                c->vScIn        = sGenerator.sidechain();
+            }
+        }
+    #endif /* LSP_TESTING */
+
+        template <size_t SCMODE>
+        inline const float *autogain::select_buffer(const channel_t *c) const
+        {
+            if ((SCMODE == meta::autogain::SCMODE_CONTROL_SC) || (SCMODE == meta::autogain::SCMODE_MATCH_SC))
+                return (c->vScIn != NULL) ? c->vScIn : vEmptyBuffer;
+            if ((SCMODE == meta::autogain::SCMODE_CONTROL_LINK) || (SCMODE == meta::autogain::SCMODE_MATCH_LINK))
+                return (c->vShmIn != NULL) ? c->vShmIn : vEmptyBuffer;
+
+            return c->vIn;
+        }
+
+        void autogain::select_kernels()
         {
-            switch (enScMode)
+            // Kernels are specialized for the sidechain mode and the number of channels,
+            // the row with zero channels serves any number of channels
+            #define AUTOGAIN_KERNEL(channels, mode) \
+                { &autogain::measure_input_loudness<channels, mode>, &autogain::compute_gain_correction<mode> }
+            #define AUTOGAIN_KERNELS(channels) \
+                { \
+                    AUTOGAIN_KERNEL(channels, meta::autogain::SCMODE_INTERNAL), \
+                    AUTOGAIN_KERNEL(channels, meta::autogain::SCMODE_CONTROL_SC), \
+                    AUTOGAIN_KERNEL(channels, meta::autogain::SCMODE_MATCH_SC), \
+                    AUTOGAIN_KERNEL(channels, meta::autogain::SCMODE_CONTROL_LINK), \
+                    AUTOGAIN_KERNEL(channels, meta::autogain::SCMODE_MATCH_LINK) \
+                }
+
+            static const kernels_t kernels[][SCMODE_TOTAL] =
             {
-                case meta::autogain::SCMODE_CONTROL_SC:
-                case meta::autogain::SCMODE_MATCH_SC:
-                    return (c->vScIn != NULL) ? c->vScIn : vEmptyBuffer;
+                AUTOGAIN_KERNELS(0),
+                AUTOGAIN_KERNELS(1),
+                AUTOGAIN_KERNELS(2)
+            };
 
-                case meta::autogain::SCMODE_CONTROL_LINK:
-                case meta::autogain::SCMODE_MATCH_LINK:
-                    return (c->vShmIn != NULL) ? c->vShmIn : vEmptyBuffer;
+            #undef AUTOGAIN_KERNELS
+            #undef AUTOGAIN_KERNEL
 
-                case meta::autogain::SCMODE_INTERNAL:
-                    return c->vIn;
-                default:
-                    break;
+            const size_t row        = (nChannels < (sizeof(kernels) / sizeof(kernels[0]))) ? nChannels : 0;
+            const size_t mode       = (enScMode < SCMODE_TOTAL) ? enScMode : size_t(meta::autogain::SCMODE_INTERNAL);
+            const kernels_t *k      = &kernels[row][mode];
+
+            pMeasureLoudness        = k->pMeasure;
+            pComputeGain            = k->pGain;
+        }
+
+        void autogain::update_decimation()
+        {
+            // Decimate the analysis path to the lowest sample rate that is not below DECIM_RATE_MIN
+            const size_t stages = (bDecimate) ? nDecimStages : 0;
+
+            sInDecim.set_stages(stages);
+            sScDecim.set_stages(stages);
+            sOutDecim.set_stages(stages);
+            sInDecim.clear();
+            sScDecim.clear();
+            sOutDecim.clear();
+
+            nDecimFactor        = size_t(1) << stages;
+            nDecimPhase         = 0;
+            nDecimCount         = 0;
+            for (size_t i=0; i<DM_TOTAL; ++i)
+                vDecimHold[i]       = 0.0f;
+
+            // Meters that become active should not keep the data of the previous use
+            if (stages > 0)
+            {
+                for (size_t i=0; i<DM_TOTAL; ++i)
+                    vDecimMeters[i].clear();
+            }
+            else
+            {
+                sLInMeter.clear();
+                sSInMeter.clear();
+                sLOutMeter.clear();
+                sSOutMeter.clear();
+                sLScMeter.clear();
+                sSScMeter.clear();
+                sMOutMeter.clear();
+                sTOutMeter.clear();
             }
+        }
 
-            return c->vIn;
+        void autogain::bind_meter(dspu::LoudnessMeter *meter, decim_meter_t type, size_t channel, const float *data)
+        {
+            if (nDecimFactor > 1)
+                meter       = &vDecimMeters[type];
+            meter->bind(channel, NULL, data, 0);
+        }
+
+        void autogain::measure_loudness(dspu::LoudnessMeter *meter, decim_meter_t type, float *dst, size_t samples)
+        {
+            if (nDecimFactor <= 1)
+            {
+                meter->process(dst, samples, dspu::bs::DBFS_TO_LUFS_SHIFT_GAIN);
+                return;
+            }
+
+            // Measure the decimated signal and expand the result to the original sample rate,
+            // each decimated value is held until the next one is produced
+            float *hold         = &vDecimHold[type];
+            if (nDecimCount > 0)
+                vDecimMeters[type].process(vDecimBuffer, nDecimCount, dspu::bs::DBFS_TO_LUFS_SHIFT_GAIN);
+
+            const size_t head   = lsp_min(samples, nDecimFactor - 1 - nDecimPhase);
+            const float *src    = vDecimBuffer;
+            dsp::fill(dst, *hold, head);
+            for (size_t i=head; i<samples; i += nDecimFactor)
+                dsp::fill(&dst[i], *(src++), lsp_min(nDecimFactor, samples - i));
+
+            if (nDecimCount > 0)
+                *hold               = vDecimBuffer[nDecimCount - 1];
         }
 
+        template <size_t CHANNELS, size_t SCMODE>
         void autogain::measure_input_loudness(size_t samples)
         {
+            // Zero number of channels means that it is not known at compile time
+            const size_t channels   = (CHANNELS > 0) ? CHANNELS : nChannels;
+
             // Bind channels for analysis
-            for (size_t i=0; i<nChannels; ++i)
+            for (size_t i=0; i<channels; ++i)
             {
                 channel_t *c    = &vChannels[i];
 
-                sLInMeter.bind(i, NULL, c->vIn, 0);
-                sSInMeter.bind(i, NULL, c->vIn, 0);
+                const float *in         = c->vIn;
+                if (nDecimFactor > 1)
+                {
+                    nDecimCount             = sInDecim.process(i, in, samples);
+                    in                      = sInDecim.data(i);
+                }
+                bind_meter(&sLInMeter, DM_L_IN, i, in);
+                bind_meter(&sSInMeter, DM_S_IN, i, in);
 
                 // Process sidechain signal
-                const float *in_buf     = select_buffer(c);
+                const float *in_buf     = select_buffer<SCMODE>(c);
                 dsp::lramp2(c->vBuffer, in_buf, fOldPreamp, fPreamp, samples);
 
                 // Bind sidechain meters
-                sLScMeter.bind(i, NULL, c->vBuffer, 0);
-                sSScMeter.bind(i, NULL, c->vBuffer, 0);
+                const float *sc         = c->vBuffer;
+                if (nDecimFactor > 1)
+                {
+                    sScDecim.process(i, sc, samples);
+                    sc                      = sScDecim.data(i);
+                }
+                bind_meter(&sLScMeter, DM_L_SC, i, sc);
+                bind_meter(&sSScMeter, DM_S_SC, i, sc);
             }
             fOldPreamp  = fPreamp;
 
             // Depending on the operating mode, we need to change the order of processing input and sidechain signals
-            switch (enScMode)
-            {
-                case meta::autogain::SCMODE_MATCH_SC:
-                case meta::autogain::SCMODE_MATCH_LINK:
-                    // First process sidechain signal
-                    sLScMeter.process(vLBuffer, samples, dspu::bs::DBFS_TO_LUFS_SHIFT_GAIN);
-                    fLScGain    = lsp_max(fLInGain, dsp::max(vLBuffer, samples));
-                    sLScGraph.process(vLBuffer, samples);
-
-                    sSScMeter.process(vSBuffer, samples, dspu::bs::DBFS_TO_LUFS_SHIFT_GAIN);
-                    fSScGain    = lsp_max(fSInGain, dsp::max(vSBuffer, samples));
-                    sSScGraph.process(vSBuffer, samples);
-
-                    // Limit the long sidechain signal and put to the buffer
-                    dsp::limit2(
-                        vGainBuffer,
-                        vLBuffer,
-                        meta::autogain::LEVEL_GAIN_MIN,
-                        meta::autogain::LEVEL_GAIN_MAX,
-                        samples);
-
-                    // Then process input signal as usual
-                    sLInMeter.process(vLBuffer, samples, dspu::bs::DBFS_TO_LUFS_SHIFT_GAIN);
-                    fLInGain    = lsp_max(fLInGain, dsp::max(vLBuffer, samples));
-                    sLInGraph.process(vLBuffer, samples);
-
-                    sSInMeter.process(vSBuffer, samples, dspu::bs::DBFS_TO_LUFS_SHIFT_GAIN);
-                    fSInGain    = lsp_max(fSInGain, dsp::max(vSBuffer, samples));
-                    sSInGraph.process(vSBuffer, samples);
-
-                    break;
-
-                case meta::autogain::SCMODE_CONTROL_SC:
-                case meta::autogain::SCMODE_CONTROL_LINK:
-                case meta::autogain::SCMODE_INTERNAL:
-                default:
-                    // Process the loudnes of input signal
-                    sLInMeter.process(vLBuffer, samples, dspu::bs::DBFS_TO_LUFS_SHIFT_GAIN);
-                    fLInGain    = lsp_max(fLInGain, dsp::max(vLBuffer, samples));
-                    sLInGraph.process(vLBuffer, samples);
-
-                    sSInMeter.process(vSBuffer, samples, dspu::bs::DBFS_TO_LUFS_SHIFT_GAIN);
-                    fSInGain    = lsp_max(fSInGain, dsp::max(vSBuffer, samples));
-                    sSInGraph.process(vSBuffer, samples);
-
-                    // Process the loudness of sidechain signal
-                    sLScMeter.process(vLBuffer, samples, dspu::bs::DBFS_TO_LUFS_SHIFT_GAIN);
-                    fLScGain    = lsp_max(fLInGain, dsp::max(vLBuffer, samples));
-                    sLScGraph.process(vLBuffer, samples);
-
-                    sSScMeter.process(vSBuffer, samples, dspu::bs::DBFS_TO_LUFS_SHIFT_GAIN);
-                    fSScGain    = lsp_max(fSInGain, dsp::max(vSBuffer, samples));
-                    sSScGraph.process(vSBuffer, samples);
-                    break;
+            if (is_match_mode(SCMODE))
+            {
+                // First process sidechain signal
+                measure_loudness(&sLScMeter, DM_L_SC, vLBuffer, samples);
+                fLScGain    = lsp_max(fLScGain, dsp::max(vLBuffer, samples));
+                sLScGraph.process(vLBuffer, samples);
+                update_history(GM_L_SC, vLBuffer, samples);
+
+                measure_loudness(&sSScMeter, DM_S_SC, vSBuffer, samples);
+                fSScGain    = lsp_max(fSScGain, dsp::max(vSBuffer, samples));
+                sSScGraph.process(vSBuffer, samples);
+                update_history(GM_S_SC, vSBuffer, samples);
+
+                // Limit the long sidechain signal and put to the buffer
+                dsp::limit2(
+                    vGainBuffer,
+                    vLBuffer,
+                    meta::autogain::LEVEL_GAIN_MIN,
+                    meta::autogain::LEVEL_GAIN_MAX,
+                    samples);
+
+                // Then process input signal as usual
+                measure_loudness(&sLInMeter, DM_L_IN, vLBuffer, samples);
+                fLInGain    = lsp_max(fLInGain, dsp::max(vLBuffer, samples));
+                sLInGraph.process(vLBuffer, samples);
+                update_history(GM_L_IN, vLBuffer, samples);
+
+                measure_loudness(&sSInMeter, DM_S_IN, vSBuffer, samples);
+                fSInGain    = lsp_max(fSInGain, dsp::max(vSBuffer, samples));
+                sSInGraph.process(vSBuffer, samples);
+                update_history(GM_S_IN, vSBuffer, samples);
+            }
+            else
+            {
+                // Process the loudnes of input signal
+                measure_loudness(&sLInMeter, DM_L_IN, vLBuffer, samples);
+                fLInGain    = lsp_max(fLInGain, dsp::max(vLBuffer, samples));
+                sLInGraph.process(vLBuffer, samples);
+                update_history(GM_L_IN, vLBuffer, samples);
+
+                measure_loudness(&sSInMeter, DM_S_IN, vSBuffer, samples);
+                fSInGain    = lsp_max(fSInGain, dsp::max(vSBuffer, samples));
+                sSInGraph.process(vSBuffer, samples);
+                update_history(GM_S_IN, vSBuffer, samples);
+
+                // Process the loudness of sidechain signal
+                measure_loudness(&sLScMeter, DM_L_SC, vLBuffer, samples);
+                fLScGain    = lsp_max(fLScGain, dsp::max(vLBuffer, samples));
+                sLScGraph.process(vLBuffer, samples);
+                update_history(GM_L_SC, vLBuffer, samples);
+
+                measure_loudness(&sSScMeter, DM_S_SC, vSBuffer, samples);
+                fSScGain    = lsp_max(fSScGain, dsp::max(vSBuffer, samples));
+                sSScGraph.process(vSBuffer, samples);
+                update_history(GM_S_SC, vSBuffer, samples);
             }
         }
 
+        template <size_t SCMODE>
         void autogain::compute_gain_correction(size_t samples)
         {
-            switch (enScMode)
+            if (is_match_mode(SCMODE))
             {
-                case meta::autogain::SCMODE_MATCH_SC:
-                case meta::autogain::SCMODE_MATCH_LINK:
-                    // In 'Match' mode the sidechain channel defines the desired level of loudness.
-                    // The actual sidechain level is already stored in the vGainBuffer.
-                    sAutoGain.process(vGainBuffer, vLBuffer, vSBuffer, vGainBuffer, samples);
-                    break;
-
-                case meta::autogain::SCMODE_CONTROL_SC:
-                case meta::autogain::SCMODE_CONTROL_LINK:
-                case meta::autogain::SCMODE_INTERNAL:
-                default:
-                    // Process autogain
-                    if (fOldLevel != fLevel)
-                    {
-                        dsp::lramp_set1(vGainBuffer, fOldLevel, fLevel, samples);
-                        sAutoGain.process(vGainBuffer, vLBuffer, vSBuffer, vGainBuffer, samples);
-                    }
-                    else
-                        sAutoGain.process(vGainBuffer, vLBuffer, vSBuffer, fLevel, samples);
-                    break;
+                // In 'Match' mode the sidechain channel defines the desired level of loudness.
+                // The actual sidechain level is already stored in the vGainBuffer.
+                sAutoGain.process(vGainBuffer, vLBuffer, vSBuffer, vGainBuffer, samples);
+            }
+            else if (fOldLevel != fLevel)
+            {
+                // Process autogain
+                dsp::lramp_set1(vGainBuffer, fOldLevel, fLevel, samples);
+                sAutoGain.process(vGainBuffer, vLBuffer, vSBuffer, vGainBuffer, samples);
             }
+            else
+                sAutoGain.process(vGainBuffer, vLBuffer, vSBuffer, fLevel, samples);
             fOldLevel   = fLevel;
 
             // Collect autogain metering
             fGain       = lsp_max(fGain, dsp::max(vGainBuffer, samples));
             sGainGraph.process(vGainBuffer, samples);
+            update_history(GM_GAIN, vGainBuffer, samples);
+
+            // Count the produced points of the graphs, all graphs are processed with the same period
+            nGraphCounter   += samples;
+            if (nGraphCounter >= nGraphPeriod)
+            {
+                size_t points   = nGraphCounter / nGraphPeriod;
+                nGraphCounter   -= points * nGraphPeriod;
+                nGraphPoints   += points;
+            }
         }
 
         void autogain::apply_gain_correction(size_t samples)
         {
+            // Clamp the gain correction to keep the true peak of the output below the ceiling
+            if (bCeiling)
+            {
+                // The gain envelope output does not include the ceiling
+                if (vGainEnv != NULL)
+                    dsp::copy(vEnvBuffer, vGainBuffer, samples);
+
+                for (size_t i=0; i<nChannels; ++i)
+                    sCeiling.bind(i, vChannels[i].vIn);
+                sCeiling.process(vGainBuffer, samples);
+            }
+
             // Apply gain correction to each channel
             for (size_t i=0; i<nChannels; ++i)
             {
                 channel_t *c    = &vChannels[i];
 
-                c->sDelay.process(c->vBuffer, c->vBuffer, samples);     // Apply lookahead to the delay
-                dsp::mul3(c->vBuffer, c->vIn, vGainBuffer, samples);    // Apply VCA control
+                c->sDelay.process(c->vBuffer, c->vIn, samples);         // Apply lookahead to the delay
+                dsp::mul2(c->vBuffer, vGainBuffer, samples);            // Apply VCA control
 
-                sLOutMeter.bind(i, NULL, c->vBuffer, 0);
-                sSOutMeter.bind(i, NULL, c->vBuffer, 0);
+                const float *out        = c->vBuffer;
+                if (nDecimFactor > 1)
+                {
+                    sOutDecim.process(i, out, samples);
+                    out                     = sOutDecim.data(i);
+                }
+                bind_meter(&sLOutMeter, DM_L_OUT, i, out);
+                bind_meter(&sSOutMeter, DM_S_OUT, i, out);
+                bind_meter(&sMOutMeter, DM_M_OUT, i, out);
+                bind_meter(&sTOutMeter, DM_T_OUT, i, out);
             }
 
-            sLOutMeter.process(vLBuffer, samples, dspu::bs::DBFS_TO_LUFS_SHIFT_GAIN);
+            measure_loudness(&sLOutMeter, DM_L_OUT, vLBuffer, samples);
             fLOutGain    = lsp_max(fLOutGain, dsp::max(vLBuffer, samples));
             sLOutGraph.process(vLBuffer, samples);
+            update_history(GM_L_OUT, vLBuffer, samples);
 
-            sSOutMeter.process(vSBuffer, samples, dspu::bs::DBFS_TO_LUFS_SHIFT_GAIN);
+            measure_loudness(&sSOutMeter, DM_S_OUT, vSBuffer, samples);
             fSOutGain    = lsp_max(fSOutGain, dsp::max(vSBuffer, samples));
             sSOutGraph.process(vSBuffer, samples);
+            update_history(GM_S_OUT, vSBuffer, samples);
+
+            measure_integrated_loudness(samples);
+
+            // All meters have processed the block, advance the decimation phase
+            nDecimPhase     = (nDecimPhase + samples) & (nDecimFactor - 1);
+        }
+
+        void autogain::measure_integrated_loudness(size_t samples)
+        {
+            // The long and short buffers are already consumed by the output meters, re-use them.
+            // The meters are bound to the output signal by apply_gain_correction().
+            measure_loudness(&sMOutMeter, DM_M_OUT, vLBuffer, samples);
+            measure_loudness(&sTOutMeter, DM_T_OUT, vSBuffer, samples);
+
+            // Sample the loudness at the end of each measurement block, the histograms
+            // take constant time for each block and constant memory for the whole program
+            for (size_t offset=0; offset < samples; )
+            {
+                size_t to_do    = lsp_min(samples - offset, nIntPeriod - nIntCounter);
+                offset         += to_do;
+                nIntCounter    += to_do;
+                if (nIntCounter < nIntPeriod)
+                    break;
+
+                sIntHist.add(vLBuffer[offset - 1]);
+                sLraHist.add(vSBuffer[offset - 1]);
+                nIntCounter     = 0;
+                bIntUpdate      = true;
+            }
         }
 
         void autogain::update_audio_buffers(size_t samples)
         {
+            // Hosts may pass the same buffer to input and output ports, so all inputs
+            // of the block should be read before any output is written
+            for (size_t i=0; i<nChannels; ++i)
+            {
+                channel_t *c    = &vChannels[i];
+                c->sDryDelay.process(c->vDry, c->vIn, samples);
+            }
+
+            // Output the gain envelope
+            if (vGainEnv != NULL)
+            {
+                dsp::copy(vGainEnv, (bCeiling) ? vEnvBuffer : vGainBuffer, samples);
+                vGainEnv   += samples;
+            }
+
             for (size_t i=0; i<nChannels; ++i)
             {
                 channel_t *c    = &vChannels[i];
 
                 // Apply bypass
-                c->sBypass.process(c->vOut, c->vIn, c->vBuffer, samples);
+                c->sBypass.process(c->vOut, c->vDry, c->vBuffer, samples);
 
                 // Move pointers
                 c->vIn         += samples;
@@ -779,139 +1585,539 @@ namespace lsp
             pLScGain->set_value(fLScGain);
             pSScGain->set_value(fSScGain);
             pGain->set_value(fGain);
+
+            output_integrated_loudness();
         }
 
-        void autogain::output_mesh_data()
+        void autogain::output_integrated_loudness()
         {
-            plug::mesh_t *mesh;
+            // Evaluating the histograms takes time, do it only when new blocks have been measured
+            if (bIntUpdate)
+            {
+                fIntLoudness    = sIntHist.integrated(INT_RELATIVE_GATE);
+                fLoudnessRange  = sLraHist.range(LRA_RELATIVE_GATE, LRA_LOW_PERCENTILE, LRA_HIGH_PERCENTILE);
+                bIntUpdate      = false;
+            }
 
-            // Sync input gain meshes
-            mesh    = pLInGraph->buffer<plug::mesh_t>();
-            if ((mesh != NULL) && (mesh->isEmpty()))
+            pIntLoudness->set_value(fIntLoudness);
+            pLoudnessRange->set_value(fLoudnessRange);
+        }
+
+    #ifdef LSP_AUTOGAIN_PROFILE
+        void autogain::output_profile()
+        {
+            sProfiler.update();
+            for (size_t i=0; i<PS_TOTAL; ++i)
             {
-                dsp::copy(mesh->pvData[0], vTimePoints, meta::autogain::MESH_POINTS);
-                sLInGraph.read(mesh->pvData[1], meta::autogain::MESH_POINTS);
-                mesh->data(2, meta::autogain::MESH_POINTS);
+                if (vProfile[i] != NULL)
+                    vProfile[i]->set_value(sProfiler.cycles_per_sample(i));
             }
+        }
+    #endif /* LSP_AUTOGAIN_PROFILE */
+
+        void autogain::query_display_draw(size_t samples)
+        {
+            // Limit the rate of redraw requests, the rest of the time the inline display remains unchanged
+            nIDisplayCounter   += samples;
+            if ((!bIDisplayDraw) && (nIDisplayCounter < nIDisplayPeriod))
+                return;
 
-            mesh    = pSInGraph->buffer<plug::mesh_t>();
-            if ((mesh != NULL) && (mesh->isEmpty()))
+            nIDisplayCounter    = (bIDisplayDraw) ? 0 : nIDisplayCounter % lsp_max(nIDisplayPeriod, 1U);
+            bIDisplayDraw       = false;
+
+            if (pWrapper != NULL)
+                pWrapper->query_display_draw();
+        }
+
+        void autogain::output_trace(size_t samples)
+        {
+            // Emit the event for the whole process() call
+            if (bTrace)
+                trace_event(PS_TOTAL, nTraceProcess, monotonic_nanos(), samples);
+
+            // Manage the writer task
+            ipc::IExecutor *executor = (pWrapper != NULL) ? pWrapper->executor() : NULL;
+            if (executor == NULL)
+                return;
+
+            // The writer reads the path of the accepted request and allocates the ring,
+            // so the request is committed and tracing is resumed after the writer has completed
+            plug::path_t *path  = pTraceFile->buffer<plug::path_t>();
+            if (sTraceWriter.completed())
             {
-                float *x = mesh->pvData[0];
-                float *y = mesh->pvData[1];
+                if (bTraceAccepted)
+                {
+                    if (path != NULL)
+                        path->commit();
+                    bTrace              = sTraceWriter.opened();
+                    bTraceAccepted      = false;
+                }
+                sTraceWriter.reset();
+            }
+            if (!sTraceWriter.idle())
+                return;
 
-                dsp::copy(&x[1], vTimePoints, meta::autogain::MESH_POINTS);
-                sSInGraph.read(&y[1], meta::autogain::MESH_POINTS);
+            if ((path != NULL) && (path->pending()))
+            {
+                bTrace              = false;
+                path->accept();
+                sTraceWriter.set_file(path->path());
+                bTraceAccepted      = true;
+                executor->submit(&sTraceWriter);
+            }
+            else if ((bTrace) && (!sTrace.empty()))
+                executor->submit(&sTraceWriter);
+        }
 
+        void autogain::capture_record(uint32_t type, uint32_t index, uint32_t count, const float *data, size_t n)
+        {
+            capture_record_t rec;
+            rec.nType           = type;
+            rec.nIndex          = index;
+            rec.nCount          = count;
+            rec.nDropped        = sCapture.dropped();
+            if (n > 0)
+                dsp::copy(rec.vData, data, n);
+            dsp::fill_zero(&rec.vData[n], CAPTURE_FRAME - n);
+
+            if (sCapture.push(&rec))
+                sCapture.clear_dropped();
+        }
 
-                x[0] = x[1];
-                y[0] = 0.0f;
+        void autogain::capture_audio(uint32_t type, uint32_t index, const float *data, size_t samples)
+        {
+            for (size_t offset=0; offset < samples; )
+            {
+                size_t to_do        = lsp_min(samples - offset, CAPTURE_FRAME);
+                capture_record(type, index, uint32_t(to_do), &data[offset], to_do);
+                offset             += to_do;
+            }
+        }
 
-                x += meta::autogain::MESH_POINTS + 1;
-                y += meta::autogain::MESH_POINTS + 1;
-                x[0] = x[-1];
-                y[0] = 0.0f;
+        void autogain::capture_block(size_t samples)
+        {
+            capture_record(CR_BLOCK, 0, uint32_t(samples), NULL, 0);
 
-                mesh->data(2, meta::autogain::MESH_POINTS + 2);
+            for (size_t i=0; i<nChannels; ++i)
+            {
+                const channel_t *c  = &vChannels[i];
+                capture_audio(CR_INPUT, i, c->vIn, samples);
+                if (c->pScIn != NULL)
+                    capture_audio(CR_SIDECHAIN, i, c->vScIn, samples);
+                if (c->vShmIn != NULL)
+                    capture_audio(CR_LINK, i, c->vShmIn, samples);
             }
+        }
 
-            mesh    = pLOutGraph->buffer<plug::mesh_t>();
-            if ((mesh != NULL) && (mesh->isEmpty()))
+        void autogain::capture_params()
+        {
+            // Only changed values are stored, all values are stored after the start of capture
+            for (size_t i=0; i<nCapturePorts; ++i)
             {
-                dsp::copy(mesh->pvData[0], vTimePoints, meta::autogain::MESH_POINTS);
-                sLOutGraph.read(mesh->pvData[1], meta::autogain::MESH_POINTS);
-                mesh->data(2, meta::autogain::MESH_POINTS);
+                plug::IPort *port   = vCapturePorts[i];
+                if (port == NULL)
+                    continue;
+
+                const float value   = port->value();
+                if ((!bCaptureSync) && (value == vCaptureValues[i]))
+                    continue;
+
+                vCaptureValues[i]   = value;
+                capture_record(CR_PARAM, i, 0, &value, 1);
             }
+            bCaptureSync        = false;
+        }
+
+        void autogain::output_capture()
+        {
+            ipc::IExecutor *executor = (pWrapper != NULL) ? pWrapper->executor() : NULL;
+            if ((executor == NULL) || (vCapturePorts == NULL))
+                return;
 
-            mesh    = pSOutGraph->buffer<plug::mesh_t>();
-            if ((mesh != NULL) && (mesh->isEmpty()))
+            // The writer reads the path of the accepted request and allocates the ring,
+            // so the request is committed and capture is started after the writer has completed
+            plug::path_t *path  = pCaptureFile->buffer<plug::path_t>();
+            if (sCaptureWriter.completed())
             {
-                float *x = mesh->pvData[0];
-                float *y = mesh->pvData[1];
+                if (bCaptureAccepted)
+                {
+                    if (path != NULL)
+                        path->commit();
+                    bCapture            = sCaptureWriter.opened();
+                    bCaptureAccepted    = false;
 
-                dsp::copy(&x[1], vTimePoints, meta::autogain::MESH_POINTS);
-                sSInGraph.read(&y[1], meta::autogain::MESH_POINTS);
+                    // The capture starts with the current state of the plugin
+                    if (bCapture)
+                    {
+                        capture_record(CR_SAMPLE_RATE, 0, uint32_t(fSampleRate), NULL, 0);
+                        bCaptureSync        = true;
+                        capture_params();
+                    }
+                }
+                sCaptureWriter.reset();
+            }
+            if (!sCaptureWriter.idle())
+                return;
 
+            if ((path != NULL) && (path->pending()))
+            {
+                bCapture            = false;
+                path->accept();
+                sCaptureWriter.set_file(path->path(), nChannels, nCapturePorts);
+                bCaptureAccepted    = true;
+                executor->submit(&sCaptureWriter);
+            }
+            else if ((bCapture) && (!sCapture.empty()))
+                executor->submit(&sCaptureWriter);
+        }
+
+        void autogain::output_dsp_load()
+        {
+            // The load is averaged over all blocks since the previous publication
+            pDspLoad->set_value(sLoadMeter.interval_load() * 100.0f);
+            pDspPeak->set_value(sLoadMeter.peak() * 100.0f);
+            sLoadMeter.reset_interval();
 
-                x[0] = x[1];
-                y[0] = 0.0f;
+            plug::mesh_t *mesh  = pDspHist->buffer<plug::mesh_t>();
+            if ((mesh == NULL) || (!mesh->isEmpty()))
+                return;
 
-                x += meta::autogain::MESH_POINTS + 1;
-                y += meta::autogain::MESH_POINTS + 1;
-                x[0] = x[-1];
-                y[0] = 0.0f;
+            // The histogram is passed as the fraction of blocks in each bucket,
+            // so it does not depend on the uptime and fits the graph
+            uint64_t total      = 0;
+            for (size_t i=0; i<LoadMeter::BUCKETS; ++i)
+                total              += sLoadMeter.bucket(i);
+            const float norm    = (total > 0) ? 1.0f / float(total) : 0.0f;
 
-                mesh->data(2, meta::autogain::MESH_POINTS + 2);
+            float *x            = mesh->pvData[0];
+            float *y            = mesh->pvData[1];
+            for (size_t i=0; i<LoadMeter::BUCKETS; ++i)
+            {
+                x[i]                = LoadMeter::bucket_limit(i) * 100.0f;
+                y[i]                = sLoadMeter.bucket(i) * norm;
             }
+            mesh->data(2, LoadMeter::BUCKETS);
+        }
 
-            // Output sidechain metering
-            mesh    = pLScGraph->buffer<plug::mesh_t>();
-            if ((mesh != NULL) && (mesh->isEmpty()))
+        void autogain::output_telemetry(size_t samples)
+        {
+            // Emit the telemetry record
+            if ((bTelemetry) && (sTelemetryWriter.active()))
             {
-                dsp::copy(mesh->pvData[0], vTimePoints, meta::autogain::MESH_POINTS);
-                sLScGraph.read(mesh->pvData[1], meta::autogain::MESH_POINTS);
-                mesh->data(2, meta::autogain::MESH_POINTS);
+                telemetry_record_t rec;
+                rec.nPosition       = nTlmPosition;
+                rec.nSamples        = uint32_t(samples);
+                rec.nScMode         = uint32_t(enScMode);
+                rec.fGain           = fGain;
+                rec.fLInGain        = fLInGain;
+                rec.fSInGain        = fSInGain;
+                rec.fLOutGain       = fLOutGain;
+                rec.fSOutGain       = fSOutGain;
+                rec.fLScGain        = fLScGain;
+                rec.fSScGain        = fSScGain;
+                rec.fLevel          = fLevel;
+                rec.nDropped        = sTelemetry.dropped();
+                rec.nReserved[0]    = 0;
+                rec.nReserved[1]    = 0;
+                rec.nReserved[2]    = 0;
+
+                if (sTelemetry.push(&rec))
+                    sTelemetry.clear_dropped();
             }
+            nTlmPosition       += samples;
 
-            mesh    = pSScGraph->buffer<plug::mesh_t>();
-            if ((mesh != NULL) && (mesh->isEmpty()))
+            // Manage the writer task
+            ipc::IExecutor *executor = (pWrapper != NULL) ? pWrapper->executor() : NULL;
+            if (executor == NULL)
+                return;
+
+            // The writer reads the path of the accepted request, so the request
+            // is committed only after the writer has completed
+            plug::path_t *path  = pTlmFile->buffer<plug::path_t>();
+            if (sTelemetryWriter.completed())
             {
-                float *x = mesh->pvData[0];
-                float *y = mesh->pvData[1];
+                if ((bTlmAccepted) && (path != NULL))
+                    path->commit();
+                bTlmAccepted        = false;
+                sTelemetryWriter.reset();
+            }
+            if (!sTelemetryWriter.idle())
+                return;
 
-                dsp::copy(&x[1], vTimePoints, meta::autogain::MESH_POINTS);
-                sSInGraph.read(&y[1], meta::autogain::MESH_POINTS);
+            bool submit         = false;
+            if ((path != NULL) && (path->pending()))
+            {
+                path->accept();
+                sTelemetryWriter.set_file(path->path(), fSampleRate, nChannels, nOutputPeriod);
+                bTlmAccepted        = true;
+                submit              = true;
+            }
+            if ((bTelemetry) && (!sTelemetry.empty()))
+                submit              = true;
 
-                x[0] = x[1];
-                y[0] = 0.0f;
+            if (submit)
+                executor->submit(&sTelemetryWriter);
+        }
 
-                x += meta::autogain::MESH_POINTS + 1;
-                y += meta::autogain::MESH_POINTS + 1;
-                x[0] = x[-1];
-                y[0] = 0.0f;
+        void autogain::read_graph(graph_mesh_t type, dspu::MeterGraph *graph, float *dst)
+        {
+            if (nHistoryZoom > 0)
+                vHistory[type].read(nHistoryZoom - 1, dst, meta::autogain::MESH_POINTS);
+            else
+                graph->read(dst, meta::autogain::MESH_POINTS);
+        }
+
+        void autogain::update_history(graph_mesh_t type, const float *src, size_t samples)
+        {
+            vHistory[type].process(src, samples);
+        }
 
-                mesh->data(2, meta::autogain::MESH_POINTS + 2);
+        void autogain::output_history_log()
+        {
+            // Collect the maximum values for the record, in the order of graph meshes
+            const float values[] = { fLInGain, fSInGain, fLOutGain, fSOutGain, fLScGain, fSScGain, fGain };
+            for (size_t i=0; i<HISTORY_LOG_VALUES; ++i)
+                vHLogValues[i]      = lsp_max(vHLogValues[i], values[i]);
+
+            // Emit the record when enough history graph points have been produced,
+            // the time of the record is stamped by the writer
+            uatomic_t points    = nGraphPoints;
+            size_t dots         = points - nHLogPoints;
+            if (dots >= HISTORY_LOG_DOTS)
+            {
+                if (bHLog)
+                {
+                    history_log_record_t rec;
+                    rec.nTime           = 0;
+                    rec.nPosition       = nTlmPosition;
+                    for (size_t i=0; i<HISTORY_LOG_VALUES; ++i)
+                        rec.vValues[i]      = vHLogValues[i];
+                    rec.nDots           = uint16_t(lsp_min(dots, size_t(UINT16_MAX)));
+                    rec.nFlags          = 0;
+
+                    sHLogOut.push(&rec);
+                }
+
+                for (size_t i=0; i<HISTORY_LOG_VALUES; ++i)
+                    vHLogValues[i]      = 0.0f;
+                nHLogPoints         = points;
             }
 
-            mesh    = pGainGraph->buffer<plug::mesh_t>();
-            if ((mesh != NULL) && (mesh->isEmpty()))
+            // Restore the history from the records previously stored in the log
+            replay_history_log();
+
+            // Manage the writer task
+            ipc::IExecutor *executor = (pWrapper != NULL) ? pWrapper->executor() : NULL;
+            if (executor == NULL)
+                return;
+
+            // The writer reads the path of the accepted request, so the request
+            // is committed only after the writer has completed
+            plug::path_t *path  = pHLogFile->buffer<plug::path_t>();
+            if (sHLog.completed())
             {
-                float *x = mesh->pvData[0];
-                float *y = mesh->pvData[1];
+                if ((bHLogAccepted) && (path != NULL))
+                    path->commit();
+                bHLogAccepted       = false;
+                sHLog.reset();
+            }
+            if (!sHLog.idle())
+                return;
 
-                dsp::copy(&x[2], vTimePoints, meta::autogain::MESH_POINTS);
-                sGainGraph.read(&y[2], meta::autogain::MESH_POINTS);
+            bool submit         = false;
+            if ((path != NULL) && (path->pending()))
+            {
+                path->accept();
+                sHLog.set_file(path->path());
+                bHLogAccepted       = true;
+                submit              = true;
+            }
+            if (((sHLog.opened()) && (!sHLogOut.empty())) || (sHLog.replaying()))
+                submit              = true;
+
+            if (submit)
+                executor->submit(&sHLog);
+        }
+
+        void autogain::replay_history_log()
+        {
+            history_log_record_t rec;
+
+            for (size_t i=0; i<HISTORY_REPLAY_BATCH; ++i)
+            {
+                if (sHLogIn.pop(&rec, 1) <= 0)
+                    break;
+
+                // Start the replay: the history is restored into the separate storage,
+                // the live history keeps being updated and displayed until the replay completes
+                if (!bHLogReplay)
+                {
+                    for (size_t j=0; j<GM_TOTAL; ++j)
+                        vHReplay[j].clear();
+                    bHLogReplay         = true;
+                    nHLogTime           = 0;
+                    nHLogLive           = nGraphPoints;
+                }
 
-                x[0] = x[2] + 0.5f;
-                x[1] = x[0];
-                y[0] = 1.0f;
-                y[1] = y[2];
+                if (rec.nFlags & HLF_REPLAY_END)
+                {
+                    complete_history_replay(rec.nTime);
+                    break;
+                }
 
-                x += meta::autogain::MESH_POINTS + 2;
-                y += meta::autogain::MESH_POINTS + 2;
-                x[0] = x[-1] - 0.5f;
-                y[0] = y[-1];
-                x[1] = x[0];
-                y[1] = 1.0f;
+                // Restore the periods of time when the plugin was not running
+                if (nHLogTime > 0)
+                    append_history_gap(vHReplay, nHLogTime, rec.nTime);
 
-                mesh->data(2, meta::autogain::MESH_POINTS + 4);
+                for (size_t j=0; j<GM_TOTAL; ++j)
+                    vHReplay[j].append(rec.vValues[j], rec.nDots);
+                nHLogTime           = rec.nTime;
             }
         }
 
-        bool autogain::inline_display(plug::ICanvas *cv, size_t width, size_t height)
+        void autogain::complete_history_replay(uint64_t time)
         {
-            // Check proportions
-            if (height > (M_RGOLD_RATIO * width))
-                height  = M_RGOLD_RATIO * width;
+            static_assert(BUFFER_SIZE >= meta::autogain::MESH_POINTS, "Buffer is too small for the history level");
 
-            // Init canvas
-            if (!cv->init(width, height))
-                return false;
-            width   = cv->width();
-            height  = cv->height();
+            bHLogReplay         = false;
+            if (nHLogTime <= 0)
+                return;
+
+            // Fill the gap till the moment when the log has been opened and append the
+            // history collected during the replay, then replace the live history
+            append_history_gap(vHReplay, nHLogTime, time);
+            size_t dots         = nGraphPoints - nHLogLive;
+            for (size_t j=0; j<GM_TOTAL; ++j)
+                vHReplay[j].append(&vHistory[j], dots, vLBuffer);
+
+            lsp::swap(vHistory, vHReplay);
+        }
+
+        void autogain::append_history_gap(LODHistory *dst, uint64_t from, uint64_t to)
+        {
+            // The records follow each other with the interval of HISTORY_LOG_DOTS graph points,
+            // consider the larger interval as a gap and fill it with silence
+            if ((fSampleRate <= 0) || (from <= 0) || (to <= from))
+                return;
+            double dots_per_ms  = double(fSampleRate) / (double(nGraphPeriod) * 1000.0);
+            uint64_t dots       = (to - from) * dots_per_ms;
+            if (dots <= HISTORY_LOG_DOTS * 2)
+                return;
+
+            // There is no sense to fill the gap longer than the whole history
+            uint64_t max_dots   = meta::autogain::MESH_POINTS;
+            for (size_t i=0; i<meta::autogain::HISTORY_LEVELS; ++i)
+                max_dots           *= history_factors[i];
+
+            dots                = lsp_min(dots - HISTORY_LOG_DOTS, max_dots);
+            for (size_t j=0; j<GM_TOTAL; ++j)
+                dst[j].append(0.0f, dots);
+        }
+
+        void autogain::output_graph_mesh(graph_mesh_t type, plug::IPort *port, dspu::MeterGraph *graph, mesh_shape_t shape)
+        {
+            plug::mesh_t *mesh  = port->buffer<plug::mesh_t>();
+            if ((mesh == NULL) || (!mesh->isEmpty()))
+                return;
+
+            // Do not transfer the mesh if there were no new points since the last transfer
+            mesh_sync_t *ms     = &vMeshSync[type];
+            uatomic_t points    = nGraphPoints;
+            if ((ms->bXAxis) && (ms->nPoints == points))
+                return;
+
+            // The X axis never changes, the mesh buffer keeps it's contents after being consumed,
+            // so it is enough to write it only once
+            float *x            = mesh->pvData[0];
+            float *y            = mesh->pvData[1];
+            bool xaxis          = !ms->bXAxis;
+
+            switch (shape)
+            {
+                case MS_FILL:
+                    read_graph(type, graph, &y[1]);
+                    y[0]                = 0.0f;
+                    y[meta::autogain::MESH_POINTS + 1] = 0.0f;
+
+                    if (xaxis)
+                    {
+                        dsp::copy(&x[1], vTimePoints, meta::autogain::MESH_POINTS);
+                        x[0]                = x[1];
+                        x[meta::autogain::MESH_POINTS + 1] = x[meta::autogain::MESH_POINTS];
+                    }
+
+                    mesh->data(2, meta::autogain::MESH_POINTS + 2);
+                    break;
+
+                case MS_GAIN:
+                    read_graph(type, graph, &y[2]);
+                    y[0]                = 1.0f;
+                    y[1]                = y[2];
+                    y[meta::autogain::MESH_POINTS + 2] = y[meta::autogain::MESH_POINTS + 1];
+                    y[meta::autogain::MESH_POINTS + 3] = 1.0f;
+
+                    if (xaxis)
+                    {
+                        dsp::copy(&x[2], vTimePoints, meta::autogain::MESH_POINTS);
+                        x[0]                = x[2] + 0.5f;
+                        x[1]                = x[0];
+                        x[meta::autogain::MESH_POINTS + 2] = x[meta::autogain::MESH_POINTS + 1] - 0.5f;
+                        x[meta::autogain::MESH_POINTS + 3] = x[meta::autogain::MESH_POINTS + 2];
+                    }
+
+                    mesh->data(2, meta::autogain::MESH_POINTS + 4);
+                    break;
+
+                case MS_LINE:
+                default:
+                    read_graph(type, graph, y);
+                    if (xaxis)
+                        dsp::copy(x, vTimePoints, meta::autogain::MESH_POINTS);
+
+                    mesh->data(2, meta::autogain::MESH_POINTS);
+                    break;
+            }
+
+            ms->nPoints         = points;
+            ms->bXAxis          = true;
+        }
+
+        void autogain::output_mesh_data()
+        {
+            // Sync input gain meshes
+            output_graph_mesh(GM_L_IN, pLInGraph, &sLInGraph, MS_LINE);
+            output_graph_mesh(GM_S_IN, pSInGraph, &sSInGraph, MS_FILL);
+
+            // Sync output gain meshes
+            output_graph_mesh(GM_L_OUT, pLOutGraph, &sLOutGraph, MS_LINE);
+            output_graph_mesh(GM_S_OUT, pSOutGraph, &sSOutGraph, MS_FILL);
+
+            // Output sidechain metering
+            output_graph_mesh(GM_L_SC, pLScGraph, &sLScGraph, MS_LINE);
+            output_graph_mesh(GM_S_SC, pSScGraph, &sSScGraph, MS_FILL);
+
+            // Output gain correction
+            output_graph_mesh(GM_GAIN, pGainGraph, &sGainGraph, MS_GAIN);
+        }
+
+        void autogain::output_idisplay_graph()
+        {
+            // Write the snapshot of the gain graph to the back buffer and exchange it with the shared one,
+            // the inline display takes the shared snapshot when it is marked as fresh
+            idisplay_graph_t *g = &vIDGraph[nIDBack];
+            sGainGraph.read(g->vData, meta::autogain::MESH_POINTS);
+            g->nPoints          = nGraphPoints;
+            g->nResets          = nGraphResets;
+
+            nIDBack             = atomic_swap(&nIDShared, uatomic_t(nIDBack | IDG_FRESH)) & IDG_INDEX;
+        }
+
+        void autogain::draw_background(plug::ICanvas *cv, bool bypassing)
+        {
+            size_t width    = cv->width();
+            size_t height   = cv->height();
 
             // Clear background
-            bool bypassing = vChannels[0].sBypass.bypassing();
             cv->set_color_rgb((bypassing) ? CV_DISABLED : CV_BACKGROUND);
             cv->paint();
 
@@ -939,46 +2145,98 @@ namespace lsp
                 cv->line(0, ay, width, ay);
             }
 
-            // Allocate buffer: t, gain, x, y
+            // Draw threshold
+            cv->set_color_rgb(CV_MAGENTA, 0.5f);
+            cv->set_line_width(1.0);
+            {
+                float ay = height + dy*(logf(fLevel*zy));
+                cv->line(0, ay, width, ay);
+            }
+        }
+
+        bool autogain::inline_display(plug::ICanvas *cv, size_t width, size_t height)
+        {
+            // Check proportions
+            if (height > (M_RGOLD_RATIO * width))
+                height  = M_RGOLD_RATIO * width;
+
+            // Init canvas
+            if (!cv->init(width, height))
+                return false;
+            width   = cv->width();
+            height  = cv->height();
+
+            // The background depends only on the canvas size, bypass state and the loudness level,
+            // so draw it once and restore from the cache while these parameters are not changed
+            bool bypassing  = vChannels[0].sBypass.bypassing();
+            uint32_t level;
+            memcpy(&level, &fLevel, sizeof(level));
+            uint64_t key    = (uint64_t(level) << 1) | ((bypassing) ? 1 : 0);
+
+            if ((!sIDBackground.valid(cv, key)) || (!sIDBackground.restore(cv)))
+            {
+                draw_background(cv, bypassing);
+                sIDBackground.store(cv, key);
+            }
+
+            // Calc axis params
+            float zy    = 1.0f/GAIN_AMP_M_84_DB;
+            float dy    = height/(logf(GAIN_AMP_M_84_DB)-logf(GAIN_AMP_P_24_DB));
+
+            // Allocate buffer: min, max, x, y
             pIDisplay           = core::IDBuffer::reuse(pIDisplay, 4, width);
             core::IDBuffer *b   = pIDisplay;
             if (b == NULL)
                 return false;
 
-            float r             = meta::autogain::MESH_POINTS/float(width);
+            // Take the latest snapshot of the gain graph published by the processing thread
+            if (atomic_load(&nIDShared) & IDG_FRESH)
+                nIDFront            = atomic_swap(&nIDShared, uatomic_t(nIDFront)) & IDG_INDEX;
+            const idisplay_graph_t *g   = &vIDGraph[nIDFront];
+
+            // Update the decimated gain curve with the points produced since the last draw.
+            // Each column of the display keeps the minimum and maximum of the gain values,
+            // so short gain changes are not lost when the graph is squeezed
+            size_t count        = g->nPoints - nIDGraphPoints;
+            nIDGraphPoints      = g->nPoints;
+
+            if (sIDGain.columns() != width)
+            {
+                if (sIDGain.init(width, meta::autogain::MESH_POINTS) != STATUS_OK)
+                    return false;
+                count               = meta::autogain::MESH_POINTS;
+            }
+            else if ((count >= meta::autogain::MESH_POINTS) || (g->nResets != nIDGraphResets))
+            {
+                sIDGain.clear();
+                count               = meta::autogain::MESH_POINTS;
+            }
+            nIDGraphResets      = g->nResets;
 
-            // Fill time array
-            float *t            = b->v[0];
-            for (size_t j=0; j<width; ++j)
-                t[j]            = vTimePoints[size_t(r*j)];
+            if (count > 0)
+                sIDGain.append(&g->vData[meta::autogain::MESH_POINTS - count], count);
 
             cv->set_line_width(2.0f);
 
             // Draw gain curve
             {
                 // Initialize values
-                sGainGraph.read(vIDisplay, meta::autogain::MESH_POINTS);
-                float *g        = b->v[1];
-                for (size_t k=0; k<width; ++k)
-                    g[k]            = vIDisplay[size_t(r*k)];
+                float *gmin     = b->v[0];
+                float *gmax     = b->v[1];
+                sIDGain.get(gmin, gmax);
 
                 // Initialize coords
-                dsp::fill(b->v[2], width, width);
-                dsp::fill(b->v[3], height, width);
-                dsp::fmadd_k3(b->v[2], t, dx, width);
-                dsp::axis_apply_log1(b->v[3], g, zy, dy, width);
+                dsp::lramp_set1(b->v[2], 0.0f, width, width);
 
-                // Draw channel
+                // Draw upper and lower bounds of the envelope
                 cv->set_color_rgb((bypassing) ? CV_SILVER : CV_BRIGHT_BLUE);
+                dsp::fill(b->v[3], height, width);
+                dsp::axis_apply_log1(b->v[3], gmax, zy, dy, width);
                 cv->draw_lines(b->v[2], b->v[3], width);
-            }
 
-            // Draw threshold
-            cv->set_color_rgb(CV_MAGENTA, 0.5f);
-            cv->set_line_width(1.0);
-            {
-                float ay = height + dy*(logf(fLevel*zy));
-                cv->line(0, ay, width, ay);
+                dsp::fill(b->v[3], height, width);
+                dsp::axis_apply_log1(b->v[3], gmin, zy, dy, width);
+                cv->draw_lines(b->v[2], b->v[3], width);
             }
 
             return true;
@@ -995,17 +2253,209 @@ namespace lsp
             v->write_object("sLScGraph", &sLScGraph);
             v->write_object("sSScGraph", &sSScGraph);
             v->write_object("sGainGraph", &sGainGraph);
+            v->begin_array("vHistoryData", vHistoryData, GM_TOTAL*2);
+            {
+                for (size_t i=0; i<GM_TOTAL*2; ++i)
+                {
+                    v->begin_object(&vHistoryData[i], sizeof(LODHistory));
+                    {
+                        vHistoryData[i].dump(v);
+                    }
+                    v->end_object();
+                }
+            }
+            v->end_array();
+            v->write("vHistory", vHistory);
+            v->write("vHReplay", vHReplay);
             v->write_object("sLInMeter", &sLInMeter);
             v->write_object("sSInMeter", &sSInMeter);
             v->write_object("sLOutMeter", &sLOutMeter);
             v->write_object("sSOutMeter", &sSOutMeter);
             v->write_object("sLScMeter", &sLScMeter);
             v->write_object("sSScMeter", &sSScMeter);
+            v->write_object("sMOutMeter", &sMOutMeter);
+            v->write_object("sTOutMeter", &sTOutMeter);
+            v->begin_array("vDecimMeters", vDecimMeters, DM_TOTAL);
+            {
+                for (size_t i=0; i<DM_TOTAL; ++i)
+                {
+                    v->begin_object(&vDecimMeters[i], sizeof(dspu::LoudnessMeter));
+                    {
+                        vDecimMeters[i].dump(v);
+                    }
+                    v->end_object();
+                }
+            }
+            v->end_array();
             v->write_object("sAutoGain", &sAutoGain);
+            v->begin_object("sInDecim", &sInDecim, sizeof(MeterDecimator));
+            {
+                sInDecim.dump(v);
+            }
+            v->end_object();
+            v->begin_object("sScDecim", &sScDecim, sizeof(MeterDecimator));
+            {
+                sScDecim.dump(v);
+            }
+            v->end_object();
+            v->begin_object("sOutDecim", &sOutDecim, sizeof(MeterDecimator));
+            {
+                sOutDecim.dump(v);
+            }
+            v->end_object();
+            v->begin_object("sCeiling", &sCeiling, sizeof(TruePeakCeiling));
+            {
+                sCeiling.dump(v);
+            }
+            v->end_object();
+            v->begin_object("sTelemetry", &sTelemetry, sizeof(TelemetryRing));
+            {
+                sTelemetry.dump(v);
+            }
+            v->end_object();
+            v->begin_object("sHLogOut", &sHLogOut, sizeof(HistoryLogRing));
+            {
+                sHLogOut.dump(v);
+            }
+            v->end_object();
+            v->begin_object("sHLogIn", &sHLogIn, sizeof(HistoryLogRing));
+            {
+                sHLogIn.dump(v);
+            }
+            v->end_object();
+            v->begin_object("sHLog", &sHLog, sizeof(HistoryLog));
+            {
+                sHLog.dump(v);
+            }
+            v->end_object();
+            v->begin_object("sTrace", &sTrace, sizeof(TraceRing));
+            {
+                sTrace.dump(v);
+            }
+            v->end_object();
+            v->begin_object("sCapture", &sCapture, sizeof(CaptureRing));
+            {
+                sCapture.dump(v);
+            }
+            v->end_object();
+        #ifdef LSP_TESTING
+            v->begin_object("sGenerator", &sGenerator, sizeof(SignalGenerator));
+            {
+                sGenerator.dump(v);
+            }
+            v->end_object();
+        #endif /* LSP_TESTING */
+            v->begin_object("sIDBackground", &sIDBackground, sizeof(CanvasCache));
+            {
+                sIDBackground.dump(v);
+            }
+            v->end_object();
+            v->begin_object("sIDGain", &sIDGain, sizeof(GraphDecimator));
+            {
+                sIDGain.dump(v);
+            }
+            v->end_object();
+            v->begin_object("sLoadMeter", &sLoadMeter, sizeof(LoadMeter));
+            {
+                sLoadMeter.dump(v);
+            }
+            v->end_object();
+            v->begin_object("sIntHist", &sIntHist, sizeof(LoudnessHistogram));
+            {
+                sIntHist.dump(v);
+            }
+            v->end_object();
+            v->begin_object("sLraHist", &sLraHist, sizeof(LoudnessHistogram));
+            {
+                sLraHist.dump(v);
+            }
+            v->end_object();
+        #ifdef LSP_AUTOGAIN_PROFILE
+            v->begin_object("sProfiler", &sProfiler, sizeof(StageProfiler));
+            {
+                sProfiler.dump(v, stage_names, PS_TOTAL);
+            }
+            v->end_object();
+        #endif /* LSP_AUTOGAIN_PROFILE */
 
             v->write("nChannels", nChannels);
             v->write("enScMode", enScMode);
             v->write("bSidechain", bSidechain);
+            v->write("bGainEnv", bGainEnv);
+            v->write("bCeiling", bCeiling);
+            v->write("bDecimate", bDecimate);
+            v->write("bTelemetry", bTelemetry);
+            v->write("bTlmAccepted", bTlmAccepted);
+            v->write("bTrace", bTrace);
+            v->write("bTraceAccepted", bTraceAccepted);
+            v->write("bCaptureAccepted", bCaptureAccepted);
+            v->write("bCapture", bCapture);
+            v->write("bCaptureSync", bCaptureSync);
+            v->write("nCapturePorts", nCapturePorts);
+            v->write("vCapturePorts", vCapturePorts);
+            v->write("vCaptureValues", vCaptureValues);
+            v->write("nTraceProcess", nTraceProcess);
+            v->write("nTraceStage", nTraceStage);
+            v->write("nTlmPosition", nTlmPosition);
+            v->write("nIDisplayPeriod", nIDisplayPeriod);
+            v->write("nIDisplayCounter", nIDisplayCounter);
+            v->write("bIDisplayDraw", bIDisplayDraw);
+            v->write("nHistoryZoom", nHistoryZoom);
+            v->write("bHLog", bHLog);
+            v->write("bHLogAccepted", bHLogAccepted);
+            v->write("bHLogReplay", bHLogReplay);
+            v->write("nHLogPoints", nHLogPoints);
+            v->write("nHLogLive", nHLogLive);
+            v->write("nHLogTime", nHLogTime);
+            v->writev("vHLogValues", vHLogValues, HISTORY_LOG_VALUES);
+            v->write("nDecimStages", nDecimStages);
+            v->write("nDecimFactor", nDecimFactor);
+            v->write("nDecimPhase", nDecimPhase);
+            v->write("nDecimCount", nDecimCount);
+            v->writev("vDecimHold", vDecimHold, DM_TOTAL);
+            v->write("nIntPeriod", nIntPeriod);
+            v->write("nIntCounter", nIntCounter);
+            v->write("bIntUpdate", bIntUpdate);
+            v->write("nOutputPeriod", nOutputPeriod);
+            v->write("nOutputCounter", nOutputCounter);
+            v->write("nGraphPeriod", nGraphPeriod);
+            v->write("nGraphCounter", nGraphCounter);
+            v->write("nGraphPoints", nGraphPoints);
+            v->write("nGraphResets", nGraphResets);
+            v->begin_array("vIDGraph", vIDGraph, IDG_BUFFERS);
+            {
+                for (size_t i=0; i<IDG_BUFFERS; ++i)
+                {
+                    const idisplay_graph_t *g = &vIDGraph[i];
+                    v->begin_object(g, sizeof(idisplay_graph_t));
+                    {
+                        v->write("vData", g->vData);
+                        v->write("nPoints", g->nPoints);
+                        v->write("nResets", g->nResets);
+                    }
+                    v->end_object();
+                }
+            }
+            v->end_array();
+            v->write("nIDShared", nIDShared);
+            v->write("nIDBack", nIDBack);
+            v->write("nIDFront", nIDFront);
+            v->write("nIDGraphPoints", nIDGraphPoints);
+            v->write("nIDGraphResets", nIDGraphResets);
+            v->begin_array("vMeshSync", vMeshSync, GM_TOTAL);
+            {
+                for (size_t i=0; i<GM_TOTAL; ++i)
+                {
+                    const mesh_sync_t *ms   = &vMeshSync[i];
+                    v->begin_object(ms, sizeof(mesh_sync_t));
+                    {
+                        v->write("nPoints", ms->nPoints);
+                        v->write("bXAxis", ms->bXAxis);
+                    }
+                    v->end_object();
+                }
+            }
+            v->end_array();
 
             v->begin_array("vChannels", vChannels, nChannels);
             {
@@ -1016,9 +2466,12 @@ namespace lsp
                     {
                         v->write_object("sBypass", &c->sBypass);
                         v->write_object("sDelay", &c->sDelay);
+                        v->write_object("sDryDelay", &c->sDryDelay);
 
                         v->write("vIn", c->vIn);
                         v->write("vScIn", c->vScIn);
+                        v->write("vShmIn", c->vShmIn);
+                        v->write("vDry", c->vDry);
                         v->write("vOut", c->vOut);
                         v->write("vBuffer", c->vBuffer);
 
@@ -1039,6 +2492,8 @@ namespace lsp
             v->write("fLScGain", fLScGain);
             v->write("fSScGain", fSScGain);
             v->write("fGain", fGain);
+            v->write("fIntLoudness", fIntLoudness);
+            v->write("fLoudnessRange", fLoudnessRange);
             v->write("fOldLevel", fOldLevel);
             v->write("fLevel", fLevel);
             v->write("fOldPreamp", fOldPreamp);
@@ -1047,9 +2502,12 @@ namespace lsp
             v->write("vLBuffer", vLBuffer);
             v->write("vSBuffer", vSBuffer);
             v->write("vGainBuffer", vGainBuffer);
+            v->write("vGainEnv", vGainEnv);
+            v->write("vDecimBuffer", vDecimBuffer);
+            v->write("vEnvBuffer", vEnvBuffer);
             v->write("vTimePoints", vTimePoints);
-            v->write("vIDisplay", vIDisplay);
 
+            v->write("pGainEnv", pGainEnv);
             v->write("pBypass", pBypass);
             v->write("pScMode", pScMode);
             v->write("pScPreamp", pScPreamp);
@@ -1091,8 +2549,27 @@ namespace lsp
             v->write("pLScGraph", pLScGraph);
             v->write("pSScGraph", pSScGraph);
             v->write("pGainGraph", pGainGraph);
+            v->write("pCeilingOn", pCeilingOn);
+            v->write("pCeiling", pCeiling);
+            v->write("pDecimate", pDecimate);
+            v->write("pTlmOn", pTlmOn);
+            v->write("pTlmFile", pTlmFile);
+            v->write("pTraceFile", pTraceFile);
+            v->write("pCaptureFile", pCaptureFile);
+            v->write("pIDisplayRate", pIDisplayRate);
+            v->write("pHistoryZoom", pHistoryZoom);
+            v->write("pHLogOn", pHLogOn);
+            v->write("pHLogFile", pHLogFile);
+            v->write("pIntLoudness", pIntLoudness);
+            v->write("pLoudnessRange", pLoudnessRange);
+            v->write("pIntReset", pIntReset);
+            v->write("pDspLoad", pDspLoad);
+            v->write("pDspPeak", pDspPeak);
+            v->write("pDspReset", pDspReset);
+            v->write("pDspHist", pDspHist);
 
             v->write("pData", pData);
+            v->write("pCaptureData", pCaptureData);
         }
 
     } /* namespace plugins */
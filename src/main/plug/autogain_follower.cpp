@@ -0,0 +1,253 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-plugins-autogain
+ * Created on: 18 окт 2026 г.
+ *
+ * lsp-plugins-autogain is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-plugins-autogain is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-plugins-autogain. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <lsp-plug.in/common/alloc.h>
+#include <lsp-plug.in/common/debug.h>
+#include <lsp-plug.in/dsp/dsp.h>
+#include <lsp-plug.in/plug-fw/meta/func.h>
+
+#include <private/plugins/autogain_follower.h>
+
+namespace lsp
+{
+    namespace plugins
+    {
+        /* The size of temporary buffer for audio processing */
+        static constexpr size_t BUFFER_SIZE         = 0x400;
+
+        //---------------------------------------------------------------------
+        // Plugin factory
+        static const meta::plugin_t *plugins[] =
+        {
+            &meta::autogain_follower_mono,
+            &meta::autogain_follower_stereo
+        };
+
+        static plug::Module *plugin_factory(const meta::plugin_t *meta)
+        {
+            return new autogain_follower(meta);
+        }
+
+        static plug::Factory factory(plugin_factory, plugins, 2);
+
+        //---------------------------------------------------------------------
+        // Implementation
+        autogain_follower::autogain_follower(const meta::plugin_t *meta):
+            Module(meta)
+        {
+            // Compute the number of audio channels by the number of outputs
+            nChannels       = 0;
+            for (const meta::port_t *p = meta->ports; p->id != NULL; ++p)
+                if (meta::is_audio_out_port(p))
+                    ++nChannels;
+
+            vChannels       = NULL;
+            vGainEnv        = NULL;
+            fGain           = 0.0f;
+
+            pGainEnv        = NULL;
+            pBypass         = NULL;
+            pGain           = NULL;
+
+            pData           = NULL;
+        }
+
+        autogain_follower::~autogain_follower()
+        {
+            do_destroy();
+        }
+
+        void autogain_follower::init(plug::IWrapper *wrapper, plug::IPort **ports)
+        {
+            // Call parent class for initialization
+            Module::init(wrapper, ports);
+
+            // Estimate the number of bytes to allocate
+            size_t szof_channels    = align_size(sizeof(channel_t) * nChannels, OPTIMAL_ALIGN);
+            size_t szof_buffer      = BUFFER_SIZE * sizeof(float);
+            size_t alloc            =
+                szof_channels +     // vChannels
+                nChannels * (
+                    szof_buffer +   // vBuffer
+                    szof_buffer     // vDry
+                );
+
+            // Allocate memory-aligned data
+            uint8_t *ptr            = alloc_aligned<uint8_t>(pData, alloc, OPTIMAL_ALIGN);
+            if (ptr == NULL)
+                return;
+
+            // Initialize pointers to channels and temporary buffer
+            vChannels               = advance_ptr_bytes<channel_t>(ptr, szof_channels);
+
+            for (size_t i=0; i < nChannels; ++i)
+            {
+                channel_t *c            = &vChannels[i];
+
+                c->sBypass.construct();
+
+                c->vIn                  = NULL;
+                c->vOut                 = NULL;
+                c->vBuffer              = advance_ptr_bytes<float>(ptr, szof_buffer);
+                c->vDry                 = advance_ptr_bytes<float>(ptr, szof_buffer);
+
+                c->pIn                  = NULL;
+                c->pOut                 = NULL;
+            }
+
+            // Bind ports
+            lsp_trace("Binding ports");
+            size_t port_id      = 0;
+
+            for (size_t i=0; i<nChannels; ++i)
+                BIND_PORT(vChannels[i].pIn);
+            for (size_t i=0; i<nChannels; ++i)
+                BIND_PORT(vChannels[i].pOut);
+
+            BIND_PORT(pGainEnv);
+            BIND_PORT(pBypass);
+            BIND_PORT(pGain);
+        }
+
+        void autogain_follower::destroy()
+        {
+            Module::destroy();
+            do_destroy();
+        }
+
+        void autogain_follower::do_destroy()
+        {
+            // Destroy channels
+            if (vChannels != NULL)
+            {
+                for (size_t i=0; i<nChannels; ++i)
+                    vChannels[i].sBypass.destroy();
+                vChannels   = NULL;
+            }
+
+            // Free previously allocated data chunk
+            if (pData != NULL)
+            {
+                free_aligned(pData);
+                pData       = NULL;
+            }
+        }
+
+        void autogain_follower::update_sample_rate(long sr)
+        {
+            for (size_t i=0; i<nChannels; ++i)
+                vChannels[i].sBypass.init(sr);
+        }
+
+        void autogain_follower::update_settings()
+        {
+            bool bypass                     = pBypass->value() >= 0.5f;
+
+            for (size_t i=0; i<nChannels; ++i)
+                vChannels[i].sBypass.set_bypass(bypass);
+        }
+
+        void autogain_follower::process(size_t samples)
+        {
+            // Bind audio ports
+            vGainEnv        = pGainEnv->buffer<float>();
+            for (size_t i=0; i<nChannels; ++i)
+            {
+                channel_t *c    = &vChannels[i];
+                c->vIn          = c->pIn->buffer<float>();
+                c->vOut         = c->pOut->buffer<float>();
+            }
+
+            fGain           = 0.0f;
+
+            for (size_t offset=0; offset < samples; )
+            {
+                size_t to_do    = lsp_min(samples - offset, BUFFER_SIZE);
+
+                fGain           = lsp_max(fGain, dsp::max(vGainEnv, to_do));
+
+                // Read all inputs before any output is written: the host may pass the same
+                // buffer to the gain envelope or any input and to one of the outputs
+                for (size_t i=0; i<nChannels; ++i)
+                {
+                    channel_t *c    = &vChannels[i];
+                    dsp::copy(c->vDry, c->vIn, to_do);
+                    dsp::mul3(c->vBuffer, c->vDry, vGainEnv, to_do);
+                }
+
+                for (size_t i=0; i<nChannels; ++i)
+                {
+                    channel_t *c    = &vChannels[i];
+
+                    c->sBypass.process(c->vOut, c->vDry, c->vBuffer, to_do);
+
+                    c->vIn         += to_do;
+                    c->vOut        += to_do;
+                }
+
+                vGainEnv       += to_do;
+                offset         += to_do;
+            }
+
+            pGain->set_value(fGain);
+        }
+
+        void autogain_follower::dump(dspu::IStateDumper *v) const
+        {
+            plug::Module::dump(v);
+
+            v->write("nChannels", nChannels);
+            v->begin_array("vChannels", vChannels, nChannels);
+            {
+                for (size_t i=0; i<nChannels; ++i)
+                {
+                    const channel_t *c  = &vChannels[i];
+                    v->begin_object(c, sizeof(channel_t));
+                    {
+                        v->write_object("sBypass", &c->sBypass);
+
+                        v->write("vIn", c->vIn);
+                        v->write("vOut", c->vOut);
+                        v->write("vBuffer", c->vBuffer);
+                        v->write("vDry", c->vDry);
+
+                        v->write("pIn", c->pIn);
+                        v->write("pOut", c->pOut);
+                    }
+                    v->end_object();
+                }
+            }
+            v->end_array();
+
+            v->write("vGainEnv", vGainEnv);
+            v->write("fGain", fGain);
+
+            v->write("pGainEnv", pGainEnv);
+            v->write("pBypass", pBypass);
+            v->write("pGain", pGain);
+
+            v->write("pData", pData);
+        }
+
+    } /* namespace plugins */
+} /* namespace lsp */
+
+
@@ -0,0 +1,125 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-plugins-autogain
+ * Created on: 18 окт 2026 г.
+ *
+ * lsp-plugins-autogain is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-plugins-autogain is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-plugins-autogain. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <private/util/CanvasCache.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+namespace lsp
+{
+    namespace plugins
+    {
+        CanvasCache::CanvasCache()
+        {
+            pData           = NULL;
+            nCapacity       = 0;
+            nWidth          = 0;
+            nHeight         = 0;
+            nStride         = 0;
+            nKey            = 0;
+            bValid          = false;
+        }
+
+        CanvasCache::~CanvasCache()
+        {
+            destroy();
+        }
+
+        void CanvasCache::destroy()
+        {
+            if (pData != NULL)
+            {
+                free(pData);
+                pData           = NULL;
+            }
+            nCapacity       = 0;
+            bValid          = false;
+        }
+
+        bool CanvasCache::valid(plug::ICanvas *cv, uint64_t key) const
+        {
+            return (bValid) &&
+                (nKey == key) &&
+                (nWidth == cv->width()) &&
+                (nHeight == cv->height()) &&
+                (nStride == cv->stride());
+        }
+
+        bool CanvasCache::store(plug::ICanvas *cv, uint64_t key)
+        {
+            bValid          = false;
+
+            // Ensure that there is enough space for the snapshot
+            size_t stride   = cv->stride();
+            size_t bytes    = stride * cv->height();
+            if (bytes > nCapacity)
+            {
+                uint8_t *ptr    = static_cast<uint8_t *>(realloc(pData, bytes));
+                if (ptr == NULL)
+                    return false;
+                pData           = ptr;
+                nCapacity       = bytes;
+            }
+
+            // Copy the contents of the canvas
+            const uint8_t *src  = static_cast<const uint8_t *>(cv->start_direct());
+            if (src == NULL)
+                return false;
+            memcpy(pData, src, bytes);
+            cv->end_direct();
+
+            nWidth          = cv->width();
+            nHeight         = cv->height();
+            nStride         = stride;
+            nKey            = key;
+            bValid          = true;
+
+            return true;
+        }
+
+        bool CanvasCache::restore(plug::ICanvas *cv)
+        {
+            if (!bValid)
+                return false;
+
+            uint8_t *dst    = static_cast<uint8_t *>(cv->start_direct());
+            if (dst == NULL)
+                return false;
+            memcpy(dst, pData, nStride * nHeight);
+            cv->end_direct();
+
+            return true;
+        }
+
+        void CanvasCache::dump(dspu::IStateDumper *v) const
+        {
+            v->write("pData", pData);
+            v->write("nCapacity", nCapacity);
+            v->write("nWidth", nWidth);
+            v->write("nHeight", nHeight);
+            v->write("nStride", nStride);
+            v->write("nKey", nKey);
+            v->write("bValid", bValid);
+        }
+
+    } /* namespace plugins */
+} /* namespace lsp */
@@ -0,0 +1,172 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-plugins-autogain
+ * Created on: 18 окт 2026 г.
+ *
+ * lsp-plugins-autogain is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-plugins-autogain is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-plugins-autogain. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <lsp-plug.in/common/debug.h>
+#include <lsp-plug.in/io/File.h>
+
+#include <private/util/Capture.h>
+
+#include <string.h>
+
+namespace lsp
+{
+    namespace plugins
+    {
+        CaptureWriter::CaptureWriter(CaptureRing *ring, size_t capacity)
+        {
+            pRing           = ring;
+            nCapacity       = capacity;
+            bOpened         = false;
+            pRequest        = NULL;
+            nChannels       = 0;
+            nPorts          = 0;
+            nReopen         = 0;
+            nCancel         = 0;
+            sPath[0]        = '\0';
+        }
+
+        CaptureWriter::~CaptureWriter()
+        {
+            close();
+        }
+
+        void CaptureWriter::set_file(const char *path, size_t channels, size_t ports)
+        {
+            pRequest        = (path != NULL) ? path : "";
+            nChannels       = channels;
+            nPorts          = ports;
+            atomic_store(&nReopen, 1);
+        }
+
+        status_t CaptureWriter::open_file()
+        {
+            if (sPath[0] == '\0')
+                return STATUS_OK;
+
+            // The ring is allocated when the capture is requested for the first time
+            if ((pRing->capacity() <= 0) && (pRing->init(nCapacity) != STATUS_OK))
+                return STATUS_NO_MEM;
+
+            status_t res = sOut.open(sPath, io::File::FM_WRITE_NEW);
+            if (res != STATUS_OK)
+            {
+                lsp_warn("Could not open capture file %s, error code: %d", sPath, int(res));
+                return res;
+            }
+
+            capture_header_t hdr;
+            memset(&hdr, 0, sizeof(hdr));
+            hdr.nMagic              = CAPTURE_MAGIC;
+            hdr.nVersion            = CAPTURE_VERSION;
+            hdr.nRecordSize         = sizeof(capture_record_t);
+            hdr.nChannels           = nChannels;
+            hdr.nPorts              = nPorts;
+
+            if (sOut.write(&hdr, sizeof(hdr)) != sizeof(hdr))
+            {
+                sOut.close();
+                return STATUS_IO_ERROR;
+            }
+
+            bOpened                 = true;
+            return STATUS_OK;
+        }
+
+        void CaptureWriter::close_file()
+        {
+            if (!bOpened)
+                return;
+
+            sOut.flush();
+            sOut.close();
+            bOpened                 = false;
+        }
+
+        void CaptureWriter::close()
+        {
+            // The task may be still submitted or running, the file should not be touched until it completes
+            atomic_store(&nCancel, 1);
+            const bool finished     = wait_task(this);
+            atomic_store(&nCancel, 0);
+            pRequest                = NULL;
+            atomic_store(&nReopen, 0);
+            if (!bOpened)
+                return;
+            if (!finished)
+            {
+                lsp_warn("Capture writer did not finish in time, leaving file %s to the task", sPath);
+                bOpened                 = false;
+                return;
+            }
+
+            // Write the rest of records
+            drain();
+            close_file();
+        }
+
+        status_t CaptureWriter::drain()
+        {
+            while (!atomic_load(&nCancel))
+            {
+                size_t count            = pRing->pop(vBatch, BATCH_SIZE);
+                if (count <= 0)
+                    break;
+                if (!bOpened)
+                    continue;
+
+                size_t bytes            = count * sizeof(capture_record_t);
+                if (sOut.write(vBatch, bytes) != ssize_t(bytes))
+                {
+                    lsp_warn("Error writing capture file %s", sPath);
+                    sOut.close();
+                    bOpened                 = false;
+                    return STATUS_IO_ERROR;
+                }
+            }
+
+            if (bOpened)
+                sOut.flush();
+            return STATUS_OK;
+        }
+
+        status_t CaptureWriter::run()
+        {
+            // Switch to another file: the records collected for the previous file are written to it
+            if (atomic_load(&nReopen))
+            {
+                drain();
+                close_file();
+
+                strncpy(sPath, pRequest, PATH_MAX - 1);
+                sPath[PATH_MAX - 1]     = '\0';
+                pRequest                = NULL;
+                atomic_store(&nReopen, 0);
+
+                status_t res            = open_file();
+                if (res != STATUS_OK)
+                    return res;
+            }
+
+            return drain();
+        }
+
+    } /* namespace plugins */
+} /* namespace lsp */
@@ -0,0 +1,130 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-plugins-autogain
+ * Created on: 18 окт 2026 г.
+ *
+ * lsp-plugins-autogain is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-plugins-autogain is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-plugins-autogain. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <private/util/CaptureReader.h>
+
+#ifdef LSP_TESTING
+
+#include <lsp-plug.in/common/debug.h>
+
+#include <string.h>
+
+namespace lsp
+{
+    namespace plugins
+    {
+        CaptureReader::CaptureReader()
+        {
+            memset(&sHeader, 0, sizeof(sHeader));
+            bOpened         = false;
+            nRecords        = 0;
+            nDropped        = 0;
+        }
+
+        CaptureReader::~CaptureReader()
+        {
+            close();
+        }
+
+        status_t CaptureReader::open(const char *path)
+        {
+            close();
+
+            status_t res = sIn.open(path);
+            if (res != STATUS_OK)
+            {
+                lsp_warn("Could not open capture file %s, error code: %d", path, int(res));
+                return res;
+            }
+
+            ssize_t n = sIn.read_fully(&sHeader, sizeof(sHeader));
+            if (n != ssize_t(sizeof(sHeader)))
+                res     = ((n < 0) && (n != -STATUS_EOF)) ? status_t(-n) : STATUS_BAD_FORMAT;
+            else if (sHeader.nMagic != CAPTURE_MAGIC)
+                res     = STATUS_BAD_FORMAT;
+            else if (sHeader.nVersion != CAPTURE_VERSION)
+                res     = STATUS_UNSUPPORTED_FORMAT;
+            else if (sHeader.nRecordSize != sizeof(capture_record_t))
+                res     = STATUS_BAD_FORMAT;
+
+            if (res != STATUS_OK)
+            {
+                sIn.close();
+                return res;
+            }
+
+            bOpened         = true;
+            nRecords        = 0;
+            nDropped        = 0;
+            return STATUS_OK;
+        }
+
+        status_t CaptureReader::read(capture_record_t *rec)
+        {
+            if (!bOpened)
+                return STATUS_CLOSED;
+
+            ssize_t n = sIn.read_fully(rec, sizeof(capture_record_t));
+            if (n == -STATUS_EOF)
+                return STATUS_EOF;
+            else if (n < 0)
+                return status_t(-n);
+            else if (n != ssize_t(sizeof(capture_record_t)))
+                return STATUS_CORRUPTED;
+
+            // Validate the record
+            switch (rec->nType)
+            {
+                case CR_SAMPLE_RATE:
+                case CR_BLOCK:
+                    break;
+                case CR_PARAM:
+                    if (rec->nIndex >= sHeader.nPorts)
+                        return STATUS_CORRUPTED;
+                    break;
+                case CR_INPUT:
+                case CR_SIDECHAIN:
+                case CR_LINK:
+                    if ((rec->nIndex >= sHeader.nChannels) || (rec->nCount > CAPTURE_FRAME))
+                        return STATUS_CORRUPTED;
+                    break;
+                default:
+                    return STATUS_CORRUPTED;
+            }
+
+            ++nRecords;
+            nDropped       += rec->nDropped;
+            return STATUS_OK;
+        }
+
+        void CaptureReader::close()
+        {
+            if (!bOpened)
+                return;
+
+            sIn.close();
+            bOpened         = false;
+        }
+
+    } /* namespace plugins */
+} /* namespace lsp */
+
+#endif /* LSP_TESTING */
@@ -0,0 +1,172 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-plugins-autogain
+ * Created on: 18 окт 2026 г.
+ *
+ * lsp-plugins-autogain is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-plugins-autogain is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-plugins-autogain. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <lsp-plug.in/common/alloc.h>
+#include <lsp-plug.in/dsp/dsp.h>
+#include <private/util/GraphDecimator.h>
+
+namespace lsp
+{
+    namespace plugins
+    {
+        GraphDecimator::GraphDecimator()
+        {
+            vMin            = NULL;
+            vMax            = NULL;
+            nColumns        = 0;
+            nPoints         = 0;
+            nPosition       = 0;
+            nColumn         = 0;
+            pData           = NULL;
+        }
+
+        GraphDecimator::~GraphDecimator()
+        {
+            destroy();
+        }
+
+        status_t GraphDecimator::init(size_t columns, size_t points)
+        {
+            if ((columns <= 0) || (points <= 0))
+                return STATUS_INVALID_VALUE;
+
+            if (columns != nColumns)
+            {
+                size_t szof_ring    = align_size(columns * sizeof(float), DEFAULT_ALIGN);
+                uint8_t *data       = NULL;
+                uint8_t *ptr        = alloc_aligned<uint8_t>(data, szof_ring * 2, DEFAULT_ALIGN);
+                if (ptr == NULL)
+                    return STATUS_NO_MEM;
+
+                if (pData != NULL)
+                    free_aligned(pData);
+                pData               = data;
+                vMin                = advance_ptr_bytes<float>(ptr, szof_ring);
+                vMax                = advance_ptr_bytes<float>(ptr, szof_ring);
+            }
+
+            nColumns        = columns;
+            nPoints         = points;
+            clear();
+
+            return STATUS_OK;
+        }
+
+        void GraphDecimator::destroy()
+        {
+            if (pData != NULL)
+            {
+                free_aligned(pData);
+                pData           = NULL;
+            }
+            vMin            = NULL;
+            vMax            = NULL;
+            nColumns        = 0;
+            nPoints         = 0;
+        }
+
+        void GraphDecimator::clear()
+        {
+            nPosition       = 0;
+            nColumn         = 0;
+
+            if (vMin != NULL)
+            {
+                dsp::fill_zero(vMin, nColumns);
+                dsp::fill_zero(vMax, nColumns);
+            }
+        }
+
+        void GraphDecimator::append(const float *src, size_t count)
+        {
+            if (nColumns <= 0)
+                return;
+
+            float vmin, vmax;
+
+            while (count > 0)
+            {
+                // Compute the column of the point and the end of the column
+                uint64_t col    = (nPosition * nColumns) / nPoints;
+                uint64_t end    = ((col + 1) * nPoints + nColumns - 1) / nColumns;
+                size_t to_do    = lsp_min(uint64_t(count), end - nPosition);
+
+                dsp::minmax(src, to_do, &vmin, &vmax);
+
+                if ((nPosition <= 0) || (col != nColumn))
+                {
+                    // Columns that do not contain any point (when there are more columns than points)
+                    // take the value of the next point
+                    for (uint64_t c = nColumn + 1; c < col; ++c)
+                    {
+                        size_t idx      = c % nColumns;
+                        vMin[idx]       = src[0];
+                        vMax[idx]       = src[0];
+                    }
+
+                    // Start new column
+                    size_t idx      = col % nColumns;
+                    vMin[idx]       = vmin;
+                    vMax[idx]       = vmax;
+                    nColumn         = col;
+                }
+                else
+                {
+                    // Update current column
+                    size_t idx      = col % nColumns;
+                    vMin[idx]       = lsp_min(vMin[idx], vmin);
+                    vMax[idx]       = lsp_max(vMax[idx], vmax);
+                }
+
+                nPosition      += to_do;
+                src            += to_do;
+                count          -= to_do;
+            }
+        }
+
+        void GraphDecimator::get(float *min, float *max) const
+        {
+            if (nColumns <= 0)
+                return;
+
+            // The ring is written circularly, the most recent column is nColumn
+            size_t head     = (nColumn + 1) % nColumns;
+            size_t tail     = nColumns - head;
+
+            dsp::copy(min, &vMin[head], tail);
+            dsp::copy(&min[tail], vMin, head);
+            dsp::copy(max, &vMax[head], tail);
+            dsp::copy(&max[tail], vMax, head);
+        }
+
+        void GraphDecimator::dump(dspu::IStateDumper *v) const
+        {
+            v->write("vMin", vMin);
+            v->write("vMax", vMax);
+            v->write("nColumns", nColumns);
+            v->write("nPoints", nPoints);
+            v->write("nPosition", nPosition);
+            v->write("nColumn", nColumn);
+            v->write("pData", pData);
+        }
+
+    } /* namespace plugins */
+} /* namespace lsp */
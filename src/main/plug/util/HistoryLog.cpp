@@ -0,0 +1,403 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-plugins-autogain
+ * Created on: 18 окт 2026 г.
+ *
+ * lsp-plugins-autogain is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-plugins-autogain is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-plugins-autogain. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <lsp-plug.in/common/debug.h>
+#include <lsp-plug.in/runtime/LSPString.h>
+#include <lsp-plug.in/runtime/system.h>
+
+#include <stdio.h>
+#include <string.h>
+
+#include <private/util/HistoryLog.h>
+
+#ifdef PLATFORM_WINDOWS
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif /* PLATFORM_WINDOWS */
+
+namespace lsp
+{
+    namespace plugins
+    {
+        static constexpr size_t HISTORY_LOG_FILE_SIZE   =
+            sizeof(history_log_header_t) + HISTORY_LOG_RECORDS * sizeof(history_log_record_t);
+
+        HistoryLog::HistoryLog(HistoryLogRing *ring, HistoryLogRing *replay)
+        {
+            pRing           = ring;
+            pReplay         = replay;
+            pHeader         = NULL;
+            vRecords        = NULL;
+            hFile           = NULL;
+            hMapping        = NULL;
+            nReplayPos      = 0;
+            nReplayEnd      = 0;
+            nReplayTime     = 0;
+            bReplayEnd      = false;
+            pRequest        = NULL;
+            nReopen         = 0;
+            nCancel         = 0;
+            sPath[0]        = '\0';
+        }
+
+        HistoryLog::~HistoryLog()
+        {
+            close_file();
+        }
+
+        void HistoryLog::set_file(const char *path)
+        {
+            if (path == NULL)
+                path                    = "";
+
+            pRequest                = path;
+            atomic_store(&nReopen, 1);
+        }
+
+        void HistoryLog::close()
+        {
+            // The task may be still submitted or running, the file should not be touched until it completes
+            atomic_store(&nCancel, 1);
+            const bool finished     = wait_task(this);
+            atomic_store(&nCancel, 0);
+            if (!finished)
+            {
+                // The mapping is left to the task, it is released with the process
+                lsp_warn("History log writer did not finish in time, leaving file %s to the task", sPath);
+                pHeader                 = NULL;
+                vRecords                = NULL;
+                hFile                   = NULL;
+                hMapping                = NULL;
+                return;
+            }
+
+            close_file();
+            sPath[0]                = '\0';
+            pRequest                = NULL;
+            atomic_store(&nReopen, 0);
+        }
+
+    #ifdef PLATFORM_WINDOWS
+        status_t HistoryLog::map_file(bool *created)
+        {
+            LSPString path;
+            if (!path.set_utf8(sPath))
+                return STATUS_NO_MEM;
+
+            HANDLE fd       = CreateFileW(
+                reinterpret_cast<LPCWSTR>(path.get_utf16()),
+                GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ,
+                NULL, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+            if (fd == INVALID_HANDLE_VALUE)
+                return STATUS_IO_ERROR;
+
+            LARGE_INTEGER size;
+            if (!GetFileSizeEx(fd, &size))
+            {
+                CloseHandle(fd);
+                return STATUS_IO_ERROR;
+            }
+            *created        = size.QuadPart == 0;
+
+            HANDLE map      = CreateFileMappingW(fd, NULL, PAGE_READWRITE,
+                DWORD(uint64_t(HISTORY_LOG_FILE_SIZE) >> 32), DWORD(HISTORY_LOG_FILE_SIZE & 0xffffffff), NULL);
+            if (map == NULL)
+            {
+                CloseHandle(fd);
+                return STATUS_IO_ERROR;
+            }
+
+            void *addr      = MapViewOfFile(map, FILE_MAP_ALL_ACCESS, 0, 0, HISTORY_LOG_FILE_SIZE);
+            if (addr == NULL)
+            {
+                CloseHandle(map);
+                CloseHandle(fd);
+                return STATUS_IO_ERROR;
+            }
+
+            hFile           = fd;
+            hMapping        = map;
+            pHeader         = static_cast<history_log_header_t *>(addr);
+
+            return STATUS_OK;
+        }
+
+        void HistoryLog::unmap_file(bool sync)
+        {
+            if (pHeader != NULL)
+            {
+                if (sync)
+                    FlushViewOfFile(pHeader, 0);
+                UnmapViewOfFile(pHeader);
+                pHeader         = NULL;
+            }
+            if (hMapping != NULL)
+            {
+                CloseHandle(static_cast<HANDLE>(hMapping));
+                hMapping        = NULL;
+            }
+            if (hFile != NULL)
+            {
+                if (sync)
+                    FlushFileBuffers(static_cast<HANDLE>(hFile));
+                CloseHandle(static_cast<HANDLE>(hFile));
+                hFile           = NULL;
+            }
+        }
+    #else
+        status_t HistoryLog::map_file(bool *created)
+        {
+            int fd          = ::open(sPath, O_RDWR | O_CREAT, 0644);
+            if (fd < 0)
+                return STATUS_IO_ERROR;
+
+            struct stat st;
+            if (fstat(fd, &st) != 0)
+            {
+                ::close(fd);
+                return STATUS_IO_ERROR;
+            }
+            *created        = st.st_size == 0;
+
+            // The file is sparse until the records are written
+            if ((size_t(st.st_size) < HISTORY_LOG_FILE_SIZE) && (ftruncate(fd, HISTORY_LOG_FILE_SIZE) != 0))
+            {
+                ::close(fd);
+                return STATUS_IO_ERROR;
+            }
+
+            void *addr      = mmap(NULL, HISTORY_LOG_FILE_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+            if (addr == MAP_FAILED)
+            {
+                ::close(fd);
+                return STATUS_IO_ERROR;
+            }
+
+            hFile           = reinterpret_cast<void *>(ptrdiff_t(fd) + 1);
+            pHeader         = static_cast<history_log_header_t *>(addr);
+
+            return STATUS_OK;
+        }
+
+        void HistoryLog::unmap_file(bool sync)
+        {
+            if (pHeader != NULL)
+            {
+                if (sync)
+                    msync(pHeader, HISTORY_LOG_FILE_SIZE, MS_SYNC);
+                munmap(pHeader, HISTORY_LOG_FILE_SIZE);
+                pHeader         = NULL;
+            }
+            if (hFile != NULL)
+            {
+                ::close(int(reinterpret_cast<ptrdiff_t>(hFile) - 1));
+                hFile           = NULL;
+            }
+        }
+    #endif /* PLATFORM_WINDOWS */
+
+        status_t HistoryLog::open_file()
+        {
+            close_file();
+            if (sPath[0] == '\0')
+                return STATUS_OK;
+
+            bool created    = false;
+            status_t res    = map_file(&created);
+            if (res != STATUS_OK)
+            {
+                lsp_warn("Could not open history log file %s, error code: %d", sPath, int(res));
+                return res;
+            }
+
+            history_log_header_t *hdr   = pHeader;
+            if (created)
+            {
+                memset(hdr, 0, sizeof(history_log_header_t));
+                hdr->nMagic             = HISTORY_LOG_MAGIC;
+                hdr->nVersion           = HISTORY_LOG_VERSION;
+                hdr->nRecordSize        = sizeof(history_log_record_t);
+                hdr->nCapacity          = HISTORY_LOG_RECORDS;
+                hdr->nCount             = 0;
+            }
+            else if ((hdr->nMagic != HISTORY_LOG_MAGIC) ||
+                (hdr->nVersion != HISTORY_LOG_VERSION) ||
+                (hdr->nRecordSize != sizeof(history_log_record_t)) ||
+                (hdr->nCapacity != HISTORY_LOG_RECORDS) ||
+                (hdr->nCount > HISTORY_LOG_RECORDS))
+            {
+                lsp_warn("File %s is not a valid history log file", sPath);
+                unmap_file(false);
+                return STATUS_BAD_FORMAT;
+            }
+
+            vRecords                = reinterpret_cast<history_log_record_t *>(&hdr[1]);
+
+            // Replay the records previously written to the file, the replay is completed
+            // by the marker which holds the current time
+            nReplayPos              = 0;
+            nReplayEnd              = hdr->nCount;
+            if (nReplayEnd > 0)
+            {
+                nReplayTime             = system::get_time_millis();
+                bReplayEnd              = true;
+            }
+
+            return STATUS_OK;
+        }
+
+        void HistoryLog::close_file()
+        {
+            // The pending end marker is still passed if the replay is interrupted
+            unmap_file(true);
+            vRecords                = NULL;
+            nReplayPos              = 0;
+            nReplayEnd              = 0;
+        }
+
+        status_t HistoryLog::rotate_file()
+        {
+            close_file();
+
+            char path[PATH_MAX];
+            snprintf(path, sizeof(path), "%s.1", sPath);
+            ::remove(path);
+            if (::rename(sPath, path) != 0)
+            {
+                lsp_warn("Could not rename history log file %s to %s", sPath, path);
+                return STATUS_IO_ERROR;
+            }
+
+            return open_file();
+        }
+
+        void HistoryLog::replay()
+        {
+            if (pReplay == NULL)
+                return;
+
+            while (nReplayPos < nReplayEnd)
+            {
+                history_log_record_t rec    = vRecords[nReplayPos];
+                rec.nFlags                  = 0;
+                if (!pReplay->push(&rec))
+                    return;
+                ++nReplayPos;
+            }
+
+            if (bReplayEnd)
+            {
+                history_log_record_t rec;
+                memset(&rec, 0, sizeof(rec));
+                rec.nTime                   = nReplayTime;
+                rec.nFlags                  = HLF_REPLAY_END;
+                if (pReplay->push(&rec))
+                    bReplayEnd                  = false;
+            }
+        }
+
+        status_t HistoryLog::run()
+        {
+            status_t res = STATUS_OK;
+
+            // Re-open the file if it has been changed
+            if (atomic_load(&nReopen))
+            {
+                strncpy(sPath, pRequest, PATH_MAX - 1);
+                sPath[PATH_MAX - 1]     = '\0';
+                pRequest                = NULL;
+                atomic_store(&nReopen, 0);
+                res                     = open_file();
+            }
+
+            // Pass the previously stored records to the audio thread
+            replay();
+
+            // Append records to the file, the records are stamped with the time here
+            // to keep the system call out of the audio thread
+            uint64_t time           = system::get_time_millis();
+            while (!atomic_load(&nCancel))
+            {
+                size_t count            = pRing->pop(vBatch, BATCH_SIZE);
+                if (count <= 0)
+                    break;
+                if (pHeader == NULL)
+                    continue;
+
+                for (size_t i=0; i<count; ++i)
+                {
+                    if (vBatch[i].nTime == 0)
+                        vBatch[i].nTime         = time;
+                }
+
+                for (size_t i=0; i<count; )
+                {
+                    if (pHeader->nCount >= HISTORY_LOG_RECORDS)
+                    {
+                        if ((res = rotate_file()) != STATUS_OK)
+                            break;
+                    }
+
+                    size_t to_do            = lsp_min(count - i, size_t(HISTORY_LOG_RECORDS - pHeader->nCount));
+                    memcpy(&vRecords[pHeader->nCount], &vBatch[i], to_do * sizeof(history_log_record_t));
+
+                    // Publish the records after they have been written
+                    pHeader->nCount        += to_do;
+                    i                      += to_do;
+                }
+            }
+
+            // Schedule the write-back of the modified pages
+        #ifdef PLATFORM_WINDOWS
+            if (pHeader != NULL)
+                FlushViewOfFile(pHeader, 0);
+        #else
+            if (pHeader != NULL)
+                msync(pHeader, HISTORY_LOG_FILE_SIZE, MS_ASYNC);
+        #endif /* PLATFORM_WINDOWS */
+
+            return res;
+        }
+
+        void HistoryLog::dump(dspu::IStateDumper *v) const
+        {
+            v->write("pRing", pRing);
+            v->write("pReplay", pReplay);
+            v->write("pHeader", pHeader);
+            v->write("vRecords", vRecords);
+            v->write("hFile", hFile);
+            v->write("hMapping", hMapping);
+            v->write("nReplayPos", nReplayPos);
+            v->write("nReplayEnd", nReplayEnd);
+            v->write("nReplayTime", nReplayTime);
+            v->write("bReplayEnd", bReplayEnd);
+            v->write("pRequest", pRequest);
+            v->write("nReopen", nReopen);
+            v->write("nCancel", nCancel);
+            v->write("sPath", sPath);
+        }
+
+    } /* namespace plugins */
+} /* namespace lsp */
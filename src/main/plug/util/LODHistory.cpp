@@ -0,0 +1,269 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-plugins-autogain
+ * Created on: 18 окт 2026 г.
+ *
+ * lsp-plugins-autogain is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-plugins-autogain is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-plugins-autogain. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <lsp-plug.in/common/alloc.h>
+#include <lsp-plug.in/dsp/dsp.h>
+#include <private/util/LODHistory.h>
+
+namespace lsp
+{
+    namespace plugins
+    {
+        LODHistory::LODHistory()
+        {
+            for (size_t i=0; i<LEVELS_MAX; ++i)
+            {
+                level_t *l      = &vLevels[i];
+                l->vMax         = NULL;
+                l->nHead        = 0;
+                l->nFactor      = 1;
+                l->nCount       = 0;
+                l->fMax         = 0.0f;
+            }
+
+            nLevels         = 0;
+            nPoints         = 0;
+            nPeriod         = 1;
+            nCounter        = 0;
+            fMax            = 0.0f;
+            pData           = NULL;
+        }
+
+        LODHistory::~LODHistory()
+        {
+            destroy();
+        }
+
+        status_t LODHistory::init(size_t points, const size_t *factors, size_t levels)
+        {
+            if ((points <= 0) || (levels <= 0) || (levels > LEVELS_MAX))
+                return STATUS_INVALID_VALUE;
+
+            size_t szof_ring    = align_size(points * sizeof(float), DEFAULT_ALIGN);
+            uint8_t *data       = NULL;
+            uint8_t *ptr        = alloc_aligned<uint8_t>(data, szof_ring * levels, DEFAULT_ALIGN);
+            if (ptr == NULL)
+                return STATUS_NO_MEM;
+
+            destroy();
+
+            for (size_t i=0; i<levels; ++i)
+            {
+                level_t *l      = &vLevels[i];
+                l->vMax         = advance_ptr_bytes<float>(ptr, szof_ring);
+                l->nFactor      = lsp_max(factors[i], 1U);
+            }
+
+            nLevels         = levels;
+            nPoints         = points;
+            pData           = data;
+            clear();
+
+            return STATUS_OK;
+        }
+
+        void LODHistory::destroy()
+        {
+            if (pData != NULL)
+            {
+                free_aligned(pData);
+                pData           = NULL;
+            }
+
+            for (size_t i=0; i<LEVELS_MAX; ++i)
+            {
+                level_t *l      = &vLevels[i];
+                l->vMax         = NULL;
+            }
+
+            nLevels         = 0;
+            nPoints         = 0;
+        }
+
+        void LODHistory::set_period(size_t period)
+        {
+            nPeriod         = lsp_max(period, 1U);
+            clear();
+        }
+
+        void LODHistory::clear()
+        {
+            for (size_t i=0; i<nLevels; ++i)
+            {
+                level_t *l      = &vLevels[i];
+                dsp::fill_zero(l->vMax, nPoints);
+                l->nHead        = 0;
+                l->nCount       = 0;
+                l->fMax         = 0.0f;
+            }
+
+            nCounter        = 0;
+            fMax            = 0.0f;
+        }
+
+        void LODHistory::store(level_t *l, float max, size_t count)
+        {
+            // Storing more points than the ring holds overwrites all of them
+            if (count >= nPoints)
+            {
+                dsp::fill(l->vMax, max, nPoints);
+                l->nHead            = (l->nHead + count) % nPoints;
+                return;
+            }
+
+            for (size_t i=0; i<count; ++i)
+            {
+                l->vMax[l->nHead]   = max;
+                l->nHead            = (l->nHead + 1) % nPoints;
+            }
+        }
+
+        void LODHistory::append_level(size_t index, float max, size_t count)
+        {
+            for ( ; (index < nLevels) && (count > 0); ++index)
+            {
+                level_t *l      = &vLevels[index];
+
+                // Complete the current point of the level
+                if (l->nCount > 0)
+                {
+                    size_t to_do    = lsp_min(count, l->nFactor - l->nCount);
+                    l->fMax         = lsp_max(l->fMax, max);
+                    l->nCount      += to_do;
+                    count          -= to_do;
+                    if (l->nCount < l->nFactor)
+                        return;
+
+                    // The point is complete, store it and pass to the next level
+                    store(l, l->fMax, 1);
+                    l->nCount       = 0;
+                    append_level(index + 1, l->fMax, 1);
+                }
+
+                // Store complete points, they are passed to the next level
+                size_t full     = count / l->nFactor;
+                store(l, max, full);
+
+                // Start the next point with the remaining values
+                l->nCount       = count - full * l->nFactor;
+                l->fMax         = max;
+                count           = full;
+            }
+        }
+
+        void LODHistory::append(float max, size_t dots)
+        {
+            append_level(0, max, dots);
+        }
+
+        void LODHistory::append(const LODHistory *src, size_t dots, float *buf)
+        {
+            if ((src->nLevels <= 0) || (dots <= 0))
+                return;
+
+            // Find the finest level that covers all dots
+            size_t level    = 0;
+            size_t step     = src->vLevels[0].nFactor;
+            while (((step * src->nPoints) < dots) && ((level + 1) < src->nLevels))
+            {
+                ++level;
+                step           *= src->vLevels[level].nFactor;
+            }
+
+            // Read the points and append them, the oldest point takes the remainder
+            size_t count    = lsp_min((dots + step - 1) / step, src->nPoints);
+            src->read(level, buf, count);
+
+            size_t first    = (dots > (count - 1) * step) ? dots - (count - 1) * step : 1;
+            append(buf[0], first);
+            for (size_t i=1; i<count; ++i)
+                append(buf[i], step);
+        }
+
+        void LODHistory::process(const float *src, size_t count)
+        {
+            if (nLevels <= 0)
+                return;
+
+            while (count > 0)
+            {
+                size_t to_do    = lsp_min(count, nPeriod - nCounter);
+                float vmax      = dsp::max(src, to_do);
+
+                fMax            = (nCounter <= 0) ? vmax : lsp_max(fMax, vmax);
+                nCounter       += to_do;
+                if (nCounter >= nPeriod)
+                {
+                    append(fMax, 1);
+                    nCounter        = 0;
+                }
+
+                src            += to_do;
+                count          -= to_do;
+            }
+        }
+
+        void LODHistory::read(size_t level, float *max, size_t count) const
+        {
+            if (level >= nLevels)
+                return;
+
+            const level_t *l    = &vLevels[level];
+            count               = lsp_min(count, nPoints);
+
+            // Compute the position of the oldest point to read
+            size_t tail         = (l->nHead + nPoints - count) % nPoints;
+            size_t part         = lsp_min(count, nPoints - tail);
+
+            dsp::copy(max, &l->vMax[tail], part);
+            dsp::copy(&max[part], l->vMax, count - part);
+        }
+
+        void LODHistory::dump(dspu::IStateDumper *v) const
+        {
+            v->begin_array("vLevels", vLevels, nLevels);
+            {
+                for (size_t i=0; i<nLevels; ++i)
+                {
+                    const level_t *l    = &vLevels[i];
+                    v->begin_object(l, sizeof(level_t));
+                    {
+                        v->write("vMax", l->vMax);
+                        v->write("nHead", l->nHead);
+                        v->write("nFactor", l->nFactor);
+                        v->write("nCount", l->nCount);
+                        v->write("fMax", l->fMax);
+                    }
+                    v->end_object();
+                }
+            }
+            v->end_array();
+
+            v->write("nLevels", nLevels);
+            v->write("nPoints", nPoints);
+            v->write("nPeriod", nPeriod);
+            v->write("nCounter", nCounter);
+            v->write("fMax", fMax);
+            v->write("pData", pData);
+        }
+
+    } /* namespace plugins */
+} /* namespace lsp */
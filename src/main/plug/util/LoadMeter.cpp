@@ -0,0 +1,149 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-plugins-autogain
+ * Created on: 18 окт 2026 г.
+ *
+ * lsp-plugins-autogain is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-plugins-autogain is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-plugins-autogain. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <private/util/LoadMeter.h>
+
+#include <math.h>
+
+#ifdef PLATFORM_WINDOWS
+    #include <windows.h>
+#else
+    #include <time.h>
+#endif /* PLATFORM_WINDOWS */
+
+namespace lsp
+{
+    namespace plugins
+    {
+        uint64_t monotonic_nanos()
+        {
+        #ifdef PLATFORM_WINDOWS
+            LARGE_INTEGER freq, counter;
+            QueryPerformanceFrequency(&freq);
+            QueryPerformanceCounter(&counter);
+            return uint64_t(double(counter.QuadPart) * 1e+9 / double(freq.QuadPart));
+        #else
+            struct timespec ts;
+            clock_gettime(CLOCK_MONOTONIC, &ts);
+            return uint64_t(ts.tv_sec) * 1000000000ULL + uint64_t(ts.tv_nsec);
+        #endif /* PLATFORM_WINDOWS */
+        }
+
+        LoadMeter::LoadMeter()
+        {
+            nStart          = 0;
+            nPending        = 0;
+            nSampleRate     = 0;
+
+            reset();
+        }
+
+        void LoadMeter::reset()
+        {
+            fLoad           = 0.0f;
+            fPeak           = 0.0f;
+            nIntTime        = 0;
+            nIntSamples     = 0;
+            nBlocks         = 0;
+            nOverruns       = 0;
+            for (size_t i=0; i<BUCKETS; ++i)
+                vHistogram[i]   = 0;
+        }
+
+        void LoadMeter::account(uint64_t start)
+        {
+            nPending       += monotonic_nanos() - start;
+        }
+
+        void LoadMeter::end(size_t samples)
+        {
+            uint64_t elapsed    = monotonic_nanos() - nStart + nPending;
+            if ((samples <= 0) || (nSampleRate <= 0))
+            {
+                // Nothing to compare with, account the time to the next block
+                nPending            = elapsed;
+                return;
+            }
+            nPending            = 0;
+
+            // Compute the load relative to the deadline
+            double deadline     = double(samples) * 1e+9 / double(nSampleRate);
+            float load          = float(double(elapsed) / deadline);
+
+            fLoad               = load;
+            fPeak               = lsp_max(fPeak, load);
+            nIntTime           += elapsed;
+            nIntSamples        += samples;
+            ++nBlocks;
+            if (load > 1.0f)
+                ++nOverruns;
+
+            // Update the histogram
+            ssize_t index       = 0;
+            if (load > 0.0f)
+            {
+                int exp             = 0;
+                frexpf(load, &exp);
+                index               = lsp_limit(ssize_t(exp) + ssize_t(BUCKET_ONE), ssize_t(0), ssize_t(BUCKETS - 1));
+            }
+            if ((++vHistogram[index]) >= BUCKET_MAX)
+            {
+                for (size_t i=0; i<BUCKETS; ++i)
+                    vHistogram[i]     >>= 1;
+            }
+        }
+
+        float LoadMeter::interval_load() const
+        {
+            if ((nIntSamples <= 0) || (nSampleRate <= 0))
+                return fLoad;
+
+            const double deadline   = double(nIntSamples) * 1e+9 / double(nSampleRate);
+            return float(double(nIntTime) / deadline);
+        }
+
+        void LoadMeter::reset_interval()
+        {
+            nIntTime        = 0;
+            nIntSamples     = 0;
+        }
+
+        float LoadMeter::bucket_limit(size_t index)
+        {
+            return ldexpf(1.0f, int(index) - int(BUCKET_ONE));
+        }
+
+        void LoadMeter::dump(dspu::IStateDumper *v) const
+        {
+            v->write("nStart", nStart);
+            v->write("nPending", nPending);
+            v->write("nSampleRate", nSampleRate);
+            v->write("fLoad", fLoad);
+            v->write("fPeak", fPeak);
+            v->write("nIntTime", nIntTime);
+            v->write("nIntSamples", nIntSamples);
+            v->write("nBlocks", nBlocks);
+            v->write("nOverruns", nOverruns);
+            v->writev("vHistogram", vHistogram, BUCKETS);
+        }
+
+    } /* namespace plugins */
+} /* namespace lsp */
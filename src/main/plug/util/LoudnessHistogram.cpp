@@ -0,0 +1,147 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-plugins-autogain
+ * Created on: 18 окт 2026 г.
+ *
+ * lsp-plugins-autogain is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-plugins-autogain is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-plugins-autogain. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <lsp-plug.in/common/types.h>
+#include <private/util/LoudnessHistogram.h>
+
+#include <math.h>
+
+namespace lsp
+{
+    namespace plugins
+    {
+        LoudnessHistogram::LoudnessHistogram()
+        {
+            clear();
+        }
+
+        void LoudnessHistogram::clear()
+        {
+            nCount          = 0;
+            fEnergy         = 0.0;
+            for (size_t i=0; i<BINS; ++i)
+                vBins[i]        = 0;
+        }
+
+        void LoudnessHistogram::add(float gain)
+        {
+            if (gain <= 0.0f)
+                return;
+
+            // Apply the absolute gate
+            const float level   = 20.0f * log10f(gain);
+            if (level < LEVEL_MIN)
+                return;
+
+            const ssize_t index = lsp_limit(ssize_t((level - LEVEL_MIN) / BIN_STEP), ssize_t(0), ssize_t(BINS - 1));
+            ++vBins[index];
+            ++nCount;
+            fEnergy        += double(gain) * double(gain);
+        }
+
+        double LoudnessHistogram::bin_energy(size_t index)
+        {
+            // Energy at the center of the bin
+            return pow(10.0, (LEVEL_MIN + (double(index) + 0.5) * BIN_STEP) * 0.1);
+        }
+
+        ssize_t LoudnessHistogram::gate_bin(float gate) const
+        {
+            if (nCount <= 0)
+                return -1;
+
+            // The relative gate is computed from the exact energy of the blocks above the absolute gate,
+            // the bins which have the center below the relative gate are excluded
+            const double level  = 10.0 * log10(fEnergy / double(nCount)) + gate;
+            const double index  = ceil((level - LEVEL_MIN) / BIN_STEP - 0.5);
+
+            return lsp_limit(ssize_t(index), ssize_t(0), ssize_t(BINS));
+        }
+
+        float LoudnessHistogram::integrated(float gate) const
+        {
+            const ssize_t first = gate_bin(gate);
+            if (first < 0)
+                return LEVEL_MIN;
+
+            const double step   = pow(10.0, BIN_STEP * 0.1);
+            double energy       = bin_energy(first);
+            double sum          = 0.0;
+            uint64_t count      = 0;
+
+            for (size_t i=first; i<BINS; ++i, energy *= step)
+            {
+                count              += vBins[i];
+                sum                += double(vBins[i]) * energy;
+            }
+            if (count <= 0)
+                return LEVEL_MIN;
+
+            return lsp_max(float(10.0 * log10(sum / double(count))), LEVEL_MIN);
+        }
+
+        float LoudnessHistogram::range(float gate, float low, float high) const
+        {
+            const ssize_t first = gate_bin(gate);
+            if (first < 0)
+                return 0.0f;
+
+            uint64_t total      = 0;
+            for (size_t i=first; i<BINS; ++i)
+                total              += vBins[i];
+            if (total <= 0)
+                return 0.0f;
+
+            // Lookup for the bins containing the percentiles
+            const double t_low  = double(low) * double(total);
+            const double t_high = double(high) * double(total);
+            ssize_t i_low       = -1;
+            ssize_t i_high      = -1;
+            uint64_t count      = 0;
+
+            for (size_t i=first; i<BINS; ++i)
+            {
+                if (vBins[i] <= 0)
+                    continue;
+                count              += vBins[i];
+                if ((i_low < 0) && (double(count) >= t_low))
+                    i_low               = i;
+                if (double(count) >= t_high)
+                {
+                    i_high              = i;
+                    break;
+                }
+            }
+            if ((i_low < 0) || (i_high < 0))
+                return 0.0f;
+
+            return float(i_high - i_low) * BIN_STEP;
+        }
+
+        void LoudnessHistogram::dump(dspu::IStateDumper *v) const
+        {
+            v->write("nCount", nCount);
+            v->write("fEnergy", fEnergy);
+            v->writev("vBins", vBins, BINS);
+        }
+
+    } /* namespace plugins */
+} /* namespace lsp */
@@ -0,0 +1,229 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-plugins-autogain
+ * Created on: 18 окт 2026 г.
+ *
+ * lsp-plugins-autogain is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-plugins-autogain is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-plugins-autogain. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <lsp-plug.in/common/alloc.h>
+#include <lsp-plug.in/dsp/dsp.h>
+
+#include <private/util/MeterDecimator.h>
+
+#include <math.h>
+
+namespace lsp
+{
+    namespace plugins
+    {
+        MeterDecimator::MeterDecimator()
+        {
+            nChannels       = 0;
+            nBlock          = 0;
+            nStages         = 0;
+            vChannels       = NULL;
+            vEven           = NULL;
+            vOdd            = NULL;
+            pData           = NULL;
+
+            // Compute the even phase of the Blackman-windowed half-band kernel. The kernel has
+            // (KERNEL * 2 - 1) taps, the central tap is 0.5 and falls to the odd phase,
+            // all other taps of the odd phase are zero.
+            double sum      = 0.0;
+            for (size_t k=0; k<KERNEL; ++k)
+            {
+                const double n  = double(ssize_t(k * 2) - ssize_t(KERNEL - 1));
+                const double a  = M_PI * n / double(KERNEL);
+                const double w  = 0.42 + 0.5 * cos(a) + 0.08 * cos(2.0 * a);
+                const double h  = sin(M_PI * n * 0.5) / (M_PI * n) * w;
+                vKernel[k]      = float(h);
+                sum            += h;
+            }
+
+            // Normalize the kernel to have unity gain at DC
+            const double norm = 0.5 / sum;
+            for (size_t k=0; k<KERNEL; ++k)
+                vKernel[k]     *= float(norm);
+        }
+
+        MeterDecimator::~MeterDecimator()
+        {
+            destroy();
+        }
+
+        status_t MeterDecimator::init(size_t channels, size_t max_block)
+        {
+            size_t half             = max_block / 2 + 1;
+            size_t szof_channels    = align_size(sizeof(channel_t) * channels, DEFAULT_ALIGN);
+            size_t szof_half        = align_size(sizeof(float) * half, DEFAULT_ALIGN);
+            size_t szof_acc         = align_size(sizeof(float) * (half + KERNEL), DEFAULT_ALIGN);
+            size_t to_alloc         =
+                szof_channels +
+                szof_half * 2 +
+                (szof_half + szof_acc * STAGES_MAX) * channels;
+
+            uint8_t *data           = NULL;
+            uint8_t *ptr            = alloc_aligned<uint8_t>(data, to_alloc, DEFAULT_ALIGN);
+            if (ptr == NULL)
+                return STATUS_NO_MEM;
+
+            // Drop previously allocated data
+            destroy();
+
+            vChannels               = advance_ptr_bytes<channel_t>(ptr, szof_channels);
+            vEven                   = advance_ptr_bytes<float>(ptr, szof_half);
+            vOdd                    = advance_ptr_bytes<float>(ptr, szof_half);
+            for (size_t i=0; i<channels; ++i)
+            {
+                channel_t *c            = &vChannels[i];
+                c->vOut                 = advance_ptr_bytes<float>(ptr, szof_half);
+                for (size_t j=0; j<STAGES_MAX; ++j)
+                    c->vAcc[j]              = advance_ptr_bytes<float>(ptr, szof_acc);
+            }
+
+            nChannels               = channels;
+            nBlock                  = max_block;
+            pData                   = data;
+
+            clear();
+
+            return STATUS_OK;
+        }
+
+        void MeterDecimator::destroy()
+        {
+            if (pData != NULL)
+            {
+                free_aligned(pData);
+                pData                   = NULL;
+            }
+
+            vChannels               = NULL;
+            vEven                   = NULL;
+            vOdd                    = NULL;
+            nChannels               = 0;
+            nBlock                  = 0;
+        }
+
+        void MeterDecimator::set_stages(size_t stages)
+        {
+            stages                  = lsp_min(stages, STAGES_MAX);
+            if (stages == nStages)
+                return;
+
+            nStages                 = stages;
+            clear();
+        }
+
+        void MeterDecimator::clear()
+        {
+            const size_t half       = nBlock / 2 + 1;
+            for (size_t i=0; i<nChannels; ++i)
+            {
+                channel_t *c            = &vChannels[i];
+                dsp::fill_zero(c->vOut, half);
+                for (size_t j=0; j<STAGES_MAX; ++j)
+                {
+                    dsp::fill_zero(c->vAcc[j], half + KERNEL);
+                    c->vCarry[j]            = 0.0f;
+                    c->bCarry[j]            = false;
+                }
+            }
+        }
+
+        size_t MeterDecimator::decimate(channel_t *c, size_t stage, float *dst, const float *src, size_t count)
+        {
+            // Split the input into even and odd samples, the unpaired sample of the previous block goes first
+            size_t pairs            = 0;
+            if ((c->bCarry[stage]) && (count > 0))
+            {
+                vEven[0]                = c->vCarry[stage];
+                vOdd[0]                 = *(src++);
+                c->bCarry[stage]        = false;
+                --count;
+                ++pairs;
+            }
+            for ( ; count >= 2; count -= 2, src += 2, ++pairs)
+            {
+                vEven[pairs]            = src[0];
+                vOdd[pairs]             = src[1];
+            }
+            if (count > 0)
+            {
+                c->vCarry[stage]        = src[0];
+                c->bCarry[stage]        = true;
+            }
+            if (pairs <= 0)
+                return 0;
+
+            // Apply the kernel: the even phase is convolved, the central tap is applied to the odd phase
+            float *acc              = c->vAcc[stage];
+            dsp::convolve(acc, vEven, vKernel, KERNEL, pairs);
+            dsp::fmadd_k3(&acc[HALF_TAPS], vOdd, 0.5f, pairs);
+
+            // Output the result and move the tail to the head of the accumulator
+            dsp::copy(dst, acc, pairs);
+            dsp::move(acc, &acc[pairs], KERNEL - 1);
+            dsp::fill_zero(&acc[KERNEL - 1], pairs);
+
+            return pairs;
+        }
+
+        size_t MeterDecimator::process(size_t channel, const float *src, size_t count)
+        {
+            channel_t *c            = &vChannels[channel];
+            if (nStages <= 0)
+                return 0;
+
+            // The source data is completely split before the output is written, so
+            // the next stages can be processed in place
+            count                   = decimate(c, 0, c->vOut, src, count);
+            for (size_t i=1; i<nStages; ++i)
+                count                   = decimate(c, i, c->vOut, c->vOut, count);
+
+            return count;
+        }
+
+        void MeterDecimator::dump(dspu::IStateDumper *v) const
+        {
+            v->write("nChannels", nChannels);
+            v->write("nBlock", nBlock);
+            v->write("nStages", nStages);
+            v->begin_array("vChannels", vChannels, nChannels);
+            {
+                for (size_t i=0; i<nChannels; ++i)
+                {
+                    const channel_t *c      = &vChannels[i];
+                    v->begin_object(c, sizeof(channel_t));
+                    {
+                        v->write("vOut", c->vOut);
+                        v->writev("vAcc", c->vAcc, STAGES_MAX);
+                        v->writev("vCarry", c->vCarry, STAGES_MAX);
+                        v->writev("bCarry", c->bCarry, STAGES_MAX);
+                    }
+                    v->end_object();
+                }
+            }
+            v->end_array();
+            v->write("vEven", vEven);
+            v->write("vOdd", vOdd);
+            v->writev("vKernel", vKernel, KERNEL);
+            v->write("pData", pData);
+        }
+
+    } /* namespace plugins */
+} /* namespace lsp */
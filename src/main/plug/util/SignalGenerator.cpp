@@ -0,0 +1,365 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-plugins-autogain
+ * Created on: 18 окт 2026 г.
+ *
+ * lsp-plugins-autogain is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-plugins-autogain is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-plugins-autogain. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <private/util/SignalGenerator.h>
+
+#ifdef LSP_TESTING
+
+#include <lsp-plug.in/common/alloc.h>
+#include <lsp-plug.in/dsp-units/units.h>
+
+#include <math.h>
+#include <strings.h>
+
+namespace lsp
+{
+    namespace plugins
+    {
+        static const char * const scenario_names[] =
+        {
+            "none",
+            "speech",
+            "music",
+            "steps",
+            "gaps"
+        };
+
+        // Levels of the steps scenario, dB
+        static const float step_levels[] =
+        {
+            -30.0f, -10.0f, -20.0f, -40.0f, -6.0f, -24.0f
+        };
+
+        // Root frequencies and intervals of the chords used by the tone partials
+        static const float chord_roots[]    = { 110.0f, 146.83f, 130.81f, 98.0f };
+        static const float chord_ratios[]   = { 1.0f, 1.2599f, 1.4983f };
+
+        SignalGenerator::SignalGenerator()
+        {
+            enScenario      = SG_NONE;
+            nSeed           = SEED_DFL;
+            nRandom         = SEED_DFL;
+            nSampleRate     = 0;
+            nBlock          = 0;
+            nCounter        = 0;
+            nSegment        = 0;
+            nSyllables      = 0;
+            nBeat           = 0;
+            nBeatCounter    = 0;
+            nTime           = 0;
+            fNoise          = 0.0f;
+            fGain           = 0.0f;
+            fTarget         = 0.0f;
+            fSmooth         = 0.0f;
+            fBeat           = 0.0f;
+            fBeatDecay      = 0.0f;
+            for (size_t i=0; i<PARTIALS; ++i)
+            {
+                vPhase[i]       = 0.0f;
+                vStep[i]        = 0.0f;
+            }
+            vMain           = NULL;
+            vSc             = NULL;
+            pData           = NULL;
+        }
+
+        SignalGenerator::~SignalGenerator()
+        {
+            destroy();
+        }
+
+        status_t SignalGenerator::init(scenario_t scenario, size_t max_block, uint32_t seed)
+        {
+            size_t szof_buffer      = align_size(sizeof(float) * max_block, DEFAULT_ALIGN);
+
+            uint8_t *data           = NULL;
+            uint8_t *ptr            = alloc_aligned<uint8_t>(data, szof_buffer * 2, DEFAULT_ALIGN);
+            if (ptr == NULL)
+                return STATUS_NO_MEM;
+
+            // Drop previously allocated data
+            destroy();
+
+            vMain                   = advance_ptr_bytes<float>(ptr, szof_buffer);
+            vSc                     = advance_ptr_bytes<float>(ptr, szof_buffer);
+
+            enScenario              = scenario;
+            nSeed                   = (seed != 0) ? seed : SEED_DFL;
+            nBlock                  = max_block;
+            pData                   = data;
+
+            reset();
+
+            return STATUS_OK;
+        }
+
+        void SignalGenerator::destroy()
+        {
+            if (pData != NULL)
+            {
+                free_aligned(pData);
+                pData                   = NULL;
+            }
+
+            vMain                   = NULL;
+            vSc                     = NULL;
+            nBlock                  = 0;
+            enScenario              = SG_NONE;
+        }
+
+        SignalGenerator::scenario_t SignalGenerator::parse(const char *name)
+        {
+            if (name == NULL)
+                return SG_NONE;
+
+            for (size_t i=0; i<SG_TOTAL; ++i)
+            {
+                if (!strcasecmp(name, scenario_names[i]))
+                    return scenario_t(i);
+            }
+
+            return SG_NONE;
+        }
+
+        void SignalGenerator::set_sample_rate(size_t sr)
+        {
+            if (nSampleRate == sr)
+                return;
+
+            nSampleRate             = sr;
+            reset();
+        }
+
+        void SignalGenerator::reset()
+        {
+            nRandom         = nSeed;
+            nCounter        = 0;
+            nSegment        = 0;
+            nSyllables      = 0;
+            nBeatCounter    = 0;
+            nTime           = 0;
+            fNoise          = 0.0f;
+            fGain           = 0.0f;
+            fTarget         = 0.0f;
+            fBeat           = 0.0f;
+            for (size_t i=0; i<PARTIALS; ++i)
+                vPhase[i]       = 0.0f;
+
+            if (nSampleRate > 0)
+            {
+                const float sr  = float(nSampleRate);
+                fSmooth         = 1.0f - expf(-1.0f / (SMOOTH_TIME * sr));
+                fBeatDecay      = expf(-1.0f / (0.08f * sr));
+                nBeat           = seconds(0.5f);
+            }
+            set_chord(0);
+        }
+
+        inline uint32_t SignalGenerator::next()
+        {
+            // Xorshift generator
+            uint32_t x      = nRandom;
+            x              ^= x << 13;
+            x              ^= x >> 17;
+            x              ^= x << 5;
+            nRandom         = x;
+            return x;
+        }
+
+        inline float SignalGenerator::noise()
+        {
+            // Low-passed white noise with approximately unity RMS
+            const float w   = float(int32_t(next())) * (1.0f / 2147483648.0f);
+            fNoise         += (w - fNoise) * 0.25f;
+            return fNoise * 3.0f;
+        }
+
+        float SignalGenerator::uniform(float min, float max)
+        {
+            const float k   = float(next() >> 8) * (1.0f / 16777216.0f);
+            return min + (max - min) * k;
+        }
+
+        size_t SignalGenerator::seconds(float time) const
+        {
+            return lsp_max(size_t(dspu::seconds_to_samples(nSampleRate, time)), size_t(1));
+        }
+
+        void SignalGenerator::set_chord(size_t chord)
+        {
+            const float root    = chord_roots[chord % (sizeof(chord_roots) / sizeof(float))];
+            const float k       = (nSampleRate > 0) ? 2.0f * M_PI / float(nSampleRate) : 0.0f;
+            for (size_t i=0; i<PARTIALS; ++i)
+                vStep[i]            = root * chord_ratios[i] * k;
+        }
+
+        float SignalGenerator::tone()
+        {
+            float s             = 0.0f;
+            for (size_t i=0; i<PARTIALS; ++i)
+            {
+                s                  += sinf(vPhase[i]);
+                vPhase[i]          += vStep[i];
+                if (vPhase[i] >= 2.0f * M_PI)
+                    vPhase[i]          -= 2.0f * M_PI;
+            }
+            return s * (1.0f / PARTIALS);
+        }
+
+        void SignalGenerator::next_segment()
+        {
+            switch (enScenario)
+            {
+                case SG_SPEECH:
+                    if (nSyllables > 0)
+                    {
+                        // Syllable with random duration and level
+                        --nSyllables;
+                        nCounter        = seconds(uniform(0.12f, 0.3f));
+                        fTarget         = dspu::db_to_gain(uniform(-26.0f, -16.0f));
+                    }
+                    else
+                    {
+                        // Pause between words, then start the new word
+                        nSyllables      = 3 + next() % 5;
+                        nCounter        = seconds(uniform(0.2f, 1.5f));
+                        fTarget         = 0.0f;
+                        set_chord(nSegment);
+                    }
+                    break;
+
+                case SG_MUSIC:
+                    // One bar of four beats with the slightly varying level
+                    nCounter        = nBeat * 4;
+                    fTarget         = dspu::db_to_gain(uniform(-15.0f, -13.0f));
+                    set_chord(nSegment);
+                    break;
+
+                case SG_STEPS:
+                    nCounter        = seconds(5.0f);
+                    fTarget         = dspu::db_to_gain(step_levels[nSegment % (sizeof(step_levels) / sizeof(float))]);
+                    break;
+
+                case SG_GAPS:
+                    // The music-like signal is followed by the long silence gap
+                    if (nSegment & 1)
+                    {
+                        nCounter        = seconds(20.0f);
+                        fTarget         = 0.0f;
+                    }
+                    else
+                    {
+                        nCounter        = seconds(10.0f);
+                        fTarget         = dspu::db_to_gain(-14.0f);
+                        set_chord(nSegment >> 1);
+                    }
+                    break;
+
+                default:
+                    nCounter        = seconds(1.0f);
+                    fTarget         = 0.0f;
+                    break;
+            }
+
+            ++nSegment;
+        }
+
+        void SignalGenerator::process(size_t count)
+        {
+            if ((enScenario == SG_NONE) || (nSampleRate == 0))
+                return;
+
+            const size_t period = seconds(DRIFT_PERIOD);
+            const float kdrift  = 2.0f * M_PI / float(period);
+            const float kgain   = DRIFT_RANGE * M_LN10 / 20.0f;
+
+            for (size_t i=0; i<count; ++i)
+            {
+                if (nCounter == 0)
+                    next_segment();
+                --nCounter;
+                fGain              += (fTarget - fGain) * fSmooth;
+                if ((fTarget <= 0.0f) && (fGain < GAIN_MIN))
+                    fGain               = 0.0f;     // Do not decay into denormals on long silence
+
+                float s;
+                switch (enScenario)
+                {
+                    case SG_SPEECH:
+                        s               = 0.5f * noise() + tone();
+                        break;
+                    case SG_STEPS:
+                        s               = noise();
+                        break;
+                    default:
+                    {
+                        // Music: sustained chord with the percussive noise on each beat
+                        if (nBeatCounter == 0)
+                        {
+                            nBeatCounter    = nBeat;
+                            fBeat           = 1.0f;
+                        }
+                        --nBeatCounter;
+                        fBeat          *= fBeatDecay;
+                        s               = 1.4f * tone() + (0.3f + fBeat) * 0.5f * noise();
+                        break;
+                    }
+                }
+                s                  *= fGain;
+
+                // The sidechain signal drifts against the main signal
+                const float phase   = float(nTime % period) * kdrift;
+                vMain[i]            = s;
+                vSc[i]              = s * expf(kgain * sinf(phase));
+                ++nTime;
+            }
+        }
+
+        void SignalGenerator::dump(dspu::IStateDumper *v) const
+        {
+            v->write("enScenario", size_t(enScenario));
+            v->write("nSeed", nSeed);
+            v->write("nRandom", nRandom);
+            v->write("nSampleRate", nSampleRate);
+            v->write("nBlock", nBlock);
+            v->write("nCounter", nCounter);
+            v->write("nSegment", nSegment);
+            v->write("nSyllables", nSyllables);
+            v->write("nBeat", nBeat);
+            v->write("nBeatCounter", nBeatCounter);
+            v->write("nTime", nTime);
+            v->write("fNoise", fNoise);
+            v->write("fGain", fGain);
+            v->write("fTarget", fTarget);
+            v->write("fSmooth", fSmooth);
+            v->write("fBeat", fBeat);
+            v->write("fBeatDecay", fBeatDecay);
+            v->writev("vPhase", vPhase, PARTIALS);
+            v->writev("vStep", vStep, PARTIALS);
+            v->write("vMain", vMain);
+            v->write("vSc", vSc);
+            v->write("pData", pData);
+        }
+
+    } /* namespace plugins */
+} /* namespace lsp */
+
+#endif /* LSP_TESTING */
@@ -0,0 +1,190 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-plugins-autogain
+ * Created on: 18 окт 2026 г.
+ *
+ * lsp-plugins-autogain is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-plugins-autogain is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-plugins-autogain. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <private/util/StageProfiler.h>
+
+#ifdef LSP_AUTOGAIN_PROFILE
+
+#include <private/util/Trace.h>
+
+#include <lsp-plug.in/common/debug.h>
+
+#include <string.h>
+
+#if defined(LSP_AUTOGAIN_PROFILE_CACHE) && defined(PLATFORM_LINUX)
+    #include <linux/perf_event.h>
+    #include <sys/syscall.h>
+    #include <unistd.h>
+#endif
+
+namespace lsp
+{
+    namespace plugins
+    {
+        StageProfiler::StageProfiler()
+        {
+            nStart          = 0;
+            nBlocks         = 0;
+            nPending        = 0;
+            nCacheMisses    = 0;
+            nLastMisses     = 0;
+            hPerfFd         = -1;
+            nPerfThread     = 0;
+
+            reset();
+        }
+
+        StageProfiler::~StageProfiler()
+        {
+            destroy();
+        }
+
+        status_t StageProfiler::init()
+        {
+            // Opening the counter is the system call, so it is not performed by the processing thread
+            destroy();
+            open_counter();
+            reset();
+            return STATUS_OK;
+        }
+
+        void StageProfiler::destroy()
+        {
+        #if defined(LSP_AUTOGAIN_PROFILE_CACHE) && defined(PLATFORM_LINUX)
+            if (hPerfFd >= 0)
+            {
+                close(hPerfFd);
+                hPerfFd             = -1;
+            }
+        #endif /* LSP_AUTOGAIN_PROFILE_CACHE */
+            nPerfThread         = 0;
+        }
+
+        void StageProfiler::open_counter()
+        {
+            nPerfThread         = trace_thread_id();
+
+        #if defined(LSP_AUTOGAIN_PROFILE_CACHE) && defined(PLATFORM_LINUX)
+            struct perf_event_attr attr;
+            memset(&attr, 0, sizeof(attr));
+            attr.type           = PERF_TYPE_HARDWARE;
+            attr.size           = sizeof(attr);
+            attr.config         = PERF_COUNT_HW_CACHE_MISSES;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv     = 1;
+
+            // Count the cache misses of the calling thread on any CPU
+            hPerfFd             = int(syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0));
+            if (hPerfFd < 0)
+                lsp_warn("Could not open performance counter for cache misses");
+        #endif /* LSP_AUTOGAIN_PROFILE_CACHE */
+        }
+
+        void StageProfiler::reset()
+        {
+            for (size_t i=0; i<MAX_STAGES; ++i)
+            {
+                stage_t *s          = &vStages[i];
+                s->nCycles          = 0;
+                s->nCalls           = 0;
+                s->nSamples         = 0;
+            }
+
+            nBlocks             = 0;
+            nPending            = 0;
+            nCacheMisses        = 0;
+            nLastMisses         = read_cache_misses();
+        }
+
+        uint64_t StageProfiler::read_cache_misses() const
+        {
+        #if defined(LSP_AUTOGAIN_PROFILE_CACHE) && defined(PLATFORM_LINUX)
+            uint64_t value      = 0;
+            if (hPerfFd >= 0)
+            {
+                if (read(hPerfFd, &value, sizeof(value)) != sizeof(value))
+                    value               = 0;
+            }
+            return value;
+        #else
+            return 0;
+        #endif /* LSP_AUTOGAIN_PROFILE_CACHE */
+        }
+
+        void StageProfiler::update()
+        {
+            const uint64_t blocks   = nPending;
+            nPending            = 0;
+
+            // The counter counts only the thread which has opened it
+            if ((hPerfFd < 0) || (trace_thread_id() != nPerfThread))
+                return;
+
+            uint64_t misses     = read_cache_misses();
+            nCacheMisses       += misses - nLastMisses;
+            nLastMisses         = misses;
+            nBlocks            += blocks;
+        }
+
+        float StageProfiler::cache_misses_per_block() const
+        {
+            return (nBlocks > 0) ? float(double(nCacheMisses) / double(nBlocks)) : 0.0f;
+        }
+
+        float StageProfiler::cycles_per_sample(size_t stage) const
+        {
+            const stage_t *s    = &vStages[stage];
+            return (s->nSamples > 0) ? float(double(s->nCycles) / double(s->nSamples)) : 0.0f;
+        }
+
+        void StageProfiler::dump(dspu::IStateDumper *v, const char * const *names, size_t count) const
+        {
+            v->write("nStart", nStart);
+            v->write("nBlocks", nBlocks);
+            v->write("nPending", nPending);
+            v->write("nCacheMisses", nCacheMisses);
+            v->write("nLastMisses", nLastMisses);
+            v->write("fCacheMissesPerBlock", cache_misses_per_block());
+            v->write("hPerfFd", hPerfFd);
+            v->write("nPerfThread", nPerfThread);
+            v->begin_array("vStages", vStages, count);
+            {
+                for (size_t i=0; i<count; ++i)
+                {
+                    const stage_t *s    = &vStages[i];
+                    v->begin_object(s, sizeof(stage_t));
+                    {
+                        v->write("name", names[i]);
+                        v->write("nCycles", s->nCycles);
+                        v->write("nCalls", s->nCalls);
+                        v->write("nSamples", s->nSamples);
+                        v->write("fCyclesPerSample", cycles_per_sample(i));
+                    }
+                    v->end_object();
+                }
+            }
+            v->end_array();
+        }
+
+    } /* namespace plugins */
+} /* namespace lsp */
+
+#endif /* LSP_AUTOGAIN_PROFILE */
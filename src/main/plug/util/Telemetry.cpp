@@ -0,0 +1,174 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-plugins-autogain
+ * Created on: 18 окт 2026 г.
+ *
+ * lsp-plugins-autogain is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-plugins-autogain is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-plugins-autogain. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <lsp-plug.in/common/debug.h>
+#include <lsp-plug.in/io/File.h>
+
+#include <string.h>
+
+#include <private/util/Telemetry.h>
+
+namespace lsp
+{
+    namespace plugins
+    {
+        //---------------------------------------------------------------------
+        // TelemetryWriter
+        TelemetryWriter::TelemetryWriter(TelemetryRing *ring)
+        {
+            pRing           = ring;
+            nSampleRate     = 0;
+            nChannels       = 0;
+            nInterval       = 0;
+            bOpened         = false;
+            bActive         = false;
+            pRequest        = NULL;
+            nReopen         = 0;
+            nCancel         = 0;
+            sPath[0]        = '\0';
+        }
+
+        TelemetryWriter::~TelemetryWriter()
+        {
+            close_file();
+        }
+
+        void TelemetryWriter::set_file(const char *path, size_t sample_rate, size_t channels, size_t interval)
+        {
+            if (path == NULL)
+                path                    = "";
+
+            pRequest                = path;
+            nSampleRate             = sample_rate;
+            nChannels               = channels;
+            nInterval               = interval;
+            bActive                 = path[0] != '\0';
+            atomic_store(&nReopen, 1);
+        }
+
+        bool TelemetryWriter::active() const
+        {
+            return bActive;
+        }
+
+        void TelemetryWriter::close()
+        {
+            // The task may be still submitted or running, the file should not be touched until it completes
+            atomic_store(&nCancel, 1);
+            const bool finished     = wait_task(this);
+            atomic_store(&nCancel, 0);
+            if (!finished)
+            {
+                lsp_warn("Telemetry writer did not finish in time, leaving file %s to the task", sPath);
+                bOpened                 = false;
+                return;
+            }
+
+            close_file();
+            sPath[0]                = '\0';
+            pRequest                = NULL;
+            bActive                 = false;
+            atomic_store(&nReopen, 0);
+        }
+
+        status_t TelemetryWriter::open_file()
+        {
+            close_file();
+            if (sPath[0] == '\0')
+                return STATUS_OK;
+
+            status_t res = sOut.open(sPath, io::File::FM_WRITE_NEW);
+            if (res != STATUS_OK)
+            {
+                lsp_warn("Could not open telemetry file %s, error code: %d", sPath, int(res));
+                return res;
+            }
+
+            telemetry_header_t hdr;
+            memset(&hdr, 0, sizeof(hdr));
+            hdr.nMagic              = TELEMETRY_MAGIC;
+            hdr.nVersion            = TELEMETRY_VERSION;
+            hdr.nRecordSize         = sizeof(telemetry_record_t);
+            hdr.nSampleRate         = nSampleRate;
+            hdr.nChannels           = nChannels;
+            hdr.nInterval           = nInterval;
+
+            if (sOut.write(&hdr, sizeof(hdr)) != sizeof(hdr))
+            {
+                sOut.close();
+                return STATUS_IO_ERROR;
+            }
+
+            bOpened                 = true;
+            return STATUS_OK;
+        }
+
+        void TelemetryWriter::close_file()
+        {
+            if (!bOpened)
+                return;
+
+            sOut.flush();
+            sOut.close();
+            bOpened                 = false;
+        }
+
+        status_t TelemetryWriter::run()
+        {
+            status_t res = STATUS_OK;
+
+            // Re-open the file if it has been changed
+            if (atomic_load(&nReopen))
+            {
+                strncpy(sPath, pRequest, PATH_MAX - 1);
+                sPath[PATH_MAX - 1]     = '\0';
+                pRequest                = NULL;
+                atomic_store(&nReopen, 0);
+                res                     = open_file();
+            }
+
+            // Drain the ring
+            while (!atomic_load(&nCancel))
+            {
+                size_t count            = pRing->pop(vBatch, BATCH_SIZE);
+                if (count <= 0)
+                    break;
+
+                if (bOpened)
+                {
+                    size_t bytes            = count * sizeof(telemetry_record_t);
+                    if (sOut.write(vBatch, bytes) != ssize_t(bytes))
+                    {
+                        lsp_warn("Error writing telemetry file %s", sPath);
+                        close_file();
+                        res                     = STATUS_IO_ERROR;
+                    }
+                }
+            }
+
+            if (bOpened)
+                sOut.flush();
+
+            return res;
+        }
+
+    } /* namespace plugins */
+} /* namespace lsp */
@@ -0,0 +1,235 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-plugins-autogain
+ * Created on: 18 окт 2026 г.
+ *
+ * lsp-plugins-autogain is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-plugins-autogain is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-plugins-autogain. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <lsp-plug.in/common/debug.h>
+#include <lsp-plug.in/io/File.h>
+
+#include <private/util/Trace.h>
+
+#include <stdio.h>
+#include <string.h>
+
+#if defined(PLATFORM_WINDOWS)
+    #include <windows.h>
+#elif defined(PLATFORM_LINUX)
+    #include <sys/syscall.h>
+    #include <unistd.h>
+#else
+    #include <pthread.h>
+    #include <unistd.h>
+#endif
+
+namespace lsp
+{
+    namespace plugins
+    {
+        uint32_t trace_thread_id()
+        {
+            // Cache the value to avoid system call on each event
+            static thread_local uint32_t tid = 0;
+            if (tid != 0)
+                return tid;
+
+        #if defined(PLATFORM_WINDOWS)
+            tid     = uint32_t(GetCurrentThreadId());
+        #elif defined(PLATFORM_LINUX)
+            tid     = uint32_t(syscall(SYS_gettid));
+        #else
+            tid     = uint32_t(uintptr_t(pthread_self()));
+        #endif
+
+            return tid;
+        }
+
+        uint32_t trace_process_id()
+        {
+        #if defined(PLATFORM_WINDOWS)
+            return uint32_t(GetCurrentProcessId());
+        #else
+            return uint32_t(getpid());
+        #endif
+        }
+
+        TraceWriter::TraceWriter(TraceRing *ring, size_t capacity, const char * const *names, size_t count)
+        {
+            pRing           = ring;
+            nCapacity       = capacity;
+            vNames          = names;
+            nNames          = count;
+            bOpened         = false;
+            pRequest        = NULL;
+            nReopen         = 0;
+            nCancel         = 0;
+            bFirst          = true;
+            nPid            = trace_process_id();
+            sPath[0]        = '\0';
+        }
+
+        TraceWriter::~TraceWriter()
+        {
+            close();
+        }
+
+        void TraceWriter::set_file(const char *path)
+        {
+            pRequest        = (path != NULL) ? path : "";
+            atomic_store(&nReopen, 1);
+        }
+
+        status_t TraceWriter::open_file()
+        {
+            if (sPath[0] == '\0')
+                return STATUS_OK;
+
+            // The ring is allocated when the trace is requested for the first time
+            if ((pRing->capacity() <= 0) && (pRing->init(nCapacity) != STATUS_OK))
+                return STATUS_NO_MEM;
+
+            status_t res = sOut.open(sPath, io::File::FM_WRITE_NEW);
+            if (res != STATUS_OK)
+            {
+                lsp_warn("Could not open trace file %s, error code: %d", sPath, int(res));
+                return res;
+            }
+
+            static const char *header = "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n";
+            size_t len      = strlen(header);
+            if (sOut.write(header, len) != ssize_t(len))
+            {
+                sOut.close();
+                return STATUS_IO_ERROR;
+            }
+
+            bOpened         = true;
+            bFirst          = true;
+            return STATUS_OK;
+        }
+
+        void TraceWriter::close_file()
+        {
+            if (!bOpened)
+                return;
+
+            // Finalize the document
+            static const char *footer = "\n]}\n";
+            sOut.write(footer, strlen(footer));
+            sOut.flush();
+            sOut.close();
+            bOpened         = false;
+        }
+
+        void TraceWriter::close()
+        {
+            // The task may be still submitted or running, the file should not be touched until it completes
+            atomic_store(&nCancel, 1);
+            const bool finished     = wait_task(this);
+            atomic_store(&nCancel, 0);
+            pRequest                = NULL;
+            atomic_store(&nReopen, 0);
+            if (!bOpened)
+                return;
+            if (!finished)
+            {
+                lsp_warn("Trace writer did not finish in time, leaving file %s to the task", sPath);
+                bOpened                 = false;
+                return;
+            }
+
+            // Write the rest of events and finalize the document
+            drain();
+            close_file();
+        }
+
+        status_t TraceWriter::write_event(const trace_event_t *ev)
+        {
+            char buf[256];
+            const char *name    = (ev->nStage < nNames) ? vNames[ev->nStage] : "unknown";
+
+            // Timestamps are in microseconds
+            int len = snprintf(buf, sizeof(buf),
+                "%s{\"name\":\"%s\",\"cat\":\"autogain\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,"
+                "\"pid\":%u,\"tid\":%u,\"args\":{\"samples\":%u,\"mode\":%u}}",
+                (bFirst) ? "" : ",\n",
+                name,
+                double(ev->nStart) * 1e-3,
+                double(ev->nEnd - ev->nStart) * 1e-3,
+                unsigned(nPid),
+                unsigned(ev->nThreadId),
+                unsigned(ev->nSamples),
+                unsigned(ev->nMode));
+            if ((len <= 0) || (size_t(len) >= sizeof(buf)))
+                return STATUS_OVERFLOW;
+
+            if (sOut.write(buf, len) != len)
+                return STATUS_IO_ERROR;
+
+            bFirst      = false;
+            return STATUS_OK;
+        }
+
+        status_t TraceWriter::drain()
+        {
+            status_t res = STATUS_OK;
+
+            while (!atomic_load(&nCancel))
+            {
+                size_t count            = pRing->pop(vBatch, BATCH_SIZE);
+                if (count <= 0)
+                    break;
+                if (!bOpened)
+                    continue;
+
+                for (size_t i=0; i<count; ++i)
+                {
+                    if ((res = write_event(&vBatch[i])) != STATUS_OK)
+                    {
+                        lsp_warn("Error writing trace file %s", sPath);
+                        return res;
+                    }
+                }
+            }
+
+            return res;
+        }
+
+        status_t TraceWriter::run()
+        {
+            // Switch to another file: the events collected for the previous file are written to it
+            if (atomic_load(&nReopen))
+            {
+                drain();
+                close_file();
+
+                strncpy(sPath, pRequest, PATH_MAX - 1);
+                sPath[PATH_MAX - 1]     = '\0';
+                pRequest                = NULL;
+                atomic_store(&nReopen, 0);
+
+                status_t res            = open_file();
+                if (res != STATUS_OK)
+                    return res;
+            }
+
+            return drain();
+        }
+
+    } /* namespace plugins */
+} /* namespace lsp */
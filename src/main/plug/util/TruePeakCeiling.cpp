@@ -0,0 +1,306 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-plugins-autogain
+ * Created on: 18 окт 2026 г.
+ *
+ * lsp-plugins-autogain is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-plugins-autogain is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-plugins-autogain. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <lsp-plug.in/common/alloc.h>
+#include <lsp-plug.in/dsp/dsp.h>
+
+#include <private/util/TruePeakCeiling.h>
+
+namespace lsp
+{
+    namespace plugins
+    {
+        /* Polyphase interpolation filter for 4x oversampling, ITU-R BS.1770-4 Annex 2 */
+        static const float tp_kernel[TruePeakCeiling::PHASES][TruePeakCeiling::TAPS] =
+        {
+            {
+                 0.0017089843750f,  0.0109863281250f, -0.0196533203125f,  0.0332031250000f,
+                -0.0594482421875f,  0.1373291015625f,  0.9721679687500f, -0.1022949218750f,
+                 0.0476074218750f, -0.0266113281250f,  0.0148925781250f, -0.0083007812500f
+            },
+            {
+                -0.0291748046875f,  0.0292968750000f, -0.0517578125000f,  0.0891113281250f,
+                -0.1665039062500f,  0.4650878906250f,  0.7797851562500f, -0.2003173828125f,
+                 0.1015625000000f, -0.0582275390625f,  0.0330810546875f, -0.0189208984375f
+            },
+            {
+                -0.0189208984375f,  0.0330810546875f, -0.0582275390625f,  0.1015625000000f,
+                -0.2003173828125f,  0.7797851562500f,  0.4650878906250f, -0.1665039062500f,
+                 0.0891113281250f, -0.0517578125000f,  0.0292968750000f, -0.0291748046875f
+            },
+            {
+                -0.0083007812500f,  0.0148925781250f, -0.0266113281250f,  0.0476074218750f,
+                -0.1022949218750f,  0.9721679687500f,  0.1373291015625f, -0.0594482421875f,
+                 0.0332031250000f, -0.0196533203125f,  0.0109863281250f,  0.0017089843750f
+            }
+        };
+
+        TruePeakCeiling::TruePeakCeiling()
+        {
+            nChannels       = 0;
+            nBlock          = 0;
+            nCapacity       = 0;
+            nLookahead      = 0;
+            nWindow         = 2;
+            nLength         = 1;
+            nPosition       = 0;
+            nQHead          = 0;
+            nQCount         = 0;
+            nAvgHead        = 0;
+            fAvgSum         = 0.0;
+            fCeiling        = 1.0f;
+            vChannels       = NULL;
+            vPeak           = NULL;
+            vTemp           = NULL;
+            vQValue         = NULL;
+            vQIndex         = NULL;
+            vAvg            = NULL;
+            pData           = NULL;
+        }
+
+        TruePeakCeiling::~TruePeakCeiling()
+        {
+            destroy();
+        }
+
+        status_t TruePeakCeiling::init(size_t channels, size_t max_block, size_t max_lookahead)
+        {
+            // The true peak window covers the lookahead and two adjacent interpolated intervals
+            size_t capacity         = max_lookahead + 2;
+
+            size_t szof_channels    = align_size(sizeof(channel_t) * channels, DEFAULT_ALIGN);
+            size_t szof_phase       = align_size(sizeof(float) * (max_block + TAPS), DEFAULT_ALIGN);
+            size_t szof_block       = align_size(sizeof(float) * max_block, DEFAULT_ALIGN);
+            size_t szof_values      = align_size(sizeof(float) * capacity, DEFAULT_ALIGN);
+            size_t szof_indices     = align_size(sizeof(size_t) * capacity, DEFAULT_ALIGN);
+            size_t to_alloc         =
+                szof_channels +
+                szof_phase * PHASES * channels +
+                szof_block * 2 +
+                szof_values * 2 +
+                szof_indices;
+
+            uint8_t *data           = NULL;
+            uint8_t *ptr            = alloc_aligned<uint8_t>(data, to_alloc, DEFAULT_ALIGN);
+            if (ptr == NULL)
+                return STATUS_NO_MEM;
+
+            // Drop previously allocated data
+            destroy();
+
+            vChannels               = advance_ptr_bytes<channel_t>(ptr, szof_channels);
+            for (size_t i=0; i<channels; ++i)
+            {
+                channel_t *c            = &vChannels[i];
+                c->vIn                  = NULL;
+                for (size_t j=0; j<PHASES; ++j)
+                    c->vPhase[j]            = advance_ptr_bytes<float>(ptr, szof_phase);
+            }
+            vPeak                   = advance_ptr_bytes<float>(ptr, szof_block);
+            vTemp                   = advance_ptr_bytes<float>(ptr, szof_block);
+            vQValue                 = advance_ptr_bytes<float>(ptr, szof_values);
+            vAvg                    = advance_ptr_bytes<float>(ptr, szof_values);
+            vQIndex                 = advance_ptr_bytes<size_t>(ptr, szof_indices);
+
+            nChannels               = channels;
+            nBlock                  = max_block;
+            nCapacity               = capacity;
+            nLookahead              = lsp_min(nLookahead, max_lookahead);
+            pData                   = data;
+
+            clear();
+
+            return STATUS_OK;
+        }
+
+        void TruePeakCeiling::destroy()
+        {
+            if (pData != NULL)
+            {
+                free_aligned(pData);
+                pData                   = NULL;
+            }
+
+            vChannels               = NULL;
+            vPeak                   = NULL;
+            vTemp                   = NULL;
+            vQValue                 = NULL;
+            vQIndex                 = NULL;
+            vAvg                    = NULL;
+            nChannels               = 0;
+            nBlock                  = 0;
+            nCapacity               = 0;
+        }
+
+        void TruePeakCeiling::reset_window()
+        {
+            nWindow                 = nLookahead + 2;
+            nLength                 = nLookahead + 1;
+            nQHead                  = 0;
+            nQCount                 = 0;
+            nAvgHead                = 0;
+            fAvgSum                 = double(GAIN_MAX) * double(nLength);
+            if (vAvg != NULL)
+                dsp::fill(vAvg, GAIN_MAX, nLength);
+        }
+
+        void TruePeakCeiling::clear()
+        {
+            for (size_t i=0; i<nChannels; ++i)
+            {
+                channel_t *c            = &vChannels[i];
+                for (size_t j=0; j<PHASES; ++j)
+                    dsp::fill_zero(c->vPhase[j], nBlock + TAPS);
+            }
+
+            nPosition               = 0;
+            reset_window();
+        }
+
+        void TruePeakCeiling::set_lookahead(size_t samples)
+        {
+            if (nCapacity > 0)
+                samples                 = lsp_min(samples, nCapacity - 2);
+            if (samples == nLookahead)
+                return;
+
+            nLookahead              = samples;
+            reset_window();
+        }
+
+        void TruePeakCeiling::bind(size_t channel, const float *src)
+        {
+            vChannels[channel].vIn  = src;
+        }
+
+        void TruePeakCeiling::true_peak(channel_t *c, float *dst, size_t samples)
+        {
+            // Each phase buffer keeps the tail of the convolution of the previous block at the head
+            if (c->vIn != NULL)
+            {
+                for (size_t j=0; j<PHASES; ++j)
+                    dsp::convolve(c->vPhase[j], c->vIn, tp_kernel[j], TAPS, samples);
+            }
+
+            dsp::abs2(dst, c->vPhase[0], samples);
+            for (size_t j=1; j<PHASES; ++j)
+                dsp::pamax2(dst, c->vPhase[j], samples);
+
+            // Move the tail to the head of the buffer
+            for (size_t j=0; j<PHASES; ++j)
+            {
+                float *p                = c->vPhase[j];
+                dsp::move(p, &p[samples], TAPS - 1);
+                dsp::fill_zero(&p[TAPS - 1], samples);
+            }
+        }
+
+        void TruePeakCeiling::process(float *gain, size_t samples)
+        {
+            if (nChannels <= 0)
+                return;
+
+            // Estimate the true peak of all channels
+            true_peak(&vChannels[0], vPeak, samples);
+            for (size_t i=1; i<nChannels; ++i)
+            {
+                true_peak(&vChannels[i], vTemp, samples);
+                dsp::pmax2(vPeak, vTemp, samples);
+            }
+
+            for (size_t i=0; i<samples; ++i)
+            {
+                // Maintain the monotonic deque: values decrease from the head to the tail
+                const float peak        = vPeak[i];
+                while ((nQCount > 0) && (vQValue[(nQHead + nQCount - 1) % nCapacity] <= peak))
+                    --nQCount;
+                size_t tail             = (nQHead + nQCount) % nCapacity;
+                vQValue[tail]           = peak;
+                vQIndex[tail]           = nPosition;
+                ++nQCount;
+
+                // Drop values that left the window, the current value always stays
+                while ((nPosition - vQIndex[nQHead]) >= nWindow)
+                {
+                    nQHead                  = (nQHead + 1) % nCapacity;
+                    --nQCount;
+                }
+                ++nPosition;
+
+                // Compute the gain limit for the maximum true peak within the window
+                const float env         = vQValue[nQHead];
+                const float limit       = (env * GAIN_MAX > fCeiling) ? fCeiling / env : GAIN_MAX;
+
+                // Smooth the limit by the moving average: each averaged value is computed for the window
+                // that contains the peak, so the average never exceeds the limit required for the peak
+                fAvgSum                += double(limit) - double(vAvg[nAvgHead]);
+                vAvg[nAvgHead]          = limit;
+                if ((++nAvgHead) >= nLength)
+                {
+                    // Re-compute the sum to prevent accumulation of the rounding error
+                    nAvgHead                = 0;
+                    fAvgSum                 = 0.0;
+                    for (size_t j=0; j<nLength; ++j)
+                        fAvgSum                += vAvg[j];
+                }
+
+                gain[i]                 = lsp_min(gain[i], float(fAvgSum / double(nLength)));
+            }
+        }
+
+        void TruePeakCeiling::dump(dspu::IStateDumper *v) const
+        {
+            v->write("nChannels", nChannels);
+            v->write("nBlock", nBlock);
+            v->write("nCapacity", nCapacity);
+            v->write("nLookahead", nLookahead);
+            v->write("nWindow", nWindow);
+            v->write("nLength", nLength);
+            v->write("nPosition", nPosition);
+            v->write("nQHead", nQHead);
+            v->write("nQCount", nQCount);
+            v->write("nAvgHead", nAvgHead);
+            v->write("fAvgSum", fAvgSum);
+            v->write("fCeiling", fCeiling);
+            v->begin_array("vChannels", vChannels, nChannels);
+            {
+                for (size_t i=0; i<nChannels; ++i)
+                {
+                    const channel_t *c      = &vChannels[i];
+                    v->begin_object(c, sizeof(channel_t));
+                    {
+                        v->write("vIn", c->vIn);
+                        v->writev("vPhase", c->vPhase, PHASES);
+                    }
+                    v->end_object();
+                }
+            }
+            v->end_array();
+            v->write("vPeak", vPeak);
+            v->write("vTemp", vTemp);
+            v->write("vQValue", vQValue);
+            v->write("vQIndex", vQIndex);
+            v->write("vAvg", vAvg);
+            v->write("pData", pData);
+        }
+
+    } /* namespace plugins */
+} /* namespace lsp */
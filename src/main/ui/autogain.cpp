@@ -33,10 +33,14 @@ namespace lsp
             &meta::autogain_mono,
             &meta::autogain_stereo,
             &meta::sc_autogain_mono,
-            &meta::sc_autogain_stereo
+            &meta::sc_autogain_stereo,
+            &meta::autogain_env_mono,
+            &meta::autogain_env_stereo,
+            &meta::autogain_follower_mono,
+            &meta::autogain_follower_stereo
         };
 
-        static ui::Factory factory(plugin_uis, 4);
+        static ui::Factory factory(plugin_uis, 8);
 
     } /* namespace plugui */
 } /* namespace lsp */
@@ -0,0 +1,414 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-plugins-autogain
+ * Created on: 18 окт 2026 г.
+ *
+ * lsp-plugins-autogain is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-plugins-autogain is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-plugins-autogain. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <lsp-plug.in/test-fw/mtest.h>
+#include <lsp-plug.in/dsp/dsp.h>
+#include <lsp-plug.in/dsp-units/units.h>
+#include <lsp-plug.in/plug-fw/meta/func.h>
+#include <lsp-plug.in/plug-fw/plug.h>
+#include <private/meta/autogain.h>
+#include <private/plugins/autogain.h>
+#include <private/test/TestPorts.h>
+#include <private/util/CaptureReader.h>
+#include <private/util/LoadMeter.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+namespace
+{
+    using namespace lsp;
+
+    static constexpr size_t MAX_CHANNELS    = 2;
+    static constexpr size_t MAX_OUTPUTS     = 3;
+
+    // Plugins that write the session capture
+    static const meta::plugin_t * const plugins_list[] =
+    {
+        &meta::autogain_mono,
+        &meta::autogain_stereo,
+        &meta::sc_autogain_mono,
+        &meta::sc_autogain_stereo,
+        &meta::autogain_env_mono,
+        &meta::autogain_env_stereo,
+        NULL
+    };
+
+    const meta::plugin_t *find_plugin(const char *uid)
+    {
+        for (const meta::plugin_t * const *p = plugins_list; *p != NULL; ++p)
+        {
+            if (!strcmp((*p)->uid, uid))
+                return *p;
+        }
+        return NULL;
+    }
+}
+
+/*
+ * Offline replay of the session capture written by the plugin to the file selected by the
+ * cap_file port. The capture should be replayed by the same build of the plugin:
+ *
+ *   mtest autogain.capture_replay <plugin uid> <capture file>
+ *
+ * The replay is deterministic, so the digests of the output allow to compare replays.
+ */
+MTEST_BEGIN("autogain", capture_replay)
+
+    plugins::autogain  *pPlugin;
+    plugins::TestPorts  sPorts;             // Ports of the plugin
+    size_t              nChannels;          // Number of channels in the capture
+    size_t              nOutputs;           // Number of audio outputs
+    plugins::TestPort  *vIn[MAX_CHANNELS];      // Input ports
+    plugins::TestPort  *vSc[MAX_CHANNELS];      // Sidechain input ports
+    plugins::TestPort  *vOut[MAX_OUTPUTS];      // Output ports
+    float              *vInBuf[MAX_CHANNELS];   // Input buffers
+    float              *vScBuf[MAX_CHANNELS];   // Sidechain buffers
+    float              *vOutBuf[MAX_OUTPUTS];   // Output buffers
+    size_t              vInFill[MAX_CHANNELS];  // Number of input samples received for the block
+    size_t              vScFill[MAX_CHANNELS];  // Number of sidechain samples received for the block
+    size_t              vLinkFill[MAX_CHANNELS];// Number of link samples received for the block
+    size_t              nCapacity;          // Capacity of buffers
+    size_t              nSampleRate;        // Current sample rate
+    size_t              nBlock;             // Size of the pending block
+    bool                bPending;           // The block is pending for processing
+    bool                bUpdate;            // Settings should be updated
+
+    // Statistics
+    size_t              nBlocks;            // Number of processed blocks
+    size_t              nIncomplete;        // Number of blocks with missing audio data
+    size_t              nParams;            // Number of parameter changes
+    size_t              nLinks;             // Number of blocks with the active link
+    uint64_t            nSamples;           // Number of processed samples
+    double              fDuration;          // Duration of the processed audio, seconds
+    uint64_t            nTime;              // Total processing time, nanoseconds
+    uint64_t            nPeakTime;          // Peak processing time of the block, nanoseconds
+    float               vPeak[MAX_OUTPUTS];     // Peak output values
+    uint64_t            vDigest[MAX_OUTPUTS];   // FNV-1a digest of the output data
+
+    void init_state()
+    {
+        pPlugin         = NULL;
+        nChannels       = 0;
+        nOutputs        = 0;
+        for (size_t i=0; i<MAX_CHANNELS; ++i)
+        {
+            vIn[i]          = NULL;
+            vSc[i]          = NULL;
+            vInBuf[i]       = NULL;
+            vScBuf[i]       = NULL;
+            vInFill[i]      = 0;
+            vScFill[i]      = 0;
+            vLinkFill[i]    = 0;
+        }
+        for (size_t i=0; i<MAX_OUTPUTS; ++i)
+        {
+            vOut[i]         = NULL;
+            vOutBuf[i]      = NULL;
+            vPeak[i]        = 0.0f;
+            vDigest[i]      = 0xcbf29ce484222325ULL;    // FNV-1a offset basis
+        }
+        nCapacity       = 0;
+        nSampleRate     = 0;
+        nBlock          = 0;
+        bPending        = false;
+        bUpdate         = false;
+
+        nBlocks         = 0;
+        nIncomplete     = 0;
+        nParams         = 0;
+        nLinks          = 0;
+        nSamples        = 0;
+        fDuration       = 0.0;
+        nTime           = 0;
+        nPeakTime       = 0;
+    }
+
+    void create_ports(const meta::plugin_t *meta)
+    {
+        // Buffers are allocated by the replay since the block size is not known in advance
+        MTEST_ASSERT(sPorts.init(meta, 0));
+
+        // The first audio inputs are the main inputs, the rest ones are the sidechain inputs
+        const size_t inputs = sPorts.inputs();
+        MTEST_ASSERT_MSG(inputs >= nChannels, "The capture has more channels than the plugin");
+        MTEST_ASSERT(inputs <= nChannels * 2);
+        for (size_t i=0; i<inputs; ++i)
+        {
+            if (i < nChannels)
+                vIn[i]                  = sPorts.input(i);
+            else
+                vSc[i - nChannels]      = sPorts.input(i);
+        }
+
+        nOutputs            = sPorts.outputs();
+        MTEST_ASSERT(nOutputs <= MAX_OUTPUTS);
+        for (size_t i=0; i<nOutputs; ++i)
+            vOut[i]             = sPorts.output(i);
+    }
+
+    void free_buffers()
+    {
+        for (size_t i=0; i<MAX_CHANNELS; ++i)
+        {
+            free(vInBuf[i]);
+            free(vScBuf[i]);
+            vInBuf[i]       = NULL;
+            vScBuf[i]       = NULL;
+        }
+        for (size_t i=0; i<MAX_OUTPUTS; ++i)
+        {
+            free(vOutBuf[i]);
+            vOutBuf[i]      = NULL;
+        }
+    }
+
+    void grow_buffer(float **buf, plugins::TestPort *port, size_t capacity)
+    {
+        if (port == NULL)
+            return;
+
+        float *ptr      = static_cast<float *>(realloc(*buf, sizeof(float) * capacity));
+        MTEST_ASSERT(ptr != NULL);
+        *buf            = ptr;
+        port->set_buffer(ptr);
+    }
+
+    // The block size is not limited by the capture format, so buffers grow on demand
+    void reserve(size_t samples)
+    {
+        if (samples <= nCapacity)
+            return;
+
+        size_t capacity = lsp_max(nCapacity, size_t(0x400));
+        while (capacity < samples)
+            capacity      <<= 1;
+
+        for (size_t i=0; i<nChannels; ++i)
+        {
+            grow_buffer(&vInBuf[i], vIn[i], capacity);
+            grow_buffer(&vScBuf[i], vSc[i], capacity);
+        }
+        for (size_t i=0; i<nOutputs; ++i)
+            grow_buffer(&vOutBuf[i], vOut[i], capacity);
+        sPorts.set_link_size(capacity);
+
+        nCapacity       = capacity;
+    }
+
+    void begin_block(size_t samples)
+    {
+        reserve(lsp_max(samples, size_t(1)));
+
+        // Missing audio data is replaced by silence
+        for (size_t i=0; i<nChannels; ++i)
+        {
+            dsp::fill_zero(vInBuf[i], samples);
+            vInFill[i]      = 0;
+            if (vScBuf[i] != NULL)
+                dsp::fill_zero(vScBuf[i], samples);
+            vScFill[i]      = 0;
+            vLinkFill[i]    = 0;
+        }
+
+        // The link is active only for blocks that have the link audio data
+        sPorts.set_link_active(false);
+        for (size_t i=0; i<sPorts.links(); ++i)
+            dsp::fill_zero(sPorts.link_data(i), samples);
+
+        nBlock          = samples;
+        bPending        = true;
+    }
+
+    void append_audio(float *buf, size_t *fill, const plugins::capture_record_t *rec)
+    {
+        if ((!bPending) || (buf == NULL))
+            return;
+
+        size_t to_do    = lsp_min(size_t(rec->nCount), nBlock - *fill);
+        dsp::copy(&buf[*fill], rec->vData, to_do);
+        *fill          += to_do;
+    }
+
+    void run_block()
+    {
+        if (!bPending)
+            return;
+        bPending        = false;
+        MTEST_ASSERT_MSG(nSampleRate > 0, "The block precedes the sample rate record");
+
+        // Check that all audio data of the block has been captured
+        bool complete   = true;
+        for (size_t i=0; i<nChannels; ++i)
+        {
+            if (vInFill[i] != nBlock)
+                complete        = false;
+            if ((vScBuf[i] != NULL) && (vScFill[i] != nBlock))
+                complete        = false;
+        }
+        for (size_t i=0; (sPorts.link_active()) && (i<sPorts.links()); ++i)
+        {
+            if (vLinkFill[i] != nBlock)
+                complete        = false;
+        }
+        if (!complete)
+            ++nIncomplete;
+
+        // Apply settings and process the block in the same way as the host does
+        uint64_t start  = plugins::monotonic_nanos();
+        if (bUpdate)
+        {
+            pPlugin->update_settings();
+            bUpdate         = false;
+        }
+        pPlugin->process(nBlock);
+        uint64_t time   = plugins::monotonic_nanos() - start;
+
+        nTime          += time;
+        nPeakTime       = lsp_max(nPeakTime, time);
+        nSamples       += nBlock;
+        fDuration      += double(nBlock) / double(nSampleRate);
+        ++nBlocks;
+
+        // Update the statistics of the output
+        for (size_t i=0; i<nOutputs; ++i)
+        {
+            const float *buf    = vOutBuf[i];
+            if (nBlock > 0)
+                vPeak[i]            = lsp_max(vPeak[i], dsp::abs_max(buf, nBlock));
+
+            uint64_t hash       = vDigest[i];
+            const uint8_t *ptr  = reinterpret_cast<const uint8_t *>(buf);
+            for (size_t j=0, n=nBlock * sizeof(float); j<n; ++j)
+                hash                = (hash ^ ptr[j]) * 0x100000001b3ULL;   // FNV-1a prime
+            vDigest[i]          = hash;
+        }
+    }
+
+    void replay(plugins::CaptureReader *reader)
+    {
+        plugins::capture_record_t rec;
+        status_t res;
+
+        while ((res = reader->read(&rec)) == STATUS_OK)
+        {
+            switch (rec.nType)
+            {
+                case plugins::CR_SAMPLE_RATE:
+                    run_block();
+                    nSampleRate     = rec.nCount;
+                    pPlugin->set_sample_rate(nSampleRate);
+                    bUpdate         = true;
+                    break;
+
+                case plugins::CR_PARAM:
+                    run_block();
+                    sPorts.port(rec.nIndex)->set_value(rec.vData[0]);
+                    bUpdate         = true;
+                    ++nParams;
+                    break;
+
+                case plugins::CR_BLOCK:
+                    run_block();
+                    begin_block(rec.nCount);
+                    break;
+
+                case plugins::CR_INPUT:
+                    append_audio(vInBuf[rec.nIndex], &vInFill[rec.nIndex], &rec);
+                    break;
+
+                case plugins::CR_SIDECHAIN:
+                    append_audio(vScBuf[rec.nIndex], &vScFill[rec.nIndex], &rec);
+                    break;
+
+                case plugins::CR_LINK:
+                    if ((bPending) && (rec.nIndex < sPorts.links()))
+                    {
+                        if (!sPorts.link_active())
+                            ++nLinks;
+                        sPorts.set_link_active(true);
+                        append_audio(sPorts.link_data(rec.nIndex), &vLinkFill[rec.nIndex], &rec);
+                    }
+                    break;
+
+                default:
+                    break;
+            }
+        }
+        run_block();
+
+        MTEST_ASSERT_MSG(res == STATUS_EOF,
+            "Error reading record %d of the capture file: %d", int(reader->records()), int(res));
+    }
+
+    MTEST_MAIN
+    {
+        MTEST_ASSERT_MSG(argc >= 2, "Usage: %s <plugin uid> <capture file>", full_name());
+
+        const meta::plugin_t *meta  = find_plugin(argv[0]);
+        MTEST_ASSERT_MSG(meta != NULL, "Unknown plugin: %s", argv[0]);
+
+        plugins::CaptureReader reader;
+        status_t res    = reader.open(argv[1]);
+        MTEST_ASSERT_MSG(res == STATUS_OK, "Could not open capture file %s: %d", argv[1], int(res));
+
+        init_state();
+        const plugins::capture_header_t *hdr = reader.header();
+        nChannels       = hdr->nChannels;
+        MTEST_ASSERT_MSG((nChannels > 0) && (nChannels <= MAX_CHANNELS),
+            "Invalid number of channels: %d", int(nChannels));
+
+        create_ports(meta);
+        MTEST_ASSERT_MSG(hdr->nPorts == sPorts.size(),
+            "The capture has %d ports while %s has %d ports, the capture was made by another plugin or build",
+            int(hdr->nPorts), meta->uid, int(sPorts.size()));
+
+        // Replay the session
+        pPlugin         = new plugins::autogain(meta);
+        pPlugin->init(NULL, sPorts.ports());
+        replay(&reader);
+
+        pPlugin->destroy();
+        delete pPlugin;
+        pPlugin         = NULL;
+
+        // Report the results
+        printf("Replayed %s session from %s\n", meta->uid, argv[1]);
+        printf("  blocks: %d, samples: %lld, duration: %.3f s, parameter changes: %d\n",
+            int(nBlocks), (long long)(nSamples), fDuration, int(nParams));
+        printf("  records dropped at capture: %d, incomplete blocks: %d, blocks with active link: %d\n",
+            int(reader.dropped()), int(nIncomplete), int(nLinks));
+        printf("  processing time: %.3f ms, peak block time: %.3f us, realtime factor: %.1f\n",
+            double(nTime) * 1e-6, double(nPeakTime) * 1e-3,
+            (nTime > 0) ? fDuration * 1e+9 / double(nTime) : 0.0);
+        for (size_t i=0; i<nOutputs; ++i)
+            printf("  output %d: peak %.2f dB, digest %016llx\n",
+                int(i), dspu::gain_to_db(vPeak[i]), (unsigned long long)(vDigest[i]));
+        if ((reader.dropped() > 0) || (nIncomplete > 0))
+            printf("  WARNING: the replay is not exact, the capture misses some audio data\n");
+
+        reader.close();
+        sPorts.destroy();
+        free_buffers();
+    }
+
+MTEST_END
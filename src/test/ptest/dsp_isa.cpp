@@ -0,0 +1,133 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-plugins-autogain
+ * Created on: 18 окт 2026 г.
+ *
+ * lsp-plugins-autogain is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-plugins-autogain is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-plugins-autogain. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <lsp-plug.in/test-fw/ptest.h>
+#include <lsp-plug.in/dsp/dsp.h>
+#include <lsp-plug.in/plug-fw/plug.h>
+#include <private/meta/autogain.h>
+#include <private/plugins/autogain.h>
+#include <private/test/TestPorts.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+
+/*
+ * Performance of the whole processing chain of the plugin: loudness meters with their
+ * weighting filters, gain correction, ceiling and metering. The DSP library selects the
+ * implementation of its functions for the instruction sets reported by the CPU, so the test
+ * prints the selected backend first. To measure the plugin on other instruction sets, the test
+ * is launched under an emulator that masks the CPU features, for example Intel SDE:
+ *
+ *   sde64 -snb -- .test/autogain-test ptest autogain.dsp_isa
+ *   sde64 -hsw -- .test/autogain-test ptest autogain.dsp_isa
+ *   sde64 -skx -- .test/autogain-test ptest autogain.dsp_isa
+ */
+namespace
+{
+    using namespace lsp;
+
+    static constexpr size_t SAMPLE_RATE     = 48000;
+
+    typedef struct config_t
+    {
+        const char             *sName;
+        const meta::plugin_t   *pMeta;
+        size_t                  nScMode;    // Index of the sidechain mode in the combo
+        bool                    bLink;      // Sidechain mode uses the shared memory link
+        bool                    bCeiling;   // Enable the true peak ceiling
+    } config_t;
+
+    static const config_t configs[] =
+    {
+        { "mono", &meta::autogain_mono, 0, false, false },
+        { "mono ceiling", &meta::autogain_mono, 0, false, true },
+        { "stereo", &meta::autogain_stereo, 0, false, false },
+        { "stereo ceiling", &meta::autogain_stereo, 0, false, true },
+        { "stereo match link", &meta::autogain_stereo, 2, true, false },
+        { "sc stereo control", &meta::sc_autogain_stereo, 1, false, false },
+        { "sc stereo match", &meta::sc_autogain_stereo, 2, false, false },
+        { "env stereo", &meta::autogain_env_stereo, 0, false, false }
+    };
+}
+
+#define MIN_RANK    6
+#define MAX_RANK    12
+
+PTEST_BEGIN("autogain", dsp_isa, 5, 1000)
+
+    void call(const config_t *cfg)
+    {
+        const size_t buf_size       = 1 << MAX_RANK;
+        plugins::TestPorts ports;
+        if (!ports.init(cfg->pMeta, buf_size))
+            return;
+
+        ports.set_value("scmode", cfg->nScMode);
+        ports.set_value("tp_on", (cfg->bCeiling) ? 1.0f : 0.0f);
+        ports.set_link_active(cfg->bLink);
+
+        for (size_t i=0; i<ports.inputs(); ++i)
+        {
+            float *in                   = ports.in(i);
+            for (size_t j=0; j<buf_size; ++j)
+                in[j]                       = float(rand()) / RAND_MAX * 2.0f - 1.0f;
+        }
+        for (size_t i=0; (cfg->bLink) && (i<ports.links()); ++i)
+        {
+            float *in                   = ports.link_data(i);
+            for (size_t j=0; j<buf_size; ++j)
+                in[j]                       = float(rand()) / RAND_MAX * 2.0f - 1.0f;
+        }
+
+        plugins::autogain *plugin   = new plugins::autogain(cfg->pMeta);
+        plugin->init(NULL, ports.ports());
+        plugin->set_sample_rate(SAMPLE_RATE);
+        plugin->update_settings();
+
+        char buf[80];
+        for (size_t i=MIN_RANK; i <= MAX_RANK; i += 2)
+        {
+            const size_t count          = 1 << i;
+            snprintf(buf, sizeof(buf), "%s x %d", cfg->sName, int(count));
+            PTEST_LOOP(buf, plugin->process(count); );
+        }
+
+        plugin->destroy();
+        delete plugin;
+    }
+
+    PTEST_MAIN
+    {
+        dsp::info_t *info           = dsp::info();
+        if (info != NULL)
+        {
+            printf("DSP backend: %s, %s, features: %s\n", info->arch, info->cpu, info->features);
+            free(info);
+        }
+
+        for (size_t i=0; i<sizeof(configs)/sizeof(config_t); ++i)
+        {
+            call(&configs[i]);
+            PTEST_SEPARATOR;
+        }
+    }
+
+PTEST_END
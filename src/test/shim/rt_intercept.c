@@ -0,0 +1,246 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-plugins-autogain
+ * Created on: 18 окт 2026 г.
+ *
+ * lsp-plugins-autogain is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-plugins-autogain is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-plugins-autogain. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Real-time safety shim: counts memory allocations and mutex locks of the thread that
+ * has armed the counters. The shim is built as a separate shared library and is loaded
+ * into the test binary with LD_PRELOAD, for example:
+ *
+ *   LD_PRELOAD=<build>/lsp-plugins-autogain-rt-intercept.so .test/autogain-test utest autogain.rt_safety
+ *
+ * The real functions are resolved with dlsym() on the first call. dlsym() itself may
+ * allocate memory, such allocations are served from the static bootstrap arena.
+ * The test looks up the control functions below with dlsym(RTLD_DEFAULT) and skips
+ * the checks if the shim is not loaded.
+ */
+#ifndef _GNU_SOURCE
+    #define _GNU_SOURCE
+#endif /* _GNU_SOURCE */
+
+#include <dlfcn.h>
+#include <errno.h>
+#include <pthread.h>
+#include <stddef.h>
+#include <string.h>
+
+#define RT_EXPORT               __attribute__((visibility("default")))
+#define RT_BOOTSTRAP_SIZE       0x4000
+#define RT_BOOTSTRAP_ALIGN      16
+
+typedef void *(* malloc_t)(size_t size);
+typedef void *(* calloc_t)(size_t nmemb, size_t size);
+typedef void *(* realloc_t)(void *ptr, size_t size);
+typedef void (* free_t)(void *ptr);
+typedef int (* posix_memalign_t)(void **ptr, size_t alignment, size_t size);
+typedef void *(* aligned_alloc_t)(size_t alignment, size_t size);
+typedef int (* mutex_func_t)(pthread_mutex_t *mutex);
+
+static malloc_t             real_malloc             = NULL;
+static calloc_t             real_calloc             = NULL;
+static realloc_t            real_realloc            = NULL;
+static free_t               real_free               = NULL;
+static posix_memalign_t     real_posix_memalign     = NULL;
+static aligned_alloc_t      real_aligned_alloc      = NULL;
+static aligned_alloc_t      real_memalign           = NULL;
+static mutex_func_t         real_mutex_lock         = NULL;
+static mutex_func_t         real_mutex_trylock      = NULL;
+static volatile int         resolved                = 0;
+
+static __thread int         resolving               = 0;    // dlsym() is being called by the current thread
+static __thread int         armed                   = 0;    // Counting is enabled for the current thread
+static __thread size_t      allocs                  = 0;    // Number of allocations
+static __thread size_t      frees                   = 0;    // Number of deallocations
+static __thread size_t      locks                   = 0;    // Number of mutex locks
+
+static char                 bootstrap[RT_BOOTSTRAP_SIZE] __attribute__((aligned(RT_BOOTSTRAP_ALIGN)));
+static size_t               bootstrap_used          = 0;
+
+static void *bootstrap_alloc(size_t size)
+{
+    size    = (size + RT_BOOTSTRAP_ALIGN - 1) & ~(size_t)(RT_BOOTSTRAP_ALIGN - 1);
+    size_t offset   = __atomic_fetch_add(&bootstrap_used, size, __ATOMIC_RELAXED);
+    return (offset + size <= RT_BOOTSTRAP_SIZE) ? &bootstrap[offset] : NULL;
+}
+
+static int is_bootstrap(const void *ptr)
+{
+    return ((const char *)ptr >= bootstrap) && ((const char *)ptr < &bootstrap[RT_BOOTSTRAP_SIZE]);
+}
+
+static void resolve(void)
+{
+    if (resolved)
+        return;
+
+    // Concurrent resolution by several threads stores the same values
+    resolving               = 1;
+    real_malloc             = (malloc_t)dlsym(RTLD_NEXT, "malloc");
+    real_calloc             = (calloc_t)dlsym(RTLD_NEXT, "calloc");
+    real_realloc            = (realloc_t)dlsym(RTLD_NEXT, "realloc");
+    real_free               = (free_t)dlsym(RTLD_NEXT, "free");
+    real_posix_memalign     = (posix_memalign_t)dlsym(RTLD_NEXT, "posix_memalign");
+    real_aligned_alloc      = (aligned_alloc_t)dlsym(RTLD_NEXT, "aligned_alloc");
+    real_memalign           = (aligned_alloc_t)dlsym(RTLD_NEXT, "memalign");
+    real_mutex_lock         = (mutex_func_t)dlsym(RTLD_NEXT, "pthread_mutex_lock");
+    real_mutex_trylock      = (mutex_func_t)dlsym(RTLD_NEXT, "pthread_mutex_trylock");
+    resolving               = 0;
+
+    __atomic_store_n(&resolved, 1, __ATOMIC_RELEASE);
+}
+
+static inline void count(size_t *counter)
+{
+    if (armed)
+        ++(*counter);
+}
+
+RT_EXPORT void *malloc(size_t size)
+{
+    if (resolving)
+        return bootstrap_alloc(size);
+    resolve();
+
+    count(&allocs);
+    return real_malloc(size);
+}
+
+RT_EXPORT void *calloc(size_t nmemb, size_t size)
+{
+    // The bootstrap arena is zero-initialized and never reused
+    if (resolving)
+        return bootstrap_alloc(nmemb * size);
+    resolve();
+
+    count(&allocs);
+    return real_calloc(nmemb, size);
+}
+
+RT_EXPORT void *realloc(void *ptr, size_t size)
+{
+    if (resolving)
+        return bootstrap_alloc(size);
+    resolve();
+
+    count(&allocs);
+    if (is_bootstrap(ptr))
+    {
+        // The size of the bootstrap block is unknown, copy as much as the arena holds
+        void *res       = real_malloc(size);
+        if (res != NULL)
+        {
+            size_t avail    = &bootstrap[RT_BOOTSTRAP_SIZE] - (char *)ptr;
+            memcpy(res, ptr, (size < avail) ? size : avail);
+        }
+        return res;
+    }
+    return real_realloc(ptr, size);
+}
+
+RT_EXPORT void free(void *ptr)
+{
+    if ((ptr == NULL) || (is_bootstrap(ptr)))
+        return;
+    resolve();
+
+    count(&frees);
+    real_free(ptr);
+}
+
+RT_EXPORT int posix_memalign(void **ptr, size_t alignment, size_t size)
+{
+    if (resolving)
+    {
+        *ptr            = bootstrap_alloc(size);
+        return (*ptr != NULL) ? 0 : ENOMEM;
+    }
+    resolve();
+
+    count(&allocs);
+    return real_posix_memalign(ptr, alignment, size);
+}
+
+RT_EXPORT void *aligned_alloc(size_t alignment, size_t size)
+{
+    if (resolving)
+        return bootstrap_alloc(size);
+    resolve();
+
+    count(&allocs);
+    return real_aligned_alloc(alignment, size);
+}
+
+RT_EXPORT void *memalign(size_t alignment, size_t size)
+{
+    if (resolving)
+        return bootstrap_alloc(size);
+    resolve();
+
+    count(&allocs);
+    return real_memalign(alignment, size);
+}
+
+RT_EXPORT int pthread_mutex_lock(pthread_mutex_t *mutex)
+{
+    if (resolving)
+        return 0;
+    resolve();
+
+    count(&locks);
+    return real_mutex_lock(mutex);
+}
+
+RT_EXPORT int pthread_mutex_trylock(pthread_mutex_t *mutex)
+{
+    if (resolving)
+        return 0;
+    resolve();
+
+    count(&locks);
+    return real_mutex_trylock(mutex);
+}
+
+/**
+ * Enable or disable counting for the current thread, enabling resets the counters
+ * @param enable non-zero to enable counting
+ */
+RT_EXPORT void autogain_rt_arm(int enable)
+{
+    if (enable)
+    {
+        allocs          = 0;
+        frees           = 0;
+        locks           = 0;
+    }
+    armed           = enable;
+}
+
+/**
+ * Get the counters of the current thread
+ * @param n_allocs number of allocations
+ * @param n_frees number of deallocations
+ * @param n_locks number of mutex locks
+ */
+RT_EXPORT void autogain_rt_counters(size_t *n_allocs, size_t *n_frees, size_t *n_locks)
+{
+    *n_allocs       = allocs;
+    *n_frees        = frees;
+    *n_locks        = locks;
+}
@@ -0,0 +1,275 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-plugins-autogain
+ * Created on: 18 окт 2026 г.
+ *
+ * lsp-plugins-autogain is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-plugins-autogain is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-plugins-autogain. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <lsp-plug.in/test-fw/utest.h>
+#include <lsp-plug.in/plug-fw/plug.h>
+#include <private/meta/autogain.h>
+#include <private/plugins/autogain.h>
+#include <private/plugins/autogain_follower.h>
+#include <private/test/TestPorts.h>
+#include <private/util/LoadMeter.h>
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+namespace
+{
+    using namespace lsp;
+
+    static constexpr size_t SAMPLE_RATE     = 48000;
+    static constexpr size_t DURATION        = SAMPLE_RATE * 5;
+    static constexpr size_t MAX_BLOCK       = 0x1400;
+    static constexpr size_t MAX_PORTS       = plugins::TestPorts::MAX_AUDIO;
+    static constexpr size_t MAX_BLOCKS      = DURATION;
+    static constexpr size_t TIMING_BLOCK    = 0x100;    // Minimum block size accounted by the timing statistics
+    static constexpr float  TIMING_RATIO    = 4.0f;     // Maximum ratio of median processing times of aliased and separate buffers
+
+    // Output port with the index of the audio output shares the buffer with the audio input
+    typedef struct alias_t
+    {
+        ssize_t         nOut;
+        ssize_t         nIn;
+    } alias_t;
+
+    typedef struct config_t
+    {
+        const char             *sName;
+        const meta::plugin_t   *pMeta;
+        bool                    bFollower;
+        ssize_t                 nScMode;    // Index of the sidechain mode in the combo, negative for default
+        alias_t                 vAlias[3];
+    } config_t;
+
+    typedef struct timing_t
+    {
+        double                  fMean;      // Mean processing time of the sample, nanoseconds
+        double                  fStdDev;    // Standard deviation of the processing time of the sample
+        double                  fMedian;    // Median processing time of the sample
+        double                  fP99;       // 99th percentile of the processing time of the sample
+    } timing_t;
+
+    #define ALIAS_END   { -1, -1 }
+
+    // Audio inputs and outputs are numbered in the order of ports, the shared memory link
+    // appears and disappears between blocks when the sidechain mode uses the link
+    static const config_t configs[] =
+    {
+        { "mono in-place", &meta::autogain_mono, false, -1, { { 0, 0 }, ALIAS_END } },
+        { "stereo in-place", &meta::autogain_stereo, false, -1, { { 0, 0 }, { 1, 1 }, ALIAS_END } },
+        { "stereo cross", &meta::autogain_stereo, false, -1, { { 0, 1 }, { 1, 0 }, ALIAS_END } },
+        { "stereo link in-place", &meta::autogain_stereo, false, 2, { { 0, 0 }, { 1, 1 }, ALIAS_END } },
+        { "sc stereo in-place", &meta::sc_autogain_stereo, false, -1, { { 0, 0 }, { 1, 1 }, ALIAS_END } },
+        { "sc stereo to sidechain", &meta::sc_autogain_stereo, false, -1, { { 0, 2 }, { 1, 3 }, ALIAS_END } },
+        { "sc stereo link cross", &meta::sc_autogain_stereo, false, 3, { { 0, 1 }, { 1, 0 }, ALIAS_END } },
+        { "env stereo envelope", &meta::autogain_env_stereo, false, -1, { { 2, 0 }, ALIAS_END } },
+        { "env stereo mixed", &meta::autogain_env_stereo, false, -1, { { 2, 1 }, { 0, 0 }, { 1, 1 } } },
+        { "env mono link envelope", &meta::autogain_env_mono, false, 1, { { 1, 0 }, ALIAS_END } },
+        { "follower mono envelope", &meta::autogain_follower_mono, true, -1, { { 0, 1 }, ALIAS_END } },
+        { "follower stereo in-place", &meta::autogain_follower_stereo, true, -1, { { 0, 0 }, { 1, 1 }, ALIAS_END } },
+        { "follower stereo envelope", &meta::autogain_follower_stereo, true, -1, { { 0, 2 }, { 1, 0 }, ALIAS_END } }
+    };
+
+    #undef ALIAS_END
+
+    int compare_times(const void *a, const void *b)
+    {
+        const double da = *static_cast<const double *>(a);
+        const double db = *static_cast<const double *>(b);
+        return (da < db) ? -1 : (da > db) ? 1 : 0;
+    }
+}
+
+UTEST_BEGIN("autogain", aliasing)
+
+    uint32_t    nRandom;
+
+    inline uint32_t next()
+    {
+        nRandom     = nRandom * 1664525 + 1013904223;
+        return nRandom;
+    }
+
+    // Block sizes: edge cases first, then pseudo-random sizes up to the maximum block
+    size_t block_size(size_t index)
+    {
+        static const size_t edges[] = { 0, 1, 2, 3, 1023, 1024, 1025, 4099, MAX_BLOCK };
+        if (index < sizeof(edges)/sizeof(size_t))
+            return edges[index];
+        const size_t limit  = ((next() >> 8) & 0x3) ? 0x200 : MAX_BLOCK + 1;
+        return (next() >> 8) % limit;
+    }
+
+    // Input signal: tone bursts mixed with noise with the level changing every half a second,
+    // the gain envelope of the follower is kept within the range of 0..1
+    float input(size_t port, size_t sample, bool envelope)
+    {
+        const float phase   = 2.0f * M_PI * (220.0f * (port + 1)) * float(sample % SAMPLE_RATE) / float(SAMPLE_RATE);
+        const float level   = ((sample / (SAMPLE_RATE / 2) + port) % 3) * 0.4f + 0.05f;
+        const float noise   = (int32_t(next()) >> 8) * (1.0f / 0x800000) * 0.1f;
+        return (envelope) ? 0.5f + 0.5f * sinf(phase * 0.01f) : level * sinf(phase) + noise;
+    }
+
+    void compute_timing(timing_t *t, double *times, size_t count)
+    {
+        t->fMean        = 0.0;
+        t->fStdDev      = 0.0;
+        t->fMedian      = 0.0;
+        t->fP99         = 0.0;
+        if (count <= 0)
+            return;
+
+        for (size_t i=0; i<count; ++i)
+            t->fMean       += times[i];
+        t->fMean       /= double(count);
+        for (size_t i=0; i<count; ++i)
+            t->fStdDev     += (times[i] - t->fMean) * (times[i] - t->fMean);
+        t->fStdDev      = sqrt(t->fStdDev / double(count));
+
+        qsort(times, count, sizeof(double), compare_times);
+        t->fMedian      = times[count / 2];
+        t->fP99         = times[lsp_min((count * 99) / 100, count - 1)];
+    }
+
+    void run(const config_t *cfg, bool alias, float *result, timing_t *timing, double *times)
+    {
+        const meta::plugin_t *meta  = cfg->pMeta;
+        plug::Module *plugin        = (cfg->bFollower) ?
+            static_cast<plug::Module *>(new plugins::autogain_follower(meta)) :
+            static_cast<plug::Module *>(new plugins::autogain(meta));
+        UTEST_ASSERT(plugin != NULL);
+
+        plugins::TestPorts ports;
+        UTEST_ASSERT(ports.init(meta, MAX_BLOCK));
+        const size_t n_in   = ports.inputs();
+        const size_t n_out  = ports.outputs();
+        const size_t n_link = ports.links();
+
+        bool in_env[MAX_PORTS];
+        for (size_t i=0; i<n_in; ++i)
+            in_env[i]               = !strcmp(ports.input(i)->metadata()->id, "genv");
+        if (cfg->nScMode >= 0)
+            UTEST_ASSERT(ports.set_value("scmode", cfg->nScMode));
+
+        // Make outputs share the buffers with inputs
+        float *out_ptr[MAX_PORTS];
+        for (size_t i=0; i<n_out; ++i)
+            out_ptr[i]              = ports.out(i);
+        if (alias)
+        {
+            for (const alias_t *a = cfg->vAlias; (a < &cfg->vAlias[3]) && (a->nOut >= 0); ++a)
+            {
+                UTEST_ASSERT((size_t(a->nOut) < n_out) && (size_t(a->nIn) < n_in));
+                out_ptr[a->nOut]        = ports.in(a->nIn);
+                ports.output(a->nOut)->set_buffer(out_ptr[a->nOut]);
+            }
+        }
+
+        plugin->init(NULL, ports.ports());
+        plugin->set_sample_rate(SAMPLE_RATE);
+        plugin->update_settings();
+
+        // Process the same sequence of blocks and the same input in both runs
+        size_t n_times          = 0;
+        nRandom                 = 0x5eed;
+        for (size_t offset=0, block=0; offset < DURATION; ++block)
+        {
+            const size_t to_do      = lsp_min(block_size(block), DURATION - offset);
+
+            for (size_t i=0; i<n_in; ++i)
+                for (size_t j=0; j<to_do; ++j)
+                    ports.in(i)[j]          = input(i, offset + j, in_env[i]);
+
+            // The link connects and disconnects between blocks
+            if (n_link > 0)
+            {
+                const bool active       = (next() >> 8) & 0x1;
+                ports.set_link_active(active);
+                for (size_t i=0; (active) && (i<n_link); ++i)
+                    for (size_t j=0; j<to_do; ++j)
+                        ports.link_data(i)[j]   = input(n_in + i, offset + j, false);
+            }
+
+            const uint64_t start    = plugins::monotonic_nanos();
+            plugin->process(to_do);
+            const uint64_t time     = plugins::monotonic_nanos() - start;
+            if ((to_do >= TIMING_BLOCK) && (n_times < MAX_BLOCKS))
+                times[n_times++]        = double(time) / double(to_do);
+
+            for (size_t i=0; i<n_out; ++i)
+                memcpy(&result[i * DURATION + offset], out_ptr[i], to_do * sizeof(float));
+
+            offset                 += to_do;
+        }
+
+        plugin->destroy();
+        delete plugin;
+
+        compute_timing(timing, times, n_times);
+    }
+
+    UTEST_MAIN
+    {
+        float *r1       = new float[DURATION * MAX_PORTS];
+        float *r2       = new float[DURATION * MAX_PORTS];
+        double *times   = new double[MAX_BLOCKS];
+
+        for (size_t i=0; i<sizeof(configs)/sizeof(config_t); ++i)
+        {
+            const config_t *cfg = &configs[i];
+            printf("Testing %s...\n", cfg->sName);
+
+            size_t n_out = 0;
+            for (const meta::port_t *p = cfg->pMeta->ports; p->id != NULL; ++p)
+                if (meta::is_audio_out_port(p))
+                    ++n_out;
+
+            timing_t t1, t2;
+            run(cfg, false, r1, &t1, times);
+            run(cfg, true, r2, &t2, times);
+
+            // Aliased buffers should produce exactly the same output as separate ones
+            for (size_t j=0; j<n_out * DURATION; ++j)
+            {
+                UTEST_ASSERT_MSG(isfinite(r1[j]),
+                    "%s: non-finite output %d at sample %d", cfg->sName, int(j / DURATION), int(j % DURATION));
+                UTEST_ASSERT_MSG(r1[j] == r2[j],
+                    "%s: output %d differs at sample %d: %.8f vs %.8f",
+                    cfg->sName, int(j / DURATION), int(j % DURATION), r1[j], r2[j]);
+            }
+
+            // Copying the dry input for aliased buffers should not change the processing time
+            // significantly, the median is compared since single blocks may be preempted
+            printf("  separate: mean %.2f ns/sample, stddev %.2f, median %.2f, p99 %.2f\n",
+                t1.fMean, t1.fStdDev, t1.fMedian, t1.fP99);
+            printf("  aliased:  mean %.2f ns/sample, stddev %.2f, median %.2f, p99 %.2f\n",
+                t2.fMean, t2.fStdDev, t2.fMedian, t2.fP99);
+            UTEST_ASSERT_MSG(t2.fMedian <= t1.fMedian * TIMING_RATIO,
+                "%s: median processing time of aliased buffers %.2f ns/sample exceeds %.1f times of %.2f ns/sample",
+                cfg->sName, t2.fMedian, TIMING_RATIO, t1.fMedian);
+        }
+
+        delete [] r1;
+        delete [] r2;
+        delete [] times;
+    }
+
+UTEST_END
@@ -0,0 +1,256 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-plugins-autogain
+ * Created on: 18 окт 2026 г.
+ *
+ * lsp-plugins-autogain is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-plugins-autogain is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-plugins-autogain. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <lsp-plug.in/test-fw/utest.h>
+#include <lsp-plug.in/io/File.h>
+#include <lsp-plug.in/io/OutFileStream.h>
+#include <private/util/Capture.h>
+#include <private/util/CaptureReader.h>
+
+#include <stdio.h>
+#include <string.h>
+
+namespace
+{
+    using namespace lsp;
+
+    static constexpr size_t CHANNELS        = 2;
+    static constexpr size_t PORTS           = 12;
+    static constexpr size_t BLOCKS          = 50;
+    static constexpr size_t RING_SIZE       = 0x100;
+
+    // Block sizes cover empty blocks, partial frames and blocks split into several frames
+    static const size_t block_sizes[]       = { 0, 1, 59, 60, 61, 120, 257, 1024 };
+
+    void emit(plugins::capture_record_t *dst, size_t *count, const plugins::capture_record_t *rec)
+    {
+        if (dst != NULL)
+            dst[*count]     = *rec;
+        ++(*count);
+    }
+
+    void make_record(plugins::capture_record_t *rec, uint32_t type, uint32_t index, uint32_t count)
+    {
+        memset(rec, 0, sizeof(plugins::capture_record_t));
+        rec->nType      = type;
+        rec->nIndex     = index;
+        rec->nCount     = count;
+    }
+}
+
+UTEST_BEGIN("autogain", capture)
+
+    // Produces the session in the same order as the plugin does: parameters, block, audio of each channel,
+    // returns the number of records, only counts records if the destination is NULL
+    size_t generate_session(plugins::capture_record_t *dst)
+    {
+        plugins::capture_record_t rec;
+        size_t count = 0;
+
+        make_record(&rec, plugins::CR_SAMPLE_RATE, 0, 48000);
+        emit(dst, &count, &rec);
+
+        size_t sample = 0;
+        for (size_t i=0; i<BLOCKS; ++i)
+        {
+            make_record(&rec, plugins::CR_PARAM, i % PORTS, 0);
+            rec.vData[0]    = float(i) * 0.25f;
+            emit(dst, &count, &rec);
+
+            const size_t samples = block_sizes[i % (sizeof(block_sizes) / sizeof(block_sizes[0]))];
+            make_record(&rec, plugins::CR_BLOCK, 0, samples);
+            emit(dst, &count, &rec);
+
+            for (size_t j=0; j<CHANNELS; ++j)
+            {
+                const uint32_t type = (j & 1) ? plugins::CR_SIDECHAIN : plugins::CR_INPUT;
+                for (size_t offset=0; offset < samples; )
+                {
+                    size_t to_do    = lsp_min(samples - offset, plugins::CAPTURE_FRAME);
+                    make_record(&rec, type, j, to_do);
+                    for (size_t k=0; k<to_do; ++k)
+                        rec.vData[k]    = float(sample + offset + k) * (j + 1);
+                    emit(dst, &count, &rec);
+                    offset         += to_do;
+                }
+            }
+            sample         += samples;
+        }
+
+        return count;
+    }
+
+    void write_raw(const char *path, const void *data, size_t size)
+    {
+        io::OutFileStream os;
+        UTEST_ASSERT(os.open(path, io::File::FM_WRITE_NEW) == STATUS_OK);
+        UTEST_ASSERT(os.write(data, size) == ssize_t(size));
+        UTEST_ASSERT(os.close() == STATUS_OK);
+    }
+
+    void test_round_trip(const char *path)
+    {
+        printf("Writing capture file %s\n", path);
+
+        const size_t count  = generate_session(NULL);
+        plugins::capture_record_t *session = new plugins::capture_record_t[count];
+        generate_session(session);
+
+        // Write the session, the ring is smaller than the session to involve several passes of the writer
+        plugins::CaptureRing ring;
+        UTEST_ASSERT(ring.init(RING_SIZE) == STATUS_OK);
+        {
+            plugins::CaptureWriter writer(&ring);
+            UTEST_ASSERT(writer.open(path, CHANNELS, PORTS) == STATUS_OK);
+            UTEST_ASSERT(writer.opened());
+
+            for (size_t i=0; i<count; ++i)
+            {
+                if (!ring.push(&session[i]))
+                {
+                    UTEST_ASSERT(writer.run() == STATUS_OK);
+                    UTEST_ASSERT(ring.push(&session[i]));
+                }
+            }
+            writer.close();
+            UTEST_ASSERT(!writer.opened());
+            printf("  written %d records\n", int(count));
+        }
+        ring.destroy();
+
+        // Read the session back
+        plugins::CaptureReader reader;
+        UTEST_ASSERT(reader.open(path) == STATUS_OK);
+        UTEST_ASSERT(reader.opened());
+
+        const plugins::capture_header_t *hdr = reader.header();
+        UTEST_ASSERT(hdr->nMagic == plugins::CAPTURE_MAGIC);
+        UTEST_ASSERT(hdr->nVersion == plugins::CAPTURE_VERSION);
+        UTEST_ASSERT(hdr->nRecordSize == sizeof(plugins::capture_record_t));
+        UTEST_ASSERT(hdr->nChannels == CHANNELS);
+        UTEST_ASSERT(hdr->nPorts == PORTS);
+
+        plugins::capture_record_t rec;
+        for (size_t i=0; i<count; ++i)
+        {
+            status_t res = reader.read(&rec);
+            UTEST_ASSERT_MSG(res == STATUS_OK, "Error reading record %d: %d", int(i), int(res));
+            UTEST_ASSERT_MSG(memcmp(&session[i], &rec, sizeof(rec)) == 0,
+                "Record %d differs: type=%d, index=%d, count=%d",
+                int(i), int(rec.nType), int(rec.nIndex), int(rec.nCount));
+        }
+
+        UTEST_ASSERT(reader.read(&rec) == STATUS_EOF);
+        UTEST_ASSERT(reader.records() == count);
+        UTEST_ASSERT(reader.dropped() == 0);
+        reader.close();
+        UTEST_ASSERT(!reader.opened());
+
+        delete [] session;
+    }
+
+    void test_errors(const char *path)
+    {
+        plugins::CaptureReader reader;
+        plugins::capture_header_t hdr;
+        plugins::capture_record_t rec;
+
+        memset(&hdr, 0, sizeof(hdr));
+        hdr.nMagic          = plugins::CAPTURE_MAGIC;
+        hdr.nVersion        = plugins::CAPTURE_VERSION;
+        hdr.nRecordSize     = sizeof(plugins::capture_record_t);
+        hdr.nChannels       = CHANNELS;
+        hdr.nPorts          = PORTS;
+
+        // Truncated header
+        write_raw(path, &hdr, sizeof(hdr) - 1);
+        UTEST_ASSERT(reader.open(path) == STATUS_BAD_FORMAT);
+
+        // Invalid magic
+        hdr.nMagic          = 0x46464952; // 'RIFF'
+        write_raw(path, &hdr, sizeof(hdr));
+        UTEST_ASSERT(reader.open(path) == STATUS_BAD_FORMAT);
+        hdr.nMagic          = plugins::CAPTURE_MAGIC;
+
+        // Unsupported version
+        hdr.nVersion        = plugins::CAPTURE_VERSION + 1;
+        write_raw(path, &hdr, sizeof(hdr));
+        UTEST_ASSERT(reader.open(path) == STATUS_UNSUPPORTED_FORMAT);
+        hdr.nVersion        = plugins::CAPTURE_VERSION;
+
+        // Invalid record size
+        hdr.nRecordSize     = sizeof(plugins::capture_record_t) / 2;
+        write_raw(path, &hdr, sizeof(hdr));
+        UTEST_ASSERT(reader.open(path) == STATUS_BAD_FORMAT);
+        hdr.nRecordSize     = sizeof(plugins::capture_record_t);
+
+        // Empty session
+        write_raw(path, &hdr, sizeof(hdr));
+        UTEST_ASSERT(reader.open(path) == STATUS_OK);
+        UTEST_ASSERT(reader.read(&rec) == STATUS_EOF);
+        reader.close();
+
+        // Invalid records
+        uint8_t data[sizeof(hdr) + sizeof(rec) * 2];
+        const size_t invalid[][3] =
+        {
+            { plugins::CR_LINK + 1, 0, 0 },
+            { plugins::CR_PARAM, PORTS, 0 },
+            { plugins::CR_INPUT, CHANNELS, 1 },
+            { plugins::CR_SIDECHAIN, 0, plugins::CAPTURE_FRAME + 1 },
+        };
+        for (size_t i=0; i<sizeof(invalid)/sizeof(invalid[0]); ++i)
+        {
+            memcpy(data, &hdr, sizeof(hdr));
+            make_record(&rec, plugins::CR_BLOCK, 0, 16);
+            rec.nDropped        = 3;
+            memcpy(&data[sizeof(hdr)], &rec, sizeof(rec));
+            make_record(&rec, invalid[i][0], invalid[i][1], invalid[i][2]);
+            memcpy(&data[sizeof(hdr) + sizeof(rec)], &rec, sizeof(rec));
+            write_raw(path, data, sizeof(data));
+
+            UTEST_ASSERT(reader.open(path) == STATUS_OK);
+            UTEST_ASSERT(reader.read(&rec) == STATUS_OK);
+            UTEST_ASSERT(reader.dropped() == 3);
+            UTEST_ASSERT_MSG(reader.read(&rec) == STATUS_CORRUPTED, "Invalid record %d not detected", int(i));
+            reader.close();
+        }
+
+        // Truncated record
+        write_raw(path, data, sizeof(data) - 1);
+        UTEST_ASSERT(reader.open(path) == STATUS_OK);
+        UTEST_ASSERT(reader.read(&rec) == STATUS_OK);
+        UTEST_ASSERT(reader.read(&rec) == STATUS_CORRUPTED);
+        reader.close();
+    }
+
+    UTEST_MAIN
+    {
+        char path[PATH_MAX];
+
+        snprintf(path, sizeof(path), "%s/utest-%s.agc", tempdir(), full_name());
+        test_round_trip(path);
+
+        snprintf(path, sizeof(path), "%s/utest-%s-errors.agc", tempdir(), full_name());
+        test_errors(path);
+    }
+
+UTEST_END
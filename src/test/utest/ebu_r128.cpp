@@ -0,0 +1,187 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-plugins-autogain
+ * Created on: 18 окт 2026 г.
+ *
+ * lsp-plugins-autogain is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-plugins-autogain is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-plugins-autogain. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <lsp-plug.in/test-fw/utest.h>
+#include <lsp-plug.in/common/types.h>
+#include <lsp-plug.in/dsp-units/meters/LoudnessMeter.h>
+#include <lsp-plug.in/dsp-units/units.h>
+#include <private/util/LoudnessHistogram.h>
+
+#include <math.h>
+
+namespace
+{
+    // The configuration of the integrated loudness and loudness range metering used by the plugin
+    static constexpr size_t SAMPLE_RATE         = 48000;
+    static constexpr size_t BLOCK_SIZE          = 4800;     // 100 ms, 75% overlap of momentary blocks
+    static constexpr float MOMENTARY_PERIOD     = 400.0f;
+    static constexpr float SHORT_PERIOD         = 3000.0f;
+    static constexpr float INT_RELATIVE_GATE    = -10.0f;
+    static constexpr float LRA_RELATIVE_GATE    = -20.0f;
+    static constexpr float LRA_LOW_PERCENTILE   = 0.10f;
+    static constexpr float LRA_HIGH_PERCENTILE  = 0.95f;
+
+    typedef struct segment_t
+    {
+        float       fLevel;         // Level of the stereo 1 kHz sine wave, dBFS
+        float       fDuration;      // Duration of the segment, seconds
+    } segment_t;
+
+    typedef struct test_case_t
+    {
+        const char         *sName;
+        const segment_t    *vSegments;
+        size_t              nSegments;
+        float               fExpected;  // Expected integrated loudness (LUFS) or loudness range (LU)
+        float               fTolerance;
+    } test_case_t;
+
+    // EBU Tech 3341, cases 1-5: integrated loudness
+    static const segment_t tech3341_1[] = { { -23.0f, 20.0f } };
+    static const segment_t tech3341_2[] = { { -33.0f, 20.0f } };
+    static const segment_t tech3341_3[] = { { -36.0f, 10.0f }, { -23.0f, 60.0f }, { -36.0f, 10.0f } };
+    static const segment_t tech3341_4[] = { { -72.0f, 10.0f }, { -36.0f, 10.0f }, { -23.0f, 60.0f }, { -36.0f, 10.0f }, { -72.0f, 10.0f } };
+    static const segment_t tech3341_5[] = { { -26.0f, 20.0f }, { -20.0f, 20.1f }, { -26.0f, 20.0f } };
+
+    // EBU Tech 3342, cases 1-4: loudness range
+    static const segment_t tech3342_1[] = { { -20.0f, 20.0f }, { -30.0f, 20.0f } };
+    static const segment_t tech3342_2[] = { { -20.0f, 20.0f }, { -15.0f, 20.0f } };
+    static const segment_t tech3342_3[] = { { -40.0f, 20.0f }, { -20.0f, 20.0f } };
+    static const segment_t tech3342_4[] = { { -50.0f, 20.0f }, { -35.0f, 20.0f }, { -20.0f, 20.0f }, { -35.0f, 20.0f }, { -50.0f, 20.0f } };
+
+    #define TCASE(name, expected, tolerance) \
+        { #name, name, sizeof(name) / sizeof(segment_t), expected, tolerance }
+
+    static const test_case_t integrated_cases[] =
+    {
+        TCASE(tech3341_1, -23.0f, 0.1f),
+        TCASE(tech3341_2, -33.0f, 0.1f),
+        TCASE(tech3341_3, -23.0f, 0.1f),
+        TCASE(tech3341_4, -23.0f, 0.1f),
+        TCASE(tech3341_5, -23.0f, 0.1f)
+    };
+
+    static const test_case_t range_cases[] =
+    {
+        TCASE(tech3342_1, 10.0f, 1.0f),
+        TCASE(tech3342_2, 5.0f, 1.0f),
+        TCASE(tech3342_3, 20.0f, 1.0f),
+        TCASE(tech3342_4, 15.0f, 1.0f)
+    };
+
+    #undef TCASE
+}
+
+UTEST_BEGIN("autogain", ebu_r128)
+
+    void init_meter(lsp::dspu::LoudnessMeter *m, float period)
+    {
+        UTEST_ASSERT(m->init(2, period) == lsp::STATUS_OK);
+        m->set_sample_rate(SAMPLE_RATE);
+        m->set_period(period);
+        m->set_weighting(lsp::dspu::bs::WEIGHT_K);
+        m->set_designation(0, lsp::dspu::bs::CHANNEL_LEFT);
+        m->set_designation(1, lsp::dspu::bs::CHANNEL_RIGHT);
+        for (size_t i=0; i<2; ++i)
+        {
+            m->set_link(i, 1.0f);
+            m->set_active(i, true);
+        }
+    }
+
+    void measure(const test_case_t *tc, float *i_loudness, float *range)
+    {
+        lsp::dspu::LoudnessMeter m_meter, s_meter;
+        lsp::plugins::LoudnessHistogram i_hist, s_hist;
+
+        init_meter(&m_meter, MOMENTARY_PERIOD);
+        init_meter(&s_meter, SHORT_PERIOD);
+
+        float *in       = new float[BLOCK_SIZE];
+        float *m_out    = new float[BLOCK_SIZE];
+        float *s_out    = new float[BLOCK_SIZE];
+
+        // The same stereo signal is passed to both channels
+        for (size_t i=0; i<2; ++i)
+        {
+            m_meter.bind(i, NULL, in, 0);
+            s_meter.bind(i, NULL, in, 0);
+        }
+
+        // Generate the sine wave with continuous phase, take the loudness at the end of each block
+        const double w  = 2.0 * M_PI * 1000.0 / double(SAMPLE_RATE);
+        size_t phase    = 0;
+        for (size_t i=0; i<tc->nSegments; ++i)
+        {
+            const segment_t *s  = &tc->vSegments[i];
+            const float amp     = lsp::dspu::db_to_gain(s->fLevel);
+            const size_t length = size_t(s->fDuration * SAMPLE_RATE);
+
+            for (size_t offset=0; offset < length; offset += BLOCK_SIZE)
+            {
+                const size_t to_do  = lsp_min(length - offset, BLOCK_SIZE);
+                for (size_t j=0; j<to_do; ++j, ++phase)
+                    in[j]               = amp * sin(w * double(phase % SAMPLE_RATE));
+
+                m_meter.process(m_out, to_do, lsp::dspu::bs::DBFS_TO_LUFS_SHIFT_GAIN);
+                s_meter.process(s_out, to_do, lsp::dspu::bs::DBFS_TO_LUFS_SHIFT_GAIN);
+                if (to_do >= BLOCK_SIZE)
+                {
+                    i_hist.add(m_out[to_do - 1]);
+                    s_hist.add(s_out[to_do - 1]);
+                }
+            }
+        }
+
+        *i_loudness     = i_hist.integrated(INT_RELATIVE_GATE);
+        *range          = s_hist.range(LRA_RELATIVE_GATE, LRA_LOW_PERCENTILE, LRA_HIGH_PERCENTILE);
+
+        delete [] in;
+        delete [] m_out;
+        delete [] s_out;
+        m_meter.destroy();
+        s_meter.destroy();
+    }
+
+    UTEST_MAIN
+    {
+        float loudness, range;
+
+        for (size_t i=0; i<sizeof(integrated_cases)/sizeof(test_case_t); ++i)
+        {
+            const test_case_t *tc = &integrated_cases[i];
+            measure(tc, &loudness, &range);
+            printf("%s: integrated loudness = %.2f LUFS, expected %.2f LUFS\n", tc->sName, loudness, tc->fExpected);
+            UTEST_ASSERT_MSG(fabsf(loudness - tc->fExpected) <= tc->fTolerance,
+                "%s: integrated loudness %.2f LUFS, expected %.2f LUFS", tc->sName, loudness, tc->fExpected);
+        }
+
+        for (size_t i=0; i<sizeof(range_cases)/sizeof(test_case_t); ++i)
+        {
+            const test_case_t *tc = &range_cases[i];
+            measure(tc, &loudness, &range);
+            printf("%s: loudness range = %.2f LU, expected %.2f LU\n", tc->sName, range, tc->fExpected);
+            UTEST_ASSERT_MSG(fabsf(range - tc->fExpected) <= tc->fTolerance,
+                "%s: loudness range %.2f LU, expected %.2f LU", tc->sName, range, tc->fExpected);
+        }
+    }
+
+UTEST_END
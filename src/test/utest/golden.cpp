@@ -0,0 +1,327 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-plugins-autogain
+ * Created on: 18 окт 2026 г.
+ *
+ * lsp-plugins-autogain is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-plugins-autogain is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-plugins-autogain. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <lsp-plug.in/test-fw/utest.h>
+#include <lsp-plug.in/dsp/dsp.h>
+#include <lsp-plug.in/dsp-units/meters/LoudnessMeter.h>
+#include <lsp-plug.in/dsp-units/units.h>
+#include <lsp-plug.in/plug-fw/plug.h>
+#include <private/meta/autogain.h>
+#include <private/plugins/autogain.h>
+#include <private/test/TestPorts.h>
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ * Golden regression suite of the plugin. Each variant of the plugin is driven through each
+ * sidechain mode and each weighting function by the same deterministic scenario, and the
+ * loudness of the output and the gain correction at the end of each segment of the scenario
+ * are compared with the reference values stored below.
+ *
+ * The input and sidechain signals are sums of sine waves. The amplitude of each signal
+ * is calibrated by the loudness meter configured in the same way as the meters of
+ * the plugin, so the signals have the specified loudness for any weighting function and
+ * number of channels, and the reference values do not depend on the weighting function.
+ * The spectra of the input and the sidechain differ, so the meters using wrong weighting
+ * or wrong source make the gain deviate by several decibels.
+ */
+namespace
+{
+    using namespace lsp;
+
+    static constexpr size_t SAMPLE_RATE         = 48000;
+    static constexpr size_t BLOCK_SIZE          = 512;
+    static constexpr size_t SEGMENT_LENGTH      = SAMPLE_RATE * 15;
+    static constexpr size_t SEGMENTS            = 2;
+    static constexpr size_t CALIBRATION_LENGTH  = SAMPLE_RATE * 3;
+    static constexpr float  TARGET_LEVEL        = -23.0f;   // Desired loudness level, LUFS
+
+    static constexpr float  GAIN_TOLERANCE      = 0.5f;     // Tolerance of the settled gain and output loudness, dB
+    static constexpr float  CURVE_TOLERANCE     = 3.0f;     // Maximum overshoot of the gain curve within the segment, dB
+
+    // Loudness of the signals in each segment of the scenario, LUFS
+    static const float input_levels[SEGMENTS]       = { -33.0f, -15.0f };
+    static const float sidechain_levels[SEGMENTS]   = { -18.0f, -28.0f };
+
+    // Frequencies of sine waves of the input and the sidechain signals, Hz
+    static const float input_tones[]                = { 100.0f, 1000.0f, 4000.0f };
+    static const float sidechain_tones[]            = { 200.0f, 6000.0f };
+
+    enum control_t
+    {
+        CTL_INTERNAL,       // Gain is controlled by the input
+        CTL_CONTROL,        // Gain is controlled by the sidechain
+        CTL_MATCH           // Loudness of the input matches the loudness of the sidechain
+    };
+
+    typedef struct reference_t
+    {
+        float       vGain[SEGMENTS];        // Settled gain correction, dB
+        float       vOutput[SEGMENTS];      // Settled loudness of the output, LUFS
+    } reference_t;
+
+    // Reference values for each type of control
+    static const reference_t references[] =
+    {
+        { { 10.0f, -8.0f }, { -23.0f, -23.0f } },   // CTL_INTERNAL: target - input
+        { { -5.0f, 5.0f }, { -38.0f, -10.0f } },    // CTL_CONTROL: target - sidechain
+        { { 15.0f, -13.0f }, { -18.0f, -28.0f } }   // CTL_MATCH: sidechain - input
+    };
+
+    typedef struct scmode_t
+    {
+        const char     *sName;
+        control_t       enControl;
+        bool            bExternal;          // Control signal is passed to the sidechain input
+        bool            bLink;              // Control signal is passed to the shared memory link
+    } scmode_t;
+
+    // Sidechain modes in the order of the combo box of the plugins without and with sidechain inputs
+    static const scmode_t int_modes[] =
+    {
+        { "internal", CTL_INTERNAL, false, false },
+        { "control link", CTL_CONTROL, false, true },
+        { "match link", CTL_MATCH, false, true },
+        { NULL, CTL_INTERNAL, false, false }
+    };
+
+    static const scmode_t ext_modes[] =
+    {
+        { "internal", CTL_INTERNAL, false, false },
+        { "control", CTL_CONTROL, true, false },
+        { "match", CTL_MATCH, true, false },
+        { "control link", CTL_CONTROL, false, true },
+        { "match link", CTL_MATCH, false, true },
+        { NULL, CTL_INTERNAL, false, false }
+    };
+
+    typedef struct weighting_t
+    {
+        const char             *sName;
+        dspu::bs::weighting_t   enWeighting;
+    } weighting_t;
+
+    // Weighting functions in the order of the combo box
+    static const weighting_t weightings[] =
+    {
+        { "none", dspu::bs::WEIGHT_NONE },
+        { "A", dspu::bs::WEIGHT_A },
+        { "B", dspu::bs::WEIGHT_B },
+        { "C", dspu::bs::WEIGHT_C },
+        { "D", dspu::bs::WEIGHT_D },
+        { "K", dspu::bs::WEIGHT_K }
+    };
+
+    typedef struct variant_t
+    {
+        const meta::plugin_t   *pMeta;
+        const scmode_t         *vModes;
+    } variant_t;
+
+    static const variant_t variants[] =
+    {
+        { &meta::autogain_mono, int_modes },
+        { &meta::autogain_stereo, int_modes },
+        { &meta::sc_autogain_mono, ext_modes },
+        { &meta::sc_autogain_stereo, ext_modes },
+        { &meta::autogain_env_mono, int_modes },
+        { &meta::autogain_env_stereo, int_modes }
+    };
+
+    // Generate the sum of unit sine waves with continuous phase
+    void tones(float *dst, const float *freqs, size_t count, float amp, size_t offset, size_t samples)
+    {
+        for (size_t i=0; i<samples; ++i)
+        {
+            const size_t t  = (offset + i) % SAMPLE_RATE;
+            float v         = 0.0f;
+            for (size_t j=0; j<count; ++j)
+                v              += sinf(2.0f * M_PI * freqs[j] * float(t) / float(SAMPLE_RATE));
+            dst[i]          = amp * v;
+        }
+    }
+}
+
+UTEST_BEGIN("autogain", golden)
+
+    // Measure the loudness of the unit signal in the same way as the long-period meters of the plugin do
+    float calibrate(const float *freqs, size_t count, size_t channels, dspu::bs::weighting_t weighting)
+    {
+        dspu::LoudnessMeter meter;
+        UTEST_ASSERT(meter.init(channels, meta::autogain::LONG_PERIOD_MAX) == STATUS_OK);
+        meter.set_sample_rate(SAMPLE_RATE);
+        meter.set_period(meta::autogain::LONG_PERIOD_DFL);
+        meter.set_weighting(weighting);
+        if (channels > 1)
+        {
+            meter.set_designation(0, dspu::bs::CHANNEL_LEFT);
+            meter.set_designation(1, dspu::bs::CHANNEL_RIGHT);
+        }
+
+        float *in       = new float[BLOCK_SIZE];
+        float *out      = new float[BLOCK_SIZE];
+        for (size_t i=0; i<channels; ++i)
+            meter.bind(i, NULL, in, 0);
+
+        float level     = 0.0f;
+        for (size_t offset=0; offset < CALIBRATION_LENGTH; offset += BLOCK_SIZE)
+        {
+            tones(in, freqs, count, 1.0f, offset, BLOCK_SIZE);
+            meter.process(out, BLOCK_SIZE, dspu::bs::DBFS_TO_LUFS_SHIFT_GAIN);
+            level           = out[BLOCK_SIZE - 1];
+        }
+
+        delete [] in;
+        delete [] out;
+        meter.destroy();
+
+        return dspu::gain_to_db(level);
+    }
+
+    inline float port_db(plugins::TestPorts *ports, const char *id)
+    {
+        plugins::TestPort *p = ports->find(id);
+        return (p != NULL) ? dspu::gain_to_db(lsp_max(p->value(), GAIN_AMP_M_120_DB)) : -120.0f;
+    }
+
+    void run(const variant_t *v, size_t mode, size_t weight)
+    {
+        const meta::plugin_t *meta  = v->pMeta;
+        const scmode_t *sc          = &v->vModes[mode];
+        const weighting_t *w        = &weightings[weight];
+        const reference_t *ref      = &references[sc->enControl];
+        char name[128];
+        snprintf(name, sizeof(name), "%s, %s, weighting %s", meta->uid, sc->sName, w->sName);
+
+        plugins::TestPorts ports;
+        UTEST_ASSERT(ports.init(meta, BLOCK_SIZE));
+
+        // Split audio inputs into the main and the sidechain ones
+        float *in[plugins::TestPorts::MAX_AUDIO];
+        float *sc_in[plugins::TestPorts::MAX_AUDIO];
+        size_t n_in = 0, n_sc = 0;
+        for (size_t i=0; i<ports.inputs(); ++i)
+        {
+            if (!strncmp(ports.input(i)->metadata()->id, "sc", 2))
+                sc_in[n_sc++]       = ports.in(i);
+            else
+                in[n_in++]          = ports.in(i);
+        }
+        plugins::TestPort *genv     = ports.find("genv");
+        const float *env            = (genv != NULL) ? static_cast<const float *>(genv->buffer()) : NULL;
+
+        UTEST_ASSERT(ports.set_value("scmode", mode));
+        UTEST_ASSERT(ports.set_value("weight", weight));
+        UTEST_ASSERT(ports.set_value("level", TARGET_LEVEL));
+        ports.set_link_active(sc->bLink);
+
+        // Calibrate the amplitude of signals for the number of channels and the weighting function
+        const float in_unit = calibrate(input_tones, sizeof(input_tones)/sizeof(float), n_in, w->enWeighting);
+        const float sc_unit = calibrate(sidechain_tones, sizeof(sidechain_tones)/sizeof(float), n_in, w->enWeighting);
+
+        plugins::autogain *plugin   = new plugins::autogain(meta);
+        UTEST_ASSERT(plugin != NULL);
+        plugin->init(NULL, ports.ports());
+        plugin->set_sample_rate(SAMPLE_RATE);
+        plugin->update_settings();
+
+        float gain_start    = 0.0f;
+        for (size_t s=0; s<SEGMENTS; ++s)
+        {
+            const float in_amp  = dspu::db_to_gain(input_levels[s] - in_unit);
+            const float sc_amp  = dspu::db_to_gain(sidechain_levels[s] - sc_unit);
+            const float gain_lo = lsp_min(gain_start, ref->vGain[s]) - CURVE_TOLERANCE;
+            const float gain_hi = lsp_max(gain_start, ref->vGain[s]) + CURVE_TOLERANCE;
+
+            for (size_t offset=0; offset < SEGMENT_LENGTH; offset += BLOCK_SIZE)
+            {
+                const size_t to_do  = lsp_min(SEGMENT_LENGTH - offset, BLOCK_SIZE);
+                const size_t time   = s * SEGMENT_LENGTH + offset;
+
+                for (size_t i=0; i<n_in; ++i)
+                    tones(in[i], input_tones, sizeof(input_tones)/sizeof(float), in_amp, time, to_do);
+                for (size_t i=0; i<n_sc; ++i)
+                    tones(sc_in[i], sidechain_tones, sizeof(sidechain_tones)/sizeof(float), (sc->bExternal) ? sc_amp : 0.0f, time, to_do);
+                for (size_t i=0; (sc->bLink) && (i<ports.links()); ++i)
+                    tones(ports.link_data(i), sidechain_tones, sizeof(sidechain_tones)/sizeof(float), sc_amp, time, to_do);
+
+                plugin->process(to_do);
+
+                // The gain curve should move from the previous value to the new one without overshoot,
+                // the first block of the scenario defines the initial value of the gain
+                const float gain    = port_db(&ports, "g_g");
+                if ((s == 0) && (offset == 0))
+                    gain_start          = gain;
+                else
+                {
+                    UTEST_ASSERT_MSG((gain >= gain_lo) && (gain <= gain_hi),
+                        "%s: gain %.2f dB at %.3f s is out of range %.2f..%.2f dB",
+                        name, gain, float(time) / SAMPLE_RATE, gain_lo, gain_hi);
+                }
+            }
+
+            // Check the settled gain and loudness of the output
+            const float gain    = port_db(&ports, "g_g");
+            const float output  = port_db(&ports, "g_out_l");
+            printf("  %s, segment %d: gain %.2f dB (expected %.2f), output %.2f LUFS (expected %.2f)\n",
+                name, int(s), gain, ref->vGain[s], output, ref->vOutput[s]);
+
+            UTEST_ASSERT_MSG(fabsf(gain - ref->vGain[s]) <= GAIN_TOLERANCE,
+                "%s, segment %d: gain %.2f dB, expected %.2f dB", name, int(s), gain, ref->vGain[s]);
+            UTEST_ASSERT_MSG(fabsf(output - ref->vOutput[s]) <= GAIN_TOLERANCE,
+                "%s, segment %d: output loudness %.2f LUFS, expected %.2f LUFS", name, int(s), output, ref->vOutput[s]);
+            if (env != NULL)
+            {
+                const float env_gain    = dspu::gain_to_db(env[BLOCK_SIZE - 1]);
+                UTEST_ASSERT_MSG(fabsf(env_gain - ref->vGain[s]) <= GAIN_TOLERANCE,
+                    "%s, segment %d: gain envelope %.2f dB, expected %.2f dB", name, int(s), env_gain, ref->vGain[s]);
+            }
+
+            gain_start          = gain;
+        }
+
+        plugin->destroy();
+        delete plugin;
+    }
+
+    UTEST_MAIN
+    {
+        // Store the backend selected by the DSP library, the references are the same for all of them,
+        // other backends are checked by launching the test under the emulator that masks CPU features
+        dsp::info_t *info   = dsp::info();
+        if (info != NULL)
+        {
+            printf("DSP backend: %s, %s, features: %s\n", info->arch, info->cpu, info->features);
+            free(info);
+        }
+
+        for (size_t i=0; i<sizeof(variants)/sizeof(variant_t); ++i)
+        {
+            const variant_t *v  = &variants[i];
+            for (size_t j=0; v->vModes[j].sName != NULL; ++j)
+                for (size_t k=0; k<sizeof(weightings)/sizeof(weighting_t); ++k)
+                    run(v, j, k);
+        }
+    }
+
+UTEST_END
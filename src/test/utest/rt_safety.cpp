@@ -0,0 +1,216 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-plugins-autogain
+ * Created on: 18 окт 2026 г.
+ *
+ * lsp-plugins-autogain is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-plugins-autogain is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-plugins-autogain. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <lsp-plug.in/test-fw/utest.h>
+#include <lsp-plug.in/plug-fw/plug.h>
+#include <private/meta/autogain.h>
+#include <private/plugins/autogain.h>
+#include <private/test/TestPorts.h>
+#include <private/test/TestWrapper.h>
+
+#include <stdio.h>
+#include <string.h>
+
+/*
+ * Allocations and mutex locks are counted by the shim that interposes the C library functions,
+ * the shim is built as the separate shared library and is loaded with LD_PRELOAD, so the test
+ * binary itself keeps the regular allocator. Without the shim the test is skipped.
+ */
+#ifdef PLATFORM_LINUX
+    #define AUTOGAIN_RT_SHIM
+
+    #include <dlfcn.h>
+#endif /* PLATFORM_LINUX */
+
+namespace
+{
+    using namespace lsp;
+
+    static constexpr size_t SAMPLE_RATE     = 192000;
+    static constexpr size_t BLOCK_SIZE      = 0x200;
+    static constexpr size_t TOGGLES         = 64;
+    static constexpr size_t FILE_PERIOD     = 4;        // Period of file requests in toggles
+
+    typedef void (* rt_arm_t)(int enable);
+    typedef void (* rt_counters_t)(size_t *n_allocs, size_t *n_frees, size_t *n_locks);
+
+    // Controls switched on the real-time path, values are selected in turn
+    typedef struct toggle_t
+    {
+        const char     *sId;
+        float           vValues[6];
+        size_t          nValues;
+    } toggle_t;
+
+    static const toggle_t toggles[] =
+    {
+        { "mdecim", { 1.0f, 0.0f }, 2 },
+        { "weight", { 0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f }, 6 },
+        { "scmode", { 1.0f, 2.0f, 3.0f, 4.0f, 0.0f }, 5 },
+        { "tp_on", { 1.0f, 0.0f }, 2 },
+        { "lkahead", { 5.0f, meta::autogain::SC_LOOKAHEAD_MAX, 0.5f, 0.0f }, 4 },
+        { "tlm_on", { 1.0f, 0.0f }, 2 },
+        { "hlog_on", { 1.0f, 0.0f }, 2 }
+    };
+
+    // File ports served by the background tasks
+    static const char * const file_ports[] =
+    {
+        "tlm_file", "trc_file", "cap_file", "hlog_file",
+        NULL
+    };
+}
+
+UTEST_BEGIN("autogain", rt_safety)
+
+#ifdef AUTOGAIN_RT_SHIM
+    rt_arm_t        pArm;
+    rt_counters_t   pCounters;
+
+    void set_toggle(plugins::TestPorts *ports, const toggle_t *t, size_t step)
+    {
+        plugins::TestPort *p    = ports->find(t->sId);
+        if (p == NULL)
+            return;
+
+        // Sidechain modes are limited by the number of items of the combo
+        const meta::port_t *port = p->metadata();
+        float value             = t->vValues[step % t->nValues];
+        if (port->unit == meta::U_ENUM)
+        {
+            size_t items = 0;
+            while (port->items[items].text != NULL)
+                ++items;
+            if (value >= items)
+                value                   = 0.0f;
+        }
+        p->set_value(value);
+    }
+
+    void request_files(plugins::TestPorts *ports, const meta::plugin_t *meta, bool open)
+    {
+        char path[PATH_MAX];
+        for (size_t i=0; file_ports[i] != NULL; ++i)
+        {
+            if (open)
+                snprintf(path, sizeof(path), "%s/utest-%s-%s-%s", tempdir(), full_name(), meta->uid, file_ports[i]);
+            else
+                path[0]     = '\0';
+            ports->set_path(file_ports[i], path);
+        }
+    }
+
+    void test_plugin(const meta::plugin_t *meta)
+    {
+        printf("Testing %s...\n", meta->uid);
+
+        plugins::autogain *plugin   = new plugins::autogain(meta);
+        plugins::TestExecutor executor;
+        plugins::TestWrapper wrapper(plugin, &executor);
+
+        plugins::TestPorts ports;
+        UTEST_ASSERT(ports.init(meta, BLOCK_SIZE));
+        for (size_t i=0; i<ports.inputs(); ++i)
+            for (size_t j=0; j<BLOCK_SIZE; ++j)
+                ports.in(i)[j]          = ((j >> 4) & 1) ? 0.25f : -0.25f;
+
+        size_t n_files  = 0;
+        for (size_t i=0; file_ports[i] != NULL; ++i)
+            if (ports.find(file_ports[i]) != NULL)
+                ++n_files;
+
+        // Initialize the plugin and process few blocks outside of the measurement
+        plugin->init(&wrapper, ports.ports());
+        plugin->set_sample_rate(SAMPLE_RATE);
+        plugin->update_settings();
+        for (size_t i=0; i<16; ++i)
+            plugin->process(BLOCK_SIZE);
+        executor.run();
+
+        // Switch the controls and request the files on the real-time path, the background
+        // tasks are executed between measurements in the same way as the host executor does
+        for (size_t i=0; i<TOGGLES; ++i)
+        {
+            const size_t count      = sizeof(toggles) / sizeof(toggle_t);
+            set_toggle(&ports, &toggles[i % count], i / count);
+            ports.set_link_active(i & 0x1);
+            if ((i % FILE_PERIOD) == 0)
+                request_files(&ports, meta, ((i / FILE_PERIOD) & 0x1) == 0);
+
+            size_t n_allocs = 0, n_frees = 0, n_locks = 0;
+            pArm(1);
+            plugin->update_settings();
+            plugin->process(BLOCK_SIZE);
+            plugin->process(1);
+            plugin->process(BLOCK_SIZE - 1);
+            pArm(0);
+            pCounters(&n_allocs, &n_frees, &n_locks);
+
+            executor.run();
+
+            UTEST_ASSERT_MSG(n_allocs == 0,
+                "%s: %d allocations on toggle %d", meta->uid, int(n_allocs), int(i));
+            UTEST_ASSERT_MSG(n_frees == 0,
+                "%s: %d deallocations on toggle %d", meta->uid, int(n_frees), int(i));
+            UTEST_ASSERT_MSG(n_locks == 0,
+                "%s: %d mutex locks on toggle %d", meta->uid, int(n_locks), int(i));
+        }
+
+        // Complete the pending requests, each file port should have submitted it's task
+        for (size_t i=0; i<4; ++i)
+        {
+            plugin->process(BLOCK_SIZE);
+            executor.run();
+        }
+        printf("  %d submits of %d tasks\n", int(executor.submits()), int(executor.distinct()));
+        UTEST_ASSERT_MSG(executor.distinct() >= n_files,
+            "%s: only %d of %d file tasks have been submitted", meta->uid, int(executor.distinct()), int(n_files));
+        for (size_t i=0; file_ports[i] != NULL; ++i)
+            UTEST_ASSERT_MSG(ports.path_idle(file_ports[i]),
+                "%s: request of %s has not been committed", meta->uid, file_ports[i]);
+
+        plugin->destroy();
+        delete plugin;
+    }
+#endif /* AUTOGAIN_RT_SHIM */
+
+    UTEST_MAIN
+    {
+    #ifdef AUTOGAIN_RT_SHIM
+        pArm        = reinterpret_cast<rt_arm_t>(dlsym(RTLD_DEFAULT, "autogain_rt_arm"));
+        pCounters   = reinterpret_cast<rt_counters_t>(dlsym(RTLD_DEFAULT, "autogain_rt_counters"));
+        if ((pArm == NULL) || (pCounters == NULL))
+        {
+            printf("Real-time safety shim is not loaded, skipping. Launch the test with\n"
+                "LD_PRELOAD=<build>/lsp-plugins-autogain-rt-intercept.so to enable it\n");
+            return;
+        }
+
+        test_plugin(&meta::autogain_mono);
+        test_plugin(&meta::autogain_stereo);
+        test_plugin(&meta::sc_autogain_stereo);
+        test_plugin(&meta::autogain_env_stereo);
+    #else
+        printf("Real-time safety shim is not supported on this platform, skipping\n");
+    #endif /* AUTOGAIN_RT_SHIM */
+    }
+
+UTEST_END
@@ -0,0 +1,92 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-plugins-autogain
+ * Created on: 18 окт 2026 г.
+ *
+ * lsp-plugins-autogain is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-plugins-autogain is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-plugins-autogain. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <lsp-plug.in/test-fw/utest.h>
+#include <private/util/SignalGenerator.h>
+
+#include <string.h>
+
+namespace
+{
+    static constexpr size_t SAMPLE_RATE     = 48000;
+    static constexpr size_t DURATION        = SAMPLE_RATE * 20;
+    static constexpr size_t MAX_BLOCK       = 0x400;
+
+    // Irregular block sizes, including the minimal and the maximal ones
+    static const size_t block_sizes[]       = { 1, 7, 64, 333, MAX_BLOCK, 2, 511, 1000, 3 };
+}
+
+UTEST_BEGIN("autogain", signal_generator)
+
+    void generate(lsp::plugins::SignalGenerator::scenario_t scenario, float *main, float *sc, bool fixed)
+    {
+        lsp::plugins::SignalGenerator g;
+        UTEST_ASSERT(g.init(scenario, MAX_BLOCK) == lsp::STATUS_OK);
+        g.set_sample_rate(SAMPLE_RATE);
+
+        for (size_t offset=0, i=0; offset < DURATION; ++i)
+        {
+            size_t to_do    = (fixed) ? MAX_BLOCK : block_sizes[i % (sizeof(block_sizes)/sizeof(size_t))];
+            to_do           = lsp_min(to_do, DURATION - offset);
+
+            g.process(to_do);
+            memcpy(&main[offset], g.signal(), to_do * sizeof(float));
+            memcpy(&sc[offset], g.sidechain(), to_do * sizeof(float));
+            offset         += to_do;
+        }
+
+        g.destroy();
+    }
+
+    UTEST_MAIN
+    {
+        float *main1    = new float[DURATION];
+        float *sc1      = new float[DURATION];
+        float *main2    = new float[DURATION];
+        float *sc2      = new float[DURATION];
+
+        for (size_t i=lsp::plugins::SignalGenerator::SG_NONE + 1; i<lsp::plugins::SignalGenerator::SG_TOTAL; ++i)
+        {
+            const lsp::plugins::SignalGenerator::scenario_t scenario = lsp::plugins::SignalGenerator::scenario_t(i);
+            printf("Testing scenario %d...\n", int(i));
+
+            generate(scenario, main1, sc1, true);
+            generate(scenario, main2, sc2, false);
+
+            // The output should be sample-exact regardless of the block size
+            for (size_t j=0; j<DURATION; ++j)
+            {
+                UTEST_ASSERT_MSG(main1[j] == main2[j],
+                    "Scenario %d: main signal differs at sample %d: %.8f vs %.8f",
+                    int(i), int(j), main1[j], main2[j]);
+                UTEST_ASSERT_MSG(sc1[j] == sc2[j],
+                    "Scenario %d: sidechain signal differs at sample %d: %.8f vs %.8f",
+                    int(i), int(j), sc1[j], sc2[j]);
+            }
+        }
+
+        delete [] main1;
+        delete [] sc1;
+        delete [] main2;
+        delete [] sc2;
+    }
+
+UTEST_END
@@ -0,0 +1,412 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-plugins-autogain
+ * Created on: 18 окт 2026 г.
+ *
+ * lsp-plugins-autogain is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-plugins-autogain is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-plugins-autogain. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <lsp-plug.in/test-fw/utest.h>
+#include <lsp-plug.in/dsp/dsp.h>
+#include <lsp-plug.in/dsp-units/meters/LoudnessMeter.h>
+#include <lsp-plug.in/dsp-units/units.h>
+#include <lsp-plug.in/plug-fw/plug.h>
+#include <private/meta/autogain.h>
+#include <private/plugins/autogain.h>
+#include <private/test/TestPorts.h>
+#include <private/util/LoadMeter.h>
+#include <private/util/SignalGenerator.h>
+
+#include <float.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+namespace
+{
+    using namespace lsp;
+
+    static constexpr size_t SAMPLE_RATE     = 48000;
+    static constexpr size_t MAX_BLOCK       = 0x400;
+    static constexpr size_t GEN_DURATION    = SAMPLE_RATE * 60 * 15;    // 15 minutes of audio
+
+    // The plugin runs as fast as possible, so an hour of audio takes few tens of seconds
+    static constexpr size_t SOAK_DURATION   = SAMPLE_RATE * 60 * 60;    // 1 hour of audio
+    static constexpr size_t SOAK_BLOCK      = 0x800;                    // Maximum block size
+    static constexpr size_t PROBE_PERIOD    = SAMPLE_RATE * 60 * 5;     // Period of probes of the plugin state
+    static constexpr size_t PROBE_TONE      = SAMPLE_RATE * 20;         // Length of the tone of the probe
+    static constexpr size_t PROBE_SILENCE   = SAMPLE_RATE * 2;          // Length of the silence after the tone
+    static constexpr size_t TIMING_BLOCK    = 0x100;                    // Minimum block size accounted by the timing statistics
+    static constexpr float  PROBE_FREQ      = 997.0f;                   // Frequency of the probe tone, Hz
+
+    static constexpr float  METER_TOLERANCE = 0.2f;     // Tolerance of the loudness measured by the plugin, dB
+    static constexpr float  GAIN_TOLERANCE  = 0.5f;     // Tolerance of the gain correction and the output loudness, dB
+    static constexpr float  SILENCE_RANGE   = 60.0f;    // Minimum fall of the loudness after the tone stops, dB
+    static constexpr float  LOAD_P99_MAX    = 1.0f;     // Maximum 99th percentile of the block load
+
+    // Loudness of the probe tone, the level alternates between probes
+    static const float probe_levels[]       = { -35.0f, -14.0f };
+
+    // Controls changed by the automation, defaults are restored for the probe
+    static const char * const automated[] =
+    {
+        "lperiod", "speriod", "weight", "level", "drift", "silence", "max_on", "max_amp", "qamp",
+        "vgrow_l", "tgrow_l", "vfall_l", "tfall_l", "vgrow_s", "tgrow_s", "vfall_s", "tfall_s",
+        "preamp", "lkahead", "scmode", "tp_on", "tp_ceil", "mdecim",
+        NULL
+    };
+
+    int compare_loads(const void *a, const void *b)
+    {
+        const float fa = *static_cast<const float *>(a);
+        const float fb = *static_cast<const float *>(b);
+        return (fa < fb) ? -1 : (fa > fb) ? 1 : 0;
+    }
+}
+
+UTEST_BEGIN("autogain", soak)
+
+    uint32_t    nRandom;
+
+    inline uint32_t next()
+    {
+        nRandom     = nRandom * 1664525 + 1013904223;
+        return nRandom;
+    }
+
+    inline float random(float min, float max)
+    {
+        return min + (max - min) * float(next() >> 8) / float(0x1000000);
+    }
+
+    void test_load_meter()
+    {
+        plugins::LoadMeter m;
+        m.set_sample_rate(SAMPLE_RATE);
+
+        // Each block lasts one second, so the load is far below the first bucket limit and
+        // all blocks are counted by the first bucket unless the thread gets preempted. The last
+        // bucket can not be reached by the preemption, so it's value is known exactly
+        const uint32_t blocks   = 0x1000;
+        m.preload(0, plugins::LoadMeter::BUCKET_MAX - 2);
+        m.preload(plugins::LoadMeter::BUCKETS - 1, 1001);
+
+        for (uint32_t i=0; i<blocks; ++i)
+        {
+            m.begin();
+            m.end(SAMPLE_RATE);
+        }
+
+        for (size_t i=0; i<plugins::LoadMeter::BUCKETS; ++i)
+        {
+            const uint32_t v    = m.bucket(i);
+            UTEST_ASSERT_MSG(v < plugins::LoadMeter::BUCKET_MAX,
+                "Bucket %d has overflown: 0x%x", int(i), unsigned(v));
+        }
+
+        // The histogram has been halved exactly once when the first bucket reached the limit
+        const uint32_t first    = m.bucket(0);
+        printf("First bucket: 0x%x, last bucket: %u\n", unsigned(first), unsigned(m.bucket(plugins::LoadMeter::BUCKETS - 1)));
+        UTEST_ASSERT_MSG(first >= (plugins::LoadMeter::BUCKET_MAX >> 1),
+            "Histogram lost the counts after halving: 0x%x", unsigned(first));
+        UTEST_ASSERT_MSG(first <= (plugins::LoadMeter::BUCKET_MAX >> 1) + blocks,
+            "Histogram has not been halved: 0x%x", unsigned(first));
+        UTEST_ASSERT(m.bucket(plugins::LoadMeter::BUCKETS - 1) == 500);
+        UTEST_ASSERT(m.overruns() == 0);
+    }
+
+    void test_generator(plugins::SignalGenerator::scenario_t scenario)
+    {
+        plugins::SignalGenerator g;
+        UTEST_ASSERT(g.init(scenario, MAX_BLOCK) == STATUS_OK);
+        g.set_sample_rate(SAMPLE_RATE);
+
+        // Long silence gaps should not leave the envelope in the denormal range,
+        // and the signal should keep it's level over the whole run
+        double head = 0.0, tail = 0.0;
+        const size_t window = SAMPLE_RATE * 60;
+        for (size_t offset=0; offset < GEN_DURATION; offset += MAX_BLOCK)
+        {
+            g.process(MAX_BLOCK);
+            const float *s      = g.signal();
+            const float *sc     = g.sidechain();
+
+            for (size_t i=0; i<MAX_BLOCK; ++i)
+            {
+                UTEST_ASSERT_MSG(isfinite(s[i]) && isfinite(sc[i]),
+                    "Scenario %d: non-finite sample at %d", int(scenario), int(offset + i));
+                UTEST_ASSERT_MSG((s[i] == 0.0f) || (fabsf(s[i]) >= FLT_MIN),
+                    "Scenario %d: denormal main sample at %d: %g", int(scenario), int(offset + i), s[i]);
+                UTEST_ASSERT_MSG((sc[i] == 0.0f) || (fabsf(sc[i]) >= FLT_MIN),
+                    "Scenario %d: denormal sidechain sample at %d: %g", int(scenario), int(offset + i), sc[i]);
+
+                if (offset + i < window)
+                    head               += double(s[i]) * double(s[i]);
+                else if (offset + i >= GEN_DURATION - window)
+                    tail               += double(s[i]) * double(s[i]);
+            }
+        }
+
+        // Scenarios repeat with the period shorter than the window, so the energy stays within few dB
+        const double head_db    = 10.0 * log10(head / window + 1e-20);
+        const double tail_db    = 10.0 * log10(tail / window + 1e-20);
+        printf("Scenario %d: first minute %.2f dB, last minute %.2f dB\n", int(scenario), head_db, tail_db);
+        UTEST_ASSERT_MSG(fabs(head_db - tail_db) < 3.0,
+            "Scenario %d: level drifted from %.2f dB to %.2f dB", int(scenario), head_db, tail_db);
+
+        g.destroy();
+    }
+
+    // Measure the loudness of the unit probe tone in the same way as the long-period meters of the plugin do
+    float calibrate(size_t channels)
+    {
+        dspu::LoudnessMeter meter;
+        UTEST_ASSERT(meter.init(channels, meta::autogain::LONG_PERIOD_MAX) == STATUS_OK);
+        meter.set_sample_rate(SAMPLE_RATE);
+        meter.set_period(meta::autogain::LONG_PERIOD_DFL);
+        meter.set_weighting(dspu::bs::WEIGHT_K);
+        if (channels > 1)
+        {
+            meter.set_designation(0, dspu::bs::CHANNEL_LEFT);
+            meter.set_designation(1, dspu::bs::CHANNEL_RIGHT);
+        }
+
+        float *in       = new float[MAX_BLOCK];
+        float *out      = new float[MAX_BLOCK];
+        for (size_t i=0; i<channels; ++i)
+            meter.bind(i, NULL, in, 0);
+
+        float level     = 0.0f;
+        for (size_t offset=0; offset < SAMPLE_RATE * 2; offset += MAX_BLOCK)
+        {
+            tone(in, 1.0f, offset, MAX_BLOCK);
+            meter.process(out, MAX_BLOCK, dspu::bs::DBFS_TO_LUFS_SHIFT_GAIN);
+            level           = out[MAX_BLOCK - 1];
+        }
+
+        delete [] in;
+        delete [] out;
+        meter.destroy();
+
+        return dspu::gain_to_db(level);
+    }
+
+    void tone(float *dst, float amp, size_t offset, size_t samples)
+    {
+        for (size_t i=0; i<samples; ++i)
+            dst[i]          = amp * sinf(2.0f * M_PI * PROBE_FREQ * float((offset + i) % SAMPLE_RATE) / float(SAMPLE_RATE));
+    }
+
+    inline float port_db(plugins::TestPorts *ports, const char *id)
+    {
+        plugins::TestPort *p = ports->find(id);
+        return (p != NULL) ? dspu::gain_to_db(lsp_max(p->value(), GAIN_AMP_M_120_DB)) : -120.0f;
+    }
+
+    // Change the random control to the random value within it's range
+    void automate(plugins::TestPorts *ports)
+    {
+        size_t count = 0;
+        while (automated[count] != NULL)
+            ++count;
+
+        plugins::TestPort *p        = ports->find(automated[next() % count]);
+        if (p == NULL)
+            return;
+
+        const meta::port_t *port    = p->metadata();
+        if (port->unit == meta::U_ENUM)
+        {
+            size_t items = 0;
+            while (port->items[items].text != NULL)
+                ++items;
+            p->set_value(port->min + float(next() % items));
+        }
+        else if (port->unit == meta::U_BOOL)
+            p->set_value(next() & 0x1);
+        else
+            p->set_value(random(port->min, port->max));
+
+        ports->set_link_active(next() & 0x1);
+    }
+
+    // Process the block and collect the load relative to the deadline
+    void process(plugins::autogain *plugin, size_t samples, float *loads, size_t *n_loads)
+    {
+        const uint64_t start    = plugins::monotonic_nanos();
+        plugin->process(samples);
+        const uint64_t time     = plugins::monotonic_nanos() - start;
+
+        if (samples >= TIMING_BLOCK)
+            loads[(*n_loads)++]     = float(double(time) * double(SAMPLE_RATE) / (double(samples) * 1e+9));
+    }
+
+    // Feed the calibrated tone with default settings and check the meters and the gain correction
+    void probe(plugins::autogain *plugin, plugins::TestPorts *ports, size_t index, float unit, float *loads, size_t *n_loads)
+    {
+        const float level   = probe_levels[index % (sizeof(probe_levels)/sizeof(float))];
+        const float amp     = dspu::db_to_gain(level - unit);
+
+        UTEST_ASSERT(plugin->set_generator(plugins::SignalGenerator::SG_NONE) == STATUS_OK);
+        for (size_t i=0; automated[i] != NULL; ++i)
+        {
+            plugins::TestPort *p    = ports->find(automated[i]);
+            if (p != NULL)
+                p->set_value(p->metadata()->start);
+        }
+        ports->set_value("scmode", meta::autogain::SCMODE_INTERNAL);
+        ports->set_link_active(false);
+        plugin->update_settings();
+
+        for (size_t offset=0; offset < PROBE_TONE + PROBE_SILENCE; )
+        {
+            const size_t to_do  = lsp_min(PROBE_TONE + PROBE_SILENCE - offset, SOAK_BLOCK);
+            for (size_t i=0; i<ports->inputs(); ++i)
+            {
+                if (offset < PROBE_TONE)
+                    tone(ports->in(i), amp, offset, to_do);
+                else
+                    dsp::fill_zero(ports->in(i), to_do);
+            }
+            process(plugin, to_do, loads, n_loads);
+            offset             += to_do;
+
+            if (offset != PROBE_TONE)
+                continue;
+
+            // The window sums of the meters should not drift from the fresh measurement, the gain
+            // correction should bring the loudness of the output to the target level
+            const float in_l    = port_db(ports, "g_in_l");
+            const float in_s    = port_db(ports, "g_in_s");
+            const float out_l   = port_db(ports, "g_out_l");
+            const float gain    = port_db(ports, "g_g");
+            const float target  = meta::autogain::LEVEL_DFL;
+            printf("  probe %d at %.1f LUFS: input %.2f/%.2f LUFS, output %.2f LUFS, gain %.2f dB\n",
+                int(index), level, in_l, in_s, out_l, gain);
+
+            UTEST_ASSERT_MSG(fabsf(in_l - level) <= METER_TOLERANCE,
+                "Probe %d: long-period input loudness %.2f LUFS, expected %.2f LUFS", int(index), in_l, level);
+            UTEST_ASSERT_MSG(fabsf(in_s - level) <= METER_TOLERANCE,
+                "Probe %d: short-period input loudness %.2f LUFS, expected %.2f LUFS", int(index), in_s, level);
+            UTEST_ASSERT_MSG(fabsf(out_l - target) <= GAIN_TOLERANCE,
+                "Probe %d: output loudness %.2f LUFS, expected %.2f LUFS", int(index), out_l, target);
+            UTEST_ASSERT_MSG(fabsf(gain - (target - level)) <= GAIN_TOLERANCE,
+                "Probe %d: gain %.2f dB, expected %.2f dB", int(index), gain, target - level);
+        }
+
+        // The residue of the window sums should not keep the meters above the silence
+        const float in_l    = port_db(ports, "g_in_l");
+        const float in_s    = port_db(ports, "g_in_s");
+        UTEST_ASSERT_MSG(in_l <= level - SILENCE_RANGE,
+            "Probe %d: long-period input loudness %.2f LUFS after the tone", int(index), in_l);
+        UTEST_ASSERT_MSG(in_s <= level - SILENCE_RANGE,
+            "Probe %d: short-period input loudness %.2f LUFS after the tone", int(index), in_s);
+    }
+
+    void test_plugin(const meta::plugin_t *meta)
+    {
+        printf("Soaking %s for %d minutes of audio...\n", meta->uid, int(SOAK_DURATION / (SAMPLE_RATE * 60)));
+
+        plugins::TestPorts ports;
+        UTEST_ASSERT(ports.init(meta, SOAK_BLOCK));
+        size_t channels         = 0;
+        for (size_t i=0; i<ports.inputs(); ++i)
+            if (strncmp(ports.input(i)->metadata()->id, "sc", 2))
+                ++channels;
+        const float unit        = calibrate(channels);
+
+        plugins::autogain *plugin   = new plugins::autogain(meta);
+        UTEST_ASSERT(plugin != NULL);
+        plugin->init(NULL, ports.ports());
+        plugin->set_sample_rate(SAMPLE_RATE);
+        plugin->update_settings();
+
+        const size_t max_probes = (SOAK_DURATION + PROBE_PERIOD - 1) / PROBE_PERIOD;
+        const size_t max_loads  = (SOAK_DURATION + max_probes * (PROBE_TONE + PROBE_SILENCE)) / TIMING_BLOCK + 1;
+        float *loads            = new float[max_loads];
+        size_t n_loads          = 0;
+        size_t n_probes         = 0;
+        nRandom                 = 0x50a4;
+
+        for (size_t offset=0; offset < SOAK_DURATION; )
+        {
+            // Each period between probes uses the next scenario of the generator
+            const plugins::SignalGenerator::scenario_t scenario = plugins::SignalGenerator::scenario_t(
+                plugins::SignalGenerator::SG_NONE + 1 + n_probes % (plugins::SignalGenerator::SG_TOTAL - 1));
+            UTEST_ASSERT(plugin->set_generator(scenario) == STATUS_OK);
+
+            const size_t period     = lsp_min(SOAK_DURATION - offset, PROBE_PERIOD);
+            size_t automation       = 0;
+            for (size_t done=0; done < period; )
+            {
+                // Change controls at random moments, the same as the host automation does
+                if (done >= automation)
+                {
+                    automate(&ports);
+                    plugin->update_settings();
+                    automation              = done + SAMPLE_RATE / 2 + next() % (SAMPLE_RATE * 20);
+                }
+
+                const size_t to_do      = lsp_min(period - done, size_t(1 + next() % SOAK_BLOCK));
+                for (size_t i=0; i<ports.links(); ++i)
+                    for (size_t j=0; j<to_do; ++j)
+                        ports.link_data(i)[j]   = random(-0.1f, 0.1f);
+                process(plugin, to_do, loads, &n_loads);
+
+                for (size_t i=0; i<ports.outputs(); ++i)
+                {
+                    const float *out        = ports.out(i);
+                    for (size_t j=0; j<to_do; ++j)
+                        UTEST_ASSERT_MSG(isfinite(out[j]),
+                            "Non-finite output %d at %.3f s", int(i), float(offset + done + j) / SAMPLE_RATE);
+                }
+
+                done                   += to_do;
+            }
+            offset                 += period;
+
+            probe(plugin, &ports, n_probes++, unit, loads, &n_loads);
+        }
+
+        plugin->destroy();
+        delete plugin;
+
+        // Report the percentiles of the load of the block relative to the deadline
+        qsort(loads, n_loads, sizeof(float), compare_loads);
+        const float p50     = loads[n_loads / 2];
+        const float p90     = loads[(n_loads * 90) / 100];
+        const float p99     = loads[(n_loads * 99) / 100];
+        const float p999    = loads[(n_loads * 999) / 1000];
+        const float max     = loads[n_loads - 1];
+        printf("Block load of %d blocks: p50 %.4f, p90 %.4f, p99 %.4f, p99.9 %.4f, max %.4f\n",
+            int(n_loads), p50, p90, p99, p999, max);
+        UTEST_ASSERT_MSG(p99 < LOAD_P99_MAX,
+            "99th percentile of the block load %.4f exceeds %.2f", p99, LOAD_P99_MAX);
+
+        delete [] loads;
+    }
+
+    UTEST_MAIN
+    {
+        for (size_t i=plugins::SignalGenerator::SG_NONE + 1; i<plugins::SignalGenerator::SG_TOTAL; ++i)
+            test_generator(plugins::SignalGenerator::scenario_t(i));
+
+        test_load_meter();
+        test_plugin(&meta::autogain_stereo);
+        test_plugin(&meta::sc_autogain_stereo);
+    }
+
+UTEST_END